@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.enums
+
+import android.util.Log
+import io.github.thibaultbee.srtdroid.core.Srt
+import io.github.thibaultbee.srtdroid.core.models.SrtSocket
+import io.github.thibaultbee.srtdroid.core.models.Time
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertNotNull
+import org.junit.Assert.assertTrue
+import org.junit.Test
+
+/*
+ * Measures the cost of native enum conversions against a plain JNI call that converts nothing
+ * (the baseline), in the same run. Results are logged and conversions must stay within
+ * MAX_OVERHEAD_RATIO times the baseline.
+ */
+class EnumConversionBenchmarkTest {
+    private val socket = SrtSocket()
+
+    @After
+    fun tearDown() {
+        socket.close()
+        assertEquals(Srt.cleanUp(), 0)
+    }
+
+    private fun measure(name: String, block: () -> Unit): Long {
+        repeat(WARMUP_ITERATIONS) { block() }
+
+        val start = System.nanoTime()
+        repeat(ITERATIONS) { block() }
+        val nsPerOp = (System.nanoTime() - start) / ITERATIONS
+
+        Log.i(TAG, "$name: $nsPerOp ns/op")
+        return nsPerOp
+    }
+
+    private fun measureBaseline() = measure("Baseline") {
+        assertTrue(Time.now() > 0)
+    }
+
+    @Test
+    fun javaToNativeTest() {
+        val baseline = measureBaseline()
+        // RejectReasonCode.toString() converts the Java enum to its native value
+        val conversion = measure("Java to native") {
+            assertNotNull(RejectReasonCode.TIMEOUT.toString())
+        }
+        assertTrue(
+            "Java to native: $conversion ns/op, baseline: $baseline ns/op",
+            conversion <= MAX_OVERHEAD_RATIO * maxOf(baseline, 1)
+        )
+    }
+
+    @Test
+    fun nativeToJavaTest() {
+        val baseline = measureBaseline()
+        // SrtSocket.sockState converts the native value to the Java enum
+        val conversion = measure("Native to Java") {
+            assertEquals(SockStatus.INIT, socket.sockState)
+        }
+        assertTrue(
+            "Native to Java: $conversion ns/op, baseline: $baseline ns/op",
+            conversion <= MAX_OVERHEAD_RATIO * maxOf(baseline, 1)
+        )
+    }
+
+    companion object {
+        private const val TAG = "EnumConversionBenchmark"
+        private const val WARMUP_ITERATIONS = 1000
+        private const val ITERATIONS = 100000
+
+        /**
+         * Generous bound: a conversion only adds a table lookup and, from Java, an ordinal() call
+         */
+        private const val MAX_OVERHEAD_RATIO = 20
+    }
+}
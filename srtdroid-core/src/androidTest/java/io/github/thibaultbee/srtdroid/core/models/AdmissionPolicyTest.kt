@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import io.github.thibaultbee.srtdroid.core.Srt
+import io.github.thibaultbee.srtdroid.core.enums.RejectReasonCode
+import io.github.thibaultbee.srtdroid.core.enums.SockOpt
+import io.github.thibaultbee.srtdroid.core.models.rejectreason.InternalRejectReason
+import io.github.thibaultbee.srtdroid.core.models.rejectreason.PredefinedRejectReason
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Assert.fail
+import org.junit.Before
+import org.junit.Test
+import java.net.InetAddress
+import java.net.InetSocketAddress
+import java.net.SocketException
+import java.util.concurrent.atomic.AtomicInteger
+
+class AdmissionPolicyTest {
+    private lateinit var server: SrtSocket
+    private lateinit var client: SrtSocket
+    private val numOfEscalations = AtomicInteger(0)
+
+    @Before
+    fun setUp() {
+        server = SrtSocket()
+        server.serverListener = object : SrtSocket.ServerListener {
+            override fun onListen(
+                ns: SrtSocket,
+                hsVersion: Int,
+                peerAddress: InetSocketAddress,
+                streamId: String
+            ): Int {
+                numOfEscalations.incrementAndGet()
+                return 0
+            }
+        }
+        server.bind(InetAddress.getLoopbackAddress(), 0)
+        server.listen(2)
+        client = SrtSocket()
+    }
+
+    @After
+    fun tearDown() {
+        client.close()
+        server.close()
+        assertEquals(Srt.cleanUp(), 0)
+    }
+
+    @Test
+    fun denyResourceTest() {
+        server.admissionPolicy = AdmissionPolicy(
+            rules = listOf(
+                AdmissionPolicy.Rule(
+                    AdmissionPolicy.Action.DENY,
+                    "private/*",
+                    key = "r",
+                    rejectReason = PredefinedRejectReason(401)
+                )
+            )
+        )
+        client.setSockFlag(SockOpt.STREAMID, "#!::r=private/cam,m=request")
+        try {
+            client.connect(InetAddress.getLoopbackAddress(), server.localPort)
+            fail()
+        } catch (_: SocketException) {
+        }
+        assertEquals(PredefinedRejectReason(401), client.rejectReason)
+        assertEquals(0, numOfEscalations.get())
+    }
+
+    @Test
+    fun allowResourceTest() {
+        server.admissionPolicy = AdmissionPolicy(
+            rules = listOf(AdmissionPolicy.Rule(AdmissionPolicy.Action.ALLOW, "live/*", key = "r")),
+            defaultAction = AdmissionPolicy.Action.DENY
+        )
+        client.setSockFlag(SockOpt.STREAMID, "#!::r=live/cam,m=publish")
+        client.connect(InetAddress.getLoopbackAddress(), server.localPort)
+        assertEquals(1, numOfEscalations.get())
+    }
+
+    @Test
+    fun globalRateLimitTest() {
+        server.admissionPolicy = AdmissionPolicy(
+            globalRateLimit = AdmissionPolicy.RateLimit(0.001, 1)
+        )
+        client.connect(InetAddress.getLoopbackAddress(), server.localPort)
+
+        val secondClient = SrtSocket()
+        try {
+            secondClient.connect(InetAddress.getLoopbackAddress(), server.localPort)
+            fail()
+        } catch (_: SocketException) {
+        } finally {
+            assertEquals(PredefinedRejectReason(402), secondClient.rejectReason)
+            secondClient.close()
+        }
+        assertTrue(numOfEscalations.get() == 1)
+    }
+
+    @Test
+    fun internalRejectReasonTest() {
+        try {
+            AdmissionPolicy(
+                defaultAction = AdmissionPolicy.Action.DENY,
+                rejectReason = InternalRejectReason(RejectReasonCode.UNKNOWN)
+            )
+            fail()
+        } catch (_: IllegalArgumentException) {
+        }
+    }
+}
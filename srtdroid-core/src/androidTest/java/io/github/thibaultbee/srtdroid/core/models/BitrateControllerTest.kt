@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import io.github.thibaultbee.srtdroid.core.Srt
+import org.junit.After
+import org.junit.Assert.assertArrayEquals
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertTrue
+import org.junit.Test
+
+class BitrateControllerTest {
+    private val config = BitrateController.Config(
+        minBitrate = 500_000,
+        maxBitrate = 2_100_000,
+        initialBitrate = 2_000_000,
+        additiveIncrease = 50_000,
+        decreaseFactor = 0.5
+    )
+
+    @After
+    fun tearDown() {
+        assertEquals(Srt.cleanUp(), 0)
+    }
+
+    /**
+     * Builds a trace of samples in the [StatsSampler] layout.
+     */
+    private fun trace(vararg samples: Map<Int, Any>): LongArray {
+        val values = LongArray(samples.size * StatsSampler.SAMPLE_SIZE)
+        samples.forEachIndexed { i, sample ->
+            val offset = i * StatsSampler.SAMPLE_SIZE
+            values[offset + StatsSampler.INTERVAL_MS] = 50
+            values[offset + StatsBuffer.MS_RTT] = 20.0.toRawBits()
+            values[offset + StatsBuffer.BYTE_AVAIL_SND_BUF] = 1_000_000
+            sample.forEach { (field, value) ->
+                values[offset + field] = when (value) {
+                    is Double -> value.toRawBits()
+                    else -> (value as Number).toLong()
+                }
+            }
+        }
+        return values
+    }
+
+    @Test
+    fun aimdTest() {
+        val samples = trace(
+            mapOf(StatsSampler.INTERVAL_MS to 0),
+            mapOf(),
+            mapOf(),
+            mapOf(StatsSampler.SND_LOSS_PERCENT to 10.0),
+            mapOf(StatsBuffer.MS_SND_BUF to 1000),
+            mapOf(StatsBuffer.MS_RTT to 40.0),
+            mapOf(StatsBuffer.BYTE_AVAIL_SND_BUF to 0),
+            mapOf()
+        )
+        assertArrayEquals(
+            longArrayOf(
+                2_000_000, // First sample has no interval values
+                2_050_000,
+                2_100_000,
+                1_050_000, // Loss
+                525_000, // Send buffer
+                500_000, // RTT increase, bounded by minBitrate
+                500_000, // Send buffer full
+                550_000
+            ),
+            BitrateController.simulate(config, samples)
+        )
+    }
+
+    @Test
+    fun bandwidthTest() {
+        val samples = trace(
+            mapOf(StatsBuffer.MBPS_BANDWIDTH to 1.0),
+            mapOf(StatsBuffer.MBPS_BANDWIDTH to 10.0)
+        )
+        assertArrayEquals(
+            longArrayOf(800_000, 850_000),
+            BitrateController.simulate(
+                config.copy(mode = BitrateController.Mode.BANDWIDTH),
+                samples
+            )
+        )
+    }
+
+    @Test
+    fun createTest() {
+        val socket = SrtSocket()
+        val controller = BitrateController(socket, config, intervalInMs = 10) { }
+        assertTrue(controller.isValid)
+        Thread.sleep(100)
+        controller.close()
+        assertFalse(controller.isValid)
+        socket.close()
+    }
+}
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import io.github.thibaultbee.srtdroid.core.Srt
+import io.github.thibaultbee.srtdroid.core.enums.SockOpt
+import io.github.thibaultbee.srtdroid.core.enums.Transtype
+import io.github.thibaultbee.srtdroid.core.utils.Utils
+import org.junit.After
+import org.junit.Assert.assertArrayEquals
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertNotEquals
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import java.io.ByteArrayOutputStream
+import java.net.DatagramPacket
+import java.net.DatagramSocket
+import java.net.InetAddress
+import java.net.InetSocketAddress
+import java.util.concurrent.TimeUnit
+
+class BridgeTest {
+    private val source = SrtSocketRecvTest.ServerSend()
+    private val sink = SrtSocketSendTest.ServerRecv()
+    private val socket = SrtSocket().apply {
+        setSockFlag(SockOpt.TRANSTYPE, Transtype.FILE)
+    }
+    private val udp = DatagramSocket(0, InetAddress.getLoopbackAddress()).apply {
+        soTimeout = 1000
+    }
+
+    @After
+    fun tearDown() {
+        source.shutdown()
+        sink.shutdown()
+        socket.close()
+        udp.close()
+        Srt.cleanUp()
+    }
+
+    @Test
+    fun srtToUdpTest() {
+        val arraySize = 5000
+        val expectedArray = Utils.generateRandomArray(arraySize)
+        Bridge(
+            socket,
+            Bridge.Direction.SRT_TO_UDP,
+            InetSocketAddress(InetAddress.getLoopbackAddress(), udp.localPort)
+        ).use { bridge ->
+            assertTrue(bridge.isValid)
+
+            source.enqueue(expectedArray)
+            socket.connect(InetAddress.getLoopbackAddress(), source.port)
+
+            val received = ByteArrayOutputStream()
+            val packet = DatagramPacket(ByteArray(2048), 2048)
+            while (received.size() < arraySize) {
+                udp.receive(packet)
+                assertTrue(packet.length <= bridge.chunkSize)
+                received.write(packet.data, 0, packet.length)
+            }
+            assertArrayEquals(expectedArray, received.toByteArray())
+
+            val counters = bridge.counters()
+            assertEquals(arraySize.toLong(), counters.receivedBytes)
+            assertEquals(arraySize.toLong(), counters.sentBytes)
+        }
+    }
+
+    @Test
+    fun udpToSrtTest() {
+        val arraySize = 2000
+        val expectedArray = Utils.generateRandomArray(arraySize)
+        val futureResult = sink.enqueue(arraySize)
+        socket.connect(InetAddress.getLoopbackAddress(), sink.port)
+
+        Bridge(
+            socket,
+            Bridge.Direction.UDP_TO_SRT,
+            InetSocketAddress(InetAddress.getLoopbackAddress(), 0)
+        ).use { bridge ->
+            assertNotEquals(0, bridge.localPort)
+
+            udp.send(
+                DatagramPacket(
+                    expectedArray,
+                    arraySize,
+                    InetAddress.getLoopbackAddress(),
+                    bridge.localPort
+                )
+            )
+
+            assertArrayEquals(expectedArray, futureResult.get(1000, TimeUnit.MILLISECONDS))
+            assertEquals(1L, bridge.counters().receivedPackets)
+        }
+    }
+
+    @Test
+    fun srtToUdpPaceTest() {
+        val messageCount = 4
+        val spacingInUs = 100_000L
+        // Live mode without TSBPD: messages are received in a burst
+        val listener = SrtSocket().apply { setSockFlag(SockOpt.TSBPDMODE, false) }
+        val bridgeSocket = SrtSocket().apply { setSockFlag(SockOpt.TSBPDMODE, false) }
+        try {
+            listener.bind(InetAddress.getLoopbackAddress(), 0)
+            listener.listen(1)
+            bridgeSocket.connect(InetAddress.getLoopbackAddress(), listener.localPort)
+            val sender = listener.accept().first
+
+            Bridge(
+                bridgeSocket,
+                Bridge.Direction.SRT_TO_UDP,
+                InetSocketAddress(InetAddress.getLoopbackAddress(), udp.localPort),
+                pace = true
+            ).use { bridge ->
+                assertTrue(bridge.isValid)
+
+                // Source times must be in the past
+                Thread.sleep(messageCount * spacingInUs / 1000)
+                val firstSrcTime = Time.now() - messageCount * spacingInUs
+                val array = Utils.generateRandomArray(100)
+                for (i in 0 until messageCount) {
+                    sender.send(array, MsgCtrl(srcTime = firstSrcTime + i * spacingInUs))
+                }
+
+                val packet = DatagramPacket(ByteArray(2048), 2048)
+                val arrivalTimes = LongArray(messageCount)
+                for (i in 0 until messageCount) {
+                    udp.receive(packet)
+                    arrivalTimes[i] = System.nanoTime()
+                }
+                for (i in 1 until messageCount) {
+                    val gapInUs = (arrivalTimes[i] - arrivalTimes[i - 1]) / 1000
+                    assertTrue("Gap is $gapInUs us", gapInUs >= spacingInUs * 8 / 10)
+                }
+            }
+            sender.close()
+        } finally {
+            bridgeSocket.close()
+            listener.close()
+        }
+    }
+
+    @Test
+    fun closeTest() {
+        val bridge = Bridge(
+            socket,
+            Bridge.Direction.SRT_TO_UDP,
+            InetSocketAddress(InetAddress.getLoopbackAddress(), udp.localPort)
+        )
+        assertTrue(bridge.isValid)
+        bridge.close()
+        assertFalse(bridge.isValid)
+        assertEquals(0L, bridge.counters().receivedPackets)
+    }
+
+    @Test
+    fun concurrentCloseTest() {
+        // Concurrent closes release the native bridge once, concurrent calls never use it freed
+        val bridge = Bridge(
+            socket,
+            Bridge.Direction.SRT_TO_UDP,
+            InetSocketAddress(InetAddress.getLoopbackAddress(), udp.localPort)
+        )
+        val threads = (0 until 4).map {
+            Thread {
+                repeat(100) {
+                    try {
+                        bridge.localPort
+                    } catch (_: IllegalStateException) {
+                    }
+                    bridge.counters()
+                }
+                bridge.close()
+            }
+        }
+        threads.forEach { it.start() }
+        threads.forEach { it.join() }
+        assertFalse(bridge.isValid)
+        assertEquals(0L, bridge.counters().receivedPackets)
+    }
+}
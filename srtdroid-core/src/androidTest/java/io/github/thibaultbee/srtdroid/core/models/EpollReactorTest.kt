@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import io.github.thibaultbee.srtdroid.core.Srt
+import io.github.thibaultbee.srtdroid.core.enums.EpollOpt
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertTrue
+import org.junit.Assert.fail
+import org.junit.Before
+import org.junit.Test
+import java.net.InetAddress
+import java.util.concurrent.CountDownLatch
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.AtomicInteger
+
+class EpollReactorTest {
+    private lateinit var reactor: EpollReactor
+    private lateinit var server: SrtSocket
+    private lateinit var client: SrtSocket
+
+    @Before
+    fun setUp() {
+        reactor = EpollReactor()
+        assertTrue(reactor.isValid)
+        server = SrtSocket()
+        client = SrtSocket()
+    }
+
+    @After
+    fun tearDown() {
+        reactor.close()
+        assertFalse(reactor.isValid)
+        server.close()
+        client.close()
+        assertEquals(Srt.cleanUp(), 0)
+    }
+
+    @Test
+    fun addUpdateRemoveTest() {
+        reactor.add(server, listOf(EpollOpt.ERR)) { _, _ -> }
+        reactor.update(server, listOf(EpollOpt.ERR, EpollOpt.ET))
+        reactor.remove(server)
+    }
+
+    @Test
+    fun incomingConnectionTest() {
+        val latch = CountDownLatch(1)
+        val events = AtomicInteger()
+
+        server.bind(InetAddress.getLoopbackAddress(), 0)
+        server.listen(1)
+        reactor.add(server, listOf(EpollOpt.IN, EpollOpt.ET)) { socket, ev ->
+            assertEquals(server, socket)
+            events.set(ev)
+            latch.countDown()
+        }
+
+        client.connect(InetAddress.getLoopbackAddress(), server.localPort)
+        assertTrue(latch.await(5, TimeUnit.SECONDS))
+        assertTrue((events.get() and EpollOpt.IN.value) != 0)
+    }
+
+    @Test
+    fun closeFromListenerTest() {
+        val latch = CountDownLatch(1)
+
+        server.bind(InetAddress.getLoopbackAddress(), 0)
+        server.listen(1)
+        reactor.add(server, listOf(EpollOpt.IN)) { _, _ ->
+            reactor.close()
+            latch.countDown()
+        }
+
+        client.connect(InetAddress.getLoopbackAddress(), server.localPort)
+        assertTrue(latch.await(5, TimeUnit.SECONDS))
+        assertFalse(reactor.isValid)
+    }
+
+    @Test
+    fun addAfterCloseTest() {
+        reactor.close()
+        try {
+            reactor.add(server, listOf(EpollOpt.IN)) { _, _ -> }
+            fail()
+        } catch (_: IllegalStateException) {
+        }
+        try {
+            reactor.remove(server)
+            fail()
+        } catch (_: IllegalStateException) {
+        }
+    }
+
+    @Test
+    fun concurrentCloseTest() {
+        // Concurrent closes release the native reactor once, concurrent calls never use it freed
+        val threads = (0 until 4).map {
+            Thread {
+                repeat(100) {
+                    try {
+                        reactor.update(server, listOf(EpollOpt.IN))
+                    } catch (_: IllegalStateException) {
+                    } catch (_: Exception) {
+                        // Not added
+                    }
+                }
+                reactor.close()
+            }
+        }
+        threads.forEach { it.start() }
+        threads.forEach { it.join() }
+        assertFalse(reactor.isValid)
+    }
+}
@@ -22,10 +22,14 @@ import io.github.thibaultbee.srtdroid.core.enums.ErrorType
 import org.junit.After
 import org.junit.Assert.assertEquals
 import org.junit.Assert.assertFalse
+import org.junit.Assert.assertSame
 import org.junit.Assert.assertTrue
 import org.junit.Assert.fail
 import org.junit.Before
 import org.junit.Test
+import java.net.InetAddress
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
 
 class EpollTest {
     private lateinit var epoll: Epoll
@@ -130,6 +134,36 @@ class EpollTest {
         }
     }
 
+    @Test
+    fun uWaitInArrayTest() {
+        val events = IntArray(8)
+        epoll.flags = listOf(EpollFlag.ENABLE_EMPTY)
+        assertEquals(0, epoll.uWait(100L, events))
+
+        val buffer = ByteBuffer.allocateDirect(8 * Int.SIZE_BYTES).order(ByteOrder.nativeOrder())
+            .asIntBuffer()
+        assertEquals(0, epoll.uWait(100L, buffer))
+        assertEquals(0, buffer.position())
+    }
+
+    @Test
+    fun uWaitReturnsSameSocketTest() {
+        socket = SrtSocket()
+        socket.bind(InetAddress.getLoopbackAddress(), 0)
+        socket.listen(1)
+        epoll.addUSock(socket, listOf(EpollOpt.IN))
+
+        val client = SrtSocket()
+        try {
+            client.connect(InetAddress.getLoopbackAddress(), socket.localPort)
+            val epollEvents = epoll.uWait(1000L)
+            assertEquals(1, epollEvents.size)
+            assertSame(socket, epollEvents[0].socket)
+        } finally {
+            client.close()
+        }
+    }
+
     @Test
     fun setTest() {
         epoll.flags = listOf()
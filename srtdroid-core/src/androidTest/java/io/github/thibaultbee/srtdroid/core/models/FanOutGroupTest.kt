@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import io.github.thibaultbee.srtdroid.core.Srt
+import io.github.thibaultbee.srtdroid.core.enums.ErrorType
+import io.github.thibaultbee.srtdroid.core.enums.SockOpt
+import io.github.thibaultbee.srtdroid.core.enums.Transtype
+import io.github.thibaultbee.srtdroid.core.utils.Utils
+import org.junit.After
+import org.junit.Assert.assertArrayEquals
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertNotNull
+import org.junit.Assert.assertNull
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import java.net.InetAddress
+import java.util.concurrent.TimeUnit
+
+class FanOutGroupTest {
+    private val servers = List(2) { SrtSocketSendTest.ServerRecv() }
+    private val sockets = List(2) {
+        SrtSocket().apply {
+            setSockFlag(SockOpt.TRANSTYPE, Transtype.FILE)
+        }
+    }
+
+    @After
+    fun tearDown() {
+        servers.forEach { it.shutdown() }
+        sockets.forEach { it.close() }
+        Srt.cleanUp()
+    }
+
+    @Test
+    fun sendTest() {
+        val arraySize = 1000
+        val futureResults = servers.map { it.enqueue(arraySize) }
+        sockets.forEachIndexed { i, socket ->
+            socket.connect(InetAddress.getLoopbackAddress(), servers[i].port)
+        }
+
+        FanOutGroup().use { group ->
+            sockets.forEach { assertTrue(group.add(it)) }
+            assertFalse(group.add(sockets[0]))
+            assertEquals(2, group.sockets.size)
+
+            val expectedArray = Utils.generateRandomArray(arraySize)
+            assertEquals(2, group.send(expectedArray))
+
+            futureResults.forEach {
+                assertArrayEquals(expectedArray, it.get(1000, TimeUnit.MILLISECONDS))
+            }
+            sockets.forEach {
+                val counters = group.counters(it)
+                assertNotNull(counters)
+                assertEquals(arraySize.toLong(), counters!!.sentBytes)
+                assertEquals(0L, counters.droppedPackets)
+            }
+
+            assertTrue(group.remove(sockets[1]))
+            assertFalse(group.remove(sockets[1]))
+            assertNull(group.counters(sockets[1]))
+        }
+    }
+
+    @Test
+    fun evictionTest() {
+        sockets.forEachIndexed { i, socket ->
+            servers[i].enqueue(1)
+            socket.connect(InetAddress.getLoopbackAddress(), servers[i].port)
+        }
+
+        val evicted = mutableListOf<Pair<SrtSocket, ErrorType>>()
+        FanOutGroup { socket, error -> evicted.add(Pair(socket, error)) }.use { group ->
+            sockets.forEach { assertTrue(group.add(it)) }
+            sockets[0].close()
+
+            assertEquals(1, group.send(Utils.generateRandomArray(1)))
+            assertEquals(1, evicted.size)
+            assertEquals(sockets[0], evicted[0].first)
+            assertEquals(listOf(sockets[1]), group.sockets)
+        }
+    }
+
+    @Test
+    fun closeFromListenerTest() {
+        sockets.forEachIndexed { i, socket ->
+            servers[i].enqueue(1)
+            socket.connect(InetAddress.getLoopbackAddress(), servers[i].port)
+        }
+
+        // The native group is released once the send that reported the eviction has returned
+        lateinit var group: FanOutGroup
+        group = FanOutGroup { _, _ -> group.close() }
+        sockets.forEach { assertTrue(group.add(it)) }
+        sockets[0].close()
+
+        assertEquals(1, group.send(Utils.generateRandomArray(1)))
+        assertFalse(group.isValid)
+        assertNull(group.counters(sockets[1]))
+        group.close()
+    }
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import io.github.thibaultbee.srtdroid.core.Srt
+import io.github.thibaultbee.srtdroid.core.enums.SockOpt
+import io.github.thibaultbee.srtdroid.core.enums.Transtype
+import io.github.thibaultbee.srtdroid.core.utils.Utils
+import org.junit.After
+import org.junit.Assert.assertArrayEquals
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertTrue
+import org.junit.Assert.fail
+import org.junit.Before
+import org.junit.Test
+import java.net.InetAddress
+import java.net.SocketException
+import java.net.SocketTimeoutException
+import java.nio.ByteBuffer
+import java.util.concurrent.CountDownLatch
+import java.util.concurrent.TimeUnit
+
+class RecvRingTest {
+    private lateinit var socket: SrtSocket
+    private val server = SrtSocketRecvTest.ServerSend()
+
+    @Before
+    fun setUp() {
+        socket = SrtSocket()
+        assertTrue(socket.isValid)
+        socket.setSockFlag(SockOpt.TRANSTYPE, Transtype.FILE)
+    }
+
+    @After
+    fun tearDown() {
+        server.shutdown()
+        socket.close()
+        Srt.cleanUp()
+    }
+
+    @Test
+    fun takeTest() {
+        val arraySize = 10000
+        val expectedArray = Utils.generateRandomArray(arraySize)
+        val futureResult = server.enqueue(expectedArray)
+        socket.connect(InetAddress.getLoopbackAddress(), server.port)
+
+        RecvRing(socket, capacity = 4).use { ring ->
+            val buffer = ByteBuffer.allocate(arraySize)
+            while (buffer.hasRemaining()) {
+                assertTrue(ring.take(buffer, timeoutInMs = 1000) > 0)
+            }
+            assertEquals(arraySize, futureResult.get(1000, TimeUnit.MILLISECONDS))
+            assertArrayEquals(expectedArray, buffer.array())
+
+            val counters = ring.counters()
+            assertEquals(arraySize.toLong(), counters.receivedBytes)
+            assertTrue(counters.receivedPackets > 0)
+
+            // Server has closed the connection
+            try {
+                ring.take(ByteBuffer.allocate(ring.maxPayloadSize), timeoutInMs = 5000)
+                fail()
+            } catch (_: SocketException) {
+            }
+        }
+    }
+
+    @Test
+    fun pollBatchTest() {
+        val arraySize = 1000
+        val expectedArray = Utils.generateRandomArray(arraySize)
+        val availableLatch = CountDownLatch(1)
+        RecvRing(socket, listener = { availableLatch.countDown() }).use { ring ->
+            val buffer = ByteBuffer.allocate(arraySize)
+            val batch = MsgBatch(16)
+            // An empty poll asks for a listener call
+            assertEquals(0, ring.poll(buffer, batch))
+
+            val futureResult = server.enqueue(expectedArray)
+            socket.connect(InetAddress.getLoopbackAddress(), server.port)
+            assertTrue(availableLatch.await(1000, TimeUnit.MILLISECONDS))
+
+            while (buffer.hasRemaining()) {
+                val offset = buffer.position()
+                if (ring.poll(buffer, batch) == 0) {
+                    Thread.sleep(10)
+                    continue
+                }
+                assertEquals(offset, batch.offsets[0])
+                assertEquals(buffer.position() - offset, batch.bytes().toInt())
+            }
+            assertEquals(arraySize, futureResult.get(1000, TimeUnit.MILLISECONDS))
+            assertArrayEquals(expectedArray, buffer.array())
+        }
+    }
+
+    @Test
+    fun timeoutTest() {
+        RecvRing(socket).use { ring ->
+            assertEquals(0, ring.poll(ByteBuffer.allocate(ring.maxPayloadSize)))
+            try {
+                ring.take(ByteBuffer.allocate(ring.maxPayloadSize), timeoutInMs = 100)
+                fail()
+            } catch (_: SocketTimeoutException) {
+            }
+        }
+    }
+
+    @Test
+    fun closeTest() {
+        val ring = RecvRing(socket)
+        assertTrue(ring.isValid)
+        ring.close()
+        assertFalse(ring.isValid)
+        try {
+            ring.poll(ByteBuffer.allocate(10))
+            fail()
+        } catch (_: IllegalStateException) {
+        }
+    }
+
+    @Test
+    fun concurrentCloseTest() {
+        // Concurrent closes release the native ring once, concurrent counters never use it freed
+        val ring = RecvRing(socket)
+        val threads = (0 until 4).map {
+            Thread {
+                repeat(100) {
+                    ring.counters()
+                }
+                ring.close()
+            }
+        }
+        threads.forEach { it.start() }
+        threads.forEach { it.join() }
+        assertFalse(ring.isValid)
+        assertEquals(0L, ring.counters().receivedPackets)
+    }
+}
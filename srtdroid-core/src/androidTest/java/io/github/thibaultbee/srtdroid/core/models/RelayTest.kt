@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import io.github.thibaultbee.srtdroid.core.Srt
+import io.github.thibaultbee.srtdroid.core.enums.ErrorType
+import io.github.thibaultbee.srtdroid.core.enums.SockOpt
+import io.github.thibaultbee.srtdroid.core.enums.Transtype
+import io.github.thibaultbee.srtdroid.core.utils.Utils
+import org.junit.After
+import org.junit.Assert.assertArrayEquals
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertNotNull
+import org.junit.Assert.assertNull
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import java.net.InetAddress
+import java.util.concurrent.CountDownLatch
+import java.util.concurrent.TimeUnit
+
+class RelayTest {
+    private val source = SrtSocketRecvTest.ServerSend()
+    private val sink = SrtSocketSendTest.ServerRecv()
+    private val input = SrtSocket().apply {
+        setSockFlag(SockOpt.TRANSTYPE, Transtype.FILE)
+    }
+    private val output = SrtSocket().apply {
+        setSockFlag(SockOpt.TRANSTYPE, Transtype.FILE)
+    }
+
+    @After
+    fun tearDown() {
+        source.shutdown()
+        sink.shutdown()
+        input.close()
+        output.close()
+        Srt.cleanUp()
+    }
+
+    @Test
+    fun forwardTest() {
+        val arraySize = 10000
+        val expectedArray = Utils.generateRandomArray(arraySize)
+        val futureResult = sink.enqueue(arraySize)
+        output.connect(InetAddress.getLoopbackAddress(), sink.port)
+
+        val inputClosedLatch = CountDownLatch(1)
+        val listener = object : Relay.Listener {
+            override fun onInputClosed(error: ErrorType) {
+                inputClosedLatch.countDown()
+            }
+        }
+        Relay(input, listOf(output), listener = listener).use { relay ->
+            assertTrue(relay.isValid)
+            assertEquals(listOf(output), relay.sockets)
+            assertFalse(relay.addOutput(output))
+
+            source.enqueue(expectedArray)
+            input.connect(InetAddress.getLoopbackAddress(), source.port)
+
+            assertArrayEquals(expectedArray, futureResult.get(1000, TimeUnit.MILLISECONDS))
+
+            // Source closes its connection once sent
+            assertTrue(inputClosedLatch.await(5000, TimeUnit.MILLISECONDS))
+            val counters = relay.counters()
+            assertEquals(arraySize.toLong(), counters.receivedBytes)
+            assertEquals(counters.receivedPackets, counters.sentPackets)
+            assertEquals(0L, counters.droppedPackets)
+            assertTrue(counters.maxLatencyInUs >= counters.meanLatencyInUs)
+
+            val outputCounters = relay.counters(output)
+            assertNotNull(outputCounters)
+            assertEquals(arraySize.toLong(), outputCounters!!.sentBytes)
+        }
+    }
+
+    @Test
+    fun closeTest() {
+        val relay = Relay(input)
+        assertTrue(relay.isValid)
+        relay.close()
+        assertFalse(relay.isValid)
+        assertEquals(0L, relay.counters().receivedPackets)
+    }
+
+    @Test
+    fun concurrentCloseTest() {
+        // Concurrent closes release the native relay once, concurrent calls never use it freed
+        val relay = Relay(input)
+        val threads = (0 until 4).map {
+            Thread {
+                repeat(100) {
+                    try {
+                        relay.addOutput(output)
+                        relay.removeOutput(output)
+                    } catch (_: IllegalStateException) {
+                    }
+                    relay.counters()
+                }
+                relay.close()
+            }
+        }
+        threads.forEach { it.start() }
+        threads.forEach { it.join() }
+        assertFalse(relay.isValid)
+        assertNull(relay.counters(output))
+    }
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import io.github.thibaultbee.srtdroid.core.Srt
+import io.github.thibaultbee.srtdroid.core.enums.SockOpt
+import io.github.thibaultbee.srtdroid.core.enums.Transtype
+import io.github.thibaultbee.srtdroid.core.utils.Utils
+import org.junit.After
+import org.junit.Assert.assertArrayEquals
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertTrue
+import org.junit.Assert.fail
+import org.junit.Before
+import org.junit.Test
+import java.net.InetAddress
+import java.nio.ByteBuffer
+import java.util.concurrent.TimeUnit
+
+class SendRingTest {
+    private lateinit var socket: SrtSocket
+    private val server = SrtSocketSendTest.ServerRecv()
+
+    @Before
+    fun setUp() {
+        socket = SrtSocket()
+        assertTrue(socket.isValid)
+        socket.setSockFlag(SockOpt.TRANSTYPE, Transtype.FILE)
+    }
+
+    @After
+    fun tearDown() {
+        server.shutdown()
+        socket.close()
+        Srt.cleanUp()
+    }
+
+    @Test
+    fun sendTest() {
+        val msgSize = 100
+        val numOfMsgs = 20
+        val futureResult = server.enqueue(msgSize * numOfMsgs)
+        socket.connect(InetAddress.getLoopbackAddress(), server.port)
+
+        val expectedArray = Utils.generateRandomArray(msgSize * numOfMsgs)
+        SendRing(socket, capacity = 8, maxPayloadSize = msgSize).use { ring ->
+            assertTrue(ring.isValid)
+            for (i in 0 until numOfMsgs) {
+                val msg = ByteBuffer.wrap(expectedArray, i * msgSize, msgSize)
+                while (!ring.offer(msg)) {
+                    Thread.sleep(1)
+                }
+                assertFalse(msg.hasRemaining())
+            }
+
+            val actualArray = futureResult.get(1000, TimeUnit.MILLISECONDS)
+            assertArrayEquals(expectedArray, actualArray)
+
+            val counters = ring.counters()
+            assertEquals(numOfMsgs.toLong(), counters.sentPackets)
+            assertEquals((msgSize * numOfMsgs).toLong(), counters.sentBytes)
+            assertEquals(0L, counters.sendFailures)
+            assertTrue(counters.maxDrainLatencyInUs >= counters.meanDrainLatencyInUs)
+            assertEquals(0, ring.size)
+        }
+    }
+
+    @Test
+    fun sendFailureTest() {
+        // Not connected: each message fails without stopping the drain thread
+        val numOfMsgs = 5
+        SendRing(socket, capacity = 8, maxPayloadSize = 10).use { ring ->
+            for (i in 0 until numOfMsgs) {
+                assertTrue(ring.offer(ByteArray(10)))
+            }
+            var counters = ring.counters()
+            for (i in 0 until 100) {
+                if (counters.sendFailures == numOfMsgs.toLong()) {
+                    break
+                }
+                Thread.sleep(10)
+                counters = ring.counters()
+            }
+            assertEquals(numOfMsgs.toLong(), counters.sendFailures)
+            assertEquals(0L, counters.sentPackets)
+            assertEquals(0L, ring.droppedPackets)
+        }
+    }
+
+    @Test
+    fun closeTest() {
+        val ring = SendRing(socket)
+        assertTrue(ring.isValid)
+        ring.close()
+        assertFalse(ring.isValid)
+        try {
+            ring.offer(ByteArray(10))
+            fail()
+        } catch (_: IllegalStateException) {
+        }
+    }
+
+    @Test
+    fun concurrentCloseTest() {
+        // Concurrent closes release the native ring once, concurrent counters never use it freed
+        val ring = SendRing(socket)
+        val threads = (0 until 4).map {
+            Thread {
+                repeat(100) {
+                    ring.counters()
+                }
+                ring.close()
+            }
+        }
+        threads.forEach { it.start() }
+        threads.forEach { it.join() }
+        assertFalse(ring.isValid)
+        assertEquals(0L, ring.counters().sentPackets)
+    }
+
+    @Test
+    fun invalidCapacityTest() {
+        try {
+            SendRing(socket, capacity = 3)
+            fail()
+        } catch (_: IllegalArgumentException) {
+        }
+    }
+}
@@ -1,6 +1,7 @@
 package io.github.thibaultbee.srtdroid.core.models
 
 import io.github.thibaultbee.srtdroid.core.Srt
+import io.github.thibaultbee.srtdroid.core.enums.Boundary
 import io.github.thibaultbee.srtdroid.core.enums.SockOpt
 import io.github.thibaultbee.srtdroid.core.enums.Transtype
 import io.github.thibaultbee.srtdroid.core.utils.Utils
@@ -10,6 +11,7 @@ import org.junit.Before
 import org.junit.Test
 import java.lang.Thread.sleep
 import java.net.InetAddress
+import java.nio.ByteBuffer
 import java.util.concurrent.Callable
 import java.util.concurrent.Executors
 import java.util.concurrent.Future
@@ -65,6 +67,31 @@ class SrtSocketRecvTest {
         Assert.assertArrayEquals(expectedArray, actualArray)
     }
 
+    @Test
+    fun recvBatchTest() {
+        val arraySize = 1000
+        val expectedArray = Utils.generateRandomArray(arraySize)
+        val futureResult = server.enqueue(expectedArray)
+        socket.connect(InetAddress.getLoopbackAddress(), server.port)
+
+        val buffer = ByteBuffer.allocateDirect(arraySize)
+        val batch = MsgBatch(16)
+        while (buffer.hasRemaining()) {
+            val offset = buffer.position()
+            val numOfMsgs = socket.recvBatch(buffer, batch)
+            Assert.assertEquals(numOfMsgs, batch.size)
+            Assert.assertEquals(buffer.position() - offset, batch.bytes().toInt())
+            if (numOfMsgs > 0) {
+                Assert.assertEquals(offset, batch.offsets[0])
+            }
+        }
+
+        val numOfSentBytes = futureResult.get(1000, TimeUnit.MILLISECONDS)
+        Assert.assertEquals(arraySize, numOfSentBytes)
+        buffer.rewind()
+        Utils.assertByteBufferEquals(ByteBuffer.wrap(expectedArray), buffer)
+    }
+
     @Test
     fun recv2Simple() {
         val arraySize = 1000
@@ -128,6 +155,79 @@ class SrtSocketRecvTest {
         Assert.assertArrayEquals(expectedArray, actualArray.copyOfRange(offset, offset + length))
     }
 
+    @Test
+    fun recvInDirectBuffer() {
+        val arraySize = 1000
+        val expectedArray = Utils.generateRandomArray(arraySize)
+        val futureResult = server.enqueue(expectedArray)
+        socket.connect(InetAddress.getLoopbackAddress(), server.port)
+
+        val actualBuffer = ByteBuffer.allocateDirect(arraySize)
+        val numOfReceivedBytes = socket.recv(actualBuffer)
+
+        val numOfSentBytes = futureResult.get(1000, TimeUnit.MILLISECONDS)
+        Assert.assertEquals(arraySize, numOfSentBytes)
+        Assert.assertEquals(arraySize, numOfReceivedBytes)
+        Assert.assertEquals(arraySize, actualBuffer.position())
+        actualBuffer.flip()
+        val actualArray = ByteArray(actualBuffer.remaining())
+        actualBuffer.get(actualArray)
+        Assert.assertArrayEquals(expectedArray, actualArray)
+    }
+
+    @Test
+    fun recv2InDirectBuffer() {
+        val arraySize = 1000
+        val expectedArray = Utils.generateRandomArray(arraySize)
+        val futureResult = server.enqueue(expectedArray)
+        socket.connect(InetAddress.getLoopbackAddress(), server.port)
+
+        val actualBuffer = ByteBuffer.allocateDirect(arraySize)
+        socket.recv(actualBuffer, MsgCtrl(ttl = 100))
+
+        val numOfSentBytes = futureResult.get(1000, TimeUnit.MILLISECONDS)
+        Assert.assertEquals(arraySize, numOfSentBytes)
+        actualBuffer.flip()
+        val actualArray = ByteArray(actualBuffer.remaining())
+        actualBuffer.get(actualArray)
+        Assert.assertArrayEquals(expectedArray, actualArray)
+    }
+
+    @Test
+    fun recvMsgCtrlWriteBackTest() {
+        // Live mode: each message is a single packet with a source time
+        val listener = SrtSocket()
+        val sender = SrtSocket()
+        try {
+            listener.bind(InetAddress.getLoopbackAddress(), 0)
+            listener.listen(1)
+            sender.connect(InetAddress.getLoopbackAddress(), listener.localPort)
+            val receiver = listener.accept().first
+
+            val expectedArray = Utils.generateRandomArray(100)
+            val sendMsgCtrl = MsgCtrl()
+            sender.send(expectedArray, sendMsgCtrl)
+            sender.send(expectedArray, sendMsgCtrl)
+
+            val msgCtrl = MsgCtrl()
+            Assert.assertArrayEquals(expectedArray, receiver.recv(expectedArray.size, msgCtrl))
+            Assert.assertEquals(Boundary.SOLO, msgCtrl.boundary)
+            Assert.assertTrue(msgCtrl.srcTime > 0)
+            Assert.assertNotEquals(-1, msgCtrl.pktSeq)
+            Assert.assertNotEquals(-1, msgCtrl.no)
+
+            val firstPktSeq = msgCtrl.pktSeq
+            val firstNo = msgCtrl.no
+            Assert.assertArrayEquals(expectedArray, receiver.recv(expectedArray.size, msgCtrl))
+            Assert.assertEquals(firstPktSeq + 1, msgCtrl.pktSeq)
+            Assert.assertEquals(firstNo + 1, msgCtrl.no)
+            receiver.close()
+        } finally {
+            sender.close()
+            listener.close()
+        }
+    }
+
     internal class ServerSend {
         private val executor = Executors.newCachedThreadPool()
         private val serverSocket = SrtSocket()
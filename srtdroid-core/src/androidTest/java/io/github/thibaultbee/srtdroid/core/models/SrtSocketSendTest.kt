@@ -1,17 +1,20 @@
 package io.github.thibaultbee.srtdroid.core.models
 
 import io.github.thibaultbee.srtdroid.core.Srt
+import io.github.thibaultbee.srtdroid.core.enums.SendBufferMetric
 import io.github.thibaultbee.srtdroid.core.enums.SockOpt
 import io.github.thibaultbee.srtdroid.core.enums.Transtype
 import io.github.thibaultbee.srtdroid.core.utils.Utils
 import org.junit.After
 import org.junit.Assert.assertArrayEquals
+import org.junit.Assert.assertEquals
 import org.junit.Assert.assertTrue
 import org.junit.Before
 import org.junit.Test
 import java.net.InetAddress
 import java.nio.ByteBuffer
 import java.util.concurrent.Callable
+import java.util.concurrent.CountDownLatch
 import java.util.concurrent.Executors
 import java.util.concurrent.Future
 import java.util.concurrent.TimeUnit
@@ -48,6 +51,85 @@ class SrtSocketSendTest {
         assertArrayEquals(expectedArray, actualArray)
     }
 
+    @Test
+    fun sendBufferWatermarksTest() {
+        val bufferSize = 1000
+        val futureResult = server.enqueue(bufferSize)
+        socket.connect(InetAddress.getLoopbackAddress(), server.port)
+        assertEquals(0L, socket.sendBufferLevel(SendBufferMetric.BYTES))
+
+        val highLatch = CountDownLatch(1)
+        val lowLatch = CountDownLatch(1)
+        socket.sendBufferListener = object : SrtSocket.SendBufferListener {
+            override fun onSendBufferHigh(socket: SrtSocket, level: Long) {
+                assertTrue(level >= 1)
+                highLatch.countDown()
+            }
+
+            override fun onSendBufferLow(socket: SrtSocket, level: Long) {
+                assertEquals(0L, level)
+                lowLatch.countDown()
+            }
+        }
+        socket.setSendBufferWatermarks(0, 1, SendBufferMetric.BYTES)
+
+        // Sent data stays in the send buffer until it is acknowledged
+        socket.send(Utils.generateRandomDirectBuffer(bufferSize))
+        futureResult.get(1000, TimeUnit.MILLISECONDS)
+
+        // Crossings are reported by the watermark thread, without sending nor polling
+        assertTrue(highLatch.await(1000, TimeUnit.MILLISECONDS))
+        assertTrue(lowLatch.await(1000, TimeUnit.MILLISECONDS))
+    }
+
+    @Test
+    fun sendBatchTest() {
+        val bufferSize = 300
+        val futureResult = server.enqueue(bufferSize)
+        socket.connect(InetAddress.getLoopbackAddress(), server.port)
+
+        val expectedBuffer = Utils.generateRandomDirectBuffer(bufferSize)
+        val batch = MsgBatch(4)
+        assertTrue(batch.add(0, 100))
+        assertTrue(batch.add(100, 150))
+        assertTrue(batch.add(250, 50))
+        assertEquals(3, socket.sendBatch(expectedBuffer, batch))
+        assertEquals(bufferSize.toLong(), batch.bytes(3))
+        assertTrue(batch.msgNos[1] != batch.msgNos[0])
+
+        val actualArray = futureResult.get(1000, TimeUnit.MILLISECONDS)
+        Utils.assertByteBufferEquals(expectedBuffer, ByteBuffer.wrap(actualArray))
+    }
+
+    @Test
+    fun liveSendBatchMsgNosTest() {
+        // Live mode: each message gets its own message number
+        val listener = SrtSocket()
+        val sender = SrtSocket()
+        try {
+            listener.bind(InetAddress.getLoopbackAddress(), 0)
+            listener.listen(1)
+            sender.connect(InetAddress.getLoopbackAddress(), listener.localPort)
+            val receiver = listener.accept().first
+
+            val messageSize = 100
+            val messageCount = 4
+            val buffer = Utils.generateRandomDirectBuffer(messageSize * messageCount)
+            val batch = MsgBatch(messageCount)
+            for (i in 0 until messageCount) {
+                assertTrue(batch.add(i * messageSize, messageSize))
+            }
+            assertEquals(messageCount, sender.sendBatch(buffer, batch))
+            for (i in 1 until messageCount) {
+                assertTrue(batch.msgNos[i] > batch.msgNos[i - 1])
+            }
+            receiver.close()
+        } finally {
+            sender.close()
+            listener.close()
+        }
+    }
+
     @Test
     fun sendByteBuffer() {
         val bufferSize = 1000
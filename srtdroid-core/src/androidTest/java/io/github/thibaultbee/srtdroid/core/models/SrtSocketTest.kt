@@ -41,6 +41,7 @@ import java.io.File
 import java.io.IOException
 import java.net.SocketException
 import java.nio.ByteBuffer
+import java.nio.ByteOrder
 
 
 /*
@@ -183,6 +184,69 @@ class SrtSocketTest {
         socket.setSockFlag(SockOpt.STREAMID, "Hello")
     }
 
+    @Test
+    fun setSockOptRoundTripTest() {
+        socket.setSockFlag(SockOpt.MSS, 1400)
+        assertEquals(1400, socket.getSockFlag(SockOpt.MSS))
+        socket.setSockFlag(SockOpt.MAXBW, 1000000L)
+        assertEquals(1000000L, socket.getSockFlag(SockOpt.MAXBW))
+        socket.setSockFlag(SockOpt.TSBPDMODE, false)
+        assertEquals(false, socket.getSockFlag(SockOpt.TSBPDMODE))
+        socket.setSockFlag(SockOpt.TRANSTYPE, Transtype.FILE)
+        assertEquals(Transtype.FILE, socket.getSockFlag(SockOpt.TRANSTYPE))
+        socket.setSockFlag(SockOpt.STREAMID, "#!::r=live/cam")
+        assertEquals("#!::r=live/cam", socket.getSockFlag(SockOpt.STREAMID))
+    }
+
+    @Test
+    fun setSockOptTooLongStringTest() {
+        try {
+            socket.setSockFlag(SockOpt.STREAMID, "a".repeat(2000))
+            fail()
+        } catch (e: IOException) {
+            assertEquals("Value of ${SockOpt.STREAMID} is too long", e.message)
+        }
+    }
+
+    @Test
+    fun applyAndSnapshotOptionsTest() {
+        socket.applyOptions(
+            SockOptions.Builder()
+                .set(SockOpt.MSS, 1400)
+                .set(SockOpt.MAXBW, 1000000L)
+                .set(SockOpt.TSBPDMODE, false)
+                .set(SockOpt.TRANSTYPE, Transtype.FILE)
+                .set(SockOpt.STREAMID, "#!::r=live/cam")
+                .build()
+        )
+        assertEquals("#!::r=live/cam", socket.getSockFlag(SockOpt.STREAMID))
+
+        val snapshot = SockOptSnapshot(
+            listOf(SockOpt.MSS, SockOpt.MAXBW, SockOpt.TSBPDMODE, SockOpt.TRANSTYPE, SockOpt.STREAMID)
+        )
+        assertEquals(4, socket.snapshotOptions(snapshot))
+        assertEquals(1400L, snapshot[SockOpt.MSS])
+        assertEquals(1000000L, snapshot[SockOpt.MAXBW])
+        assertEquals(0L, snapshot[SockOpt.TSBPDMODE])
+        assertEquals(Transtype.FILE.ordinal.toLong(), snapshot[SockOpt.TRANSTYPE])
+        assertNull(snapshot[SockOpt.STREAMID])
+    }
+
+    @Test
+    fun applyOptionsFailureTest() {
+        try {
+            socket.applyOptions(
+                SockOptions.Builder()
+                    .set(SockOpt.MSS, 1400)
+                    .set(SockOpt.MSS, 10)
+                    .build()
+            )
+            fail()
+        } catch (_: IOException) {
+        }
+        assertEquals(1400, socket.getSockFlag(SockOpt.MSS))
+    }
+
     @Test
     fun sendByteBufferTest() {
         try {
@@ -329,6 +393,21 @@ class SrtSocketTest {
         socket.bistats(clear = true, instantaneous = false)
     }
 
+    @Test
+    fun bistatsIntoBufferTest() {
+        val stats = socket.bistats(clear = false, instantaneous = false, StatsBuffer())
+        assertEquals(1500, stats.byteMSS)
+        assertEquals(stats.byteMSS, stats.toStats().byteMSS)
+        assertEquals(stats.mbpsMaxBW, stats.toStats().mbpsMaxBW, 0.0)
+
+        val values = ByteBuffer.allocateDirect(8 * StatsBuffer.LAYOUT_SIZE)
+            .order(ByteOrder.nativeOrder())
+            .asDoubleBuffer()
+        socket.bistats(clear = false, instantaneous = false, values)
+        assertEquals(StatsBuffer.LAYOUT_SIZE, values.position())
+        assertEquals(1500.0, values.get(StatsBuffer.BYTE_MSS), 0.0)
+    }
+
     @Test
     fun connectionTimeTest() {
         assertEquals(0, socket.connectionTime)
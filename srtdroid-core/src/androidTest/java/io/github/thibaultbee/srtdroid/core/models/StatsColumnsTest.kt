@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import io.github.thibaultbee.srtdroid.core.Srt
+import io.github.thibaultbee.srtdroid.core.enums.SockOpt
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+
+class StatsColumnsTest {
+    private val sockets = mutableListOf<SrtSocket>()
+    private val statsColumns = StatsColumns(4)
+
+    @Before
+    fun setUp() {
+        repeat(3) { sockets.add(SrtSocket()) }
+        sockets[1].setSockFlag(SockOpt.MSS, 1400)
+    }
+
+    @After
+    fun tearDown() {
+        sockets.forEach { it.close() }
+        assertEquals(Srt.cleanUp(), 0)
+    }
+
+    @Test
+    fun collectTest() {
+        assertEquals(3, statsColumns.collect(sockets))
+        assertEquals(3, statsColumns.size)
+        assertEquals(1500, statsColumns.getLong(StatsBuffer.BYTE_MSS, 0))
+        assertEquals(1400, statsColumns.getLong(StatsBuffer.BYTE_MSS, 1))
+        assertEquals(1500, statsColumns.getLong(StatsBuffer.BYTE_MSS, 2))
+        assertEquals(4400, statsColumns.sum(StatsBuffer.BYTE_MSS))
+        assertFalse(statsColumns.isValid(3))
+    }
+
+    @Test
+    fun collectClosedSocketTest() {
+        val closedSocket = SrtSocket()
+        closedSocket.close()
+        assertEquals(3, statsColumns.collect(sockets.subList(0, 2) + closedSocket + sockets[2]))
+        assertTrue(statsColumns.isValid(0))
+        assertFalse(statsColumns.isValid(2))
+        assertTrue(statsColumns.isValid(3))
+        assertEquals(4400, statsColumns.sum(StatsBuffer.BYTE_MSS))
+    }
+
+    @Test
+    fun collectEpollTest() {
+        val epoll = Epoll()
+        sockets.forEach { epoll.addUSock(it, null) }
+        assertEquals(3, statsColumns.collect(epoll))
+        assertEquals(4400, statsColumns.sum(StatsBuffer.BYTE_MSS))
+        epoll.release()
+    }
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import io.github.thibaultbee.srtdroid.core.Srt
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertTrue
+import org.junit.Assert.fail
+import org.junit.Before
+import org.junit.Test
+import java.util.concurrent.CountDownLatch
+import java.util.concurrent.TimeUnit
+
+class StatsSamplerTest {
+    private lateinit var sampler: StatsSampler
+    private lateinit var socket: SrtSocket
+
+    @Before
+    fun setUp() {
+        sampler = StatsSampler(intervalInMs = 10, historySize = 16)
+        assertTrue(sampler.isValid)
+        socket = SrtSocket()
+    }
+
+    @After
+    fun tearDown() {
+        sampler.close()
+        assertFalse(sampler.isValid)
+        socket.close()
+        assertEquals(Srt.cleanUp(), 0)
+    }
+
+    @Test
+    fun readTest() {
+        sampler.subscribe(socket)
+        Thread.sleep(300)
+
+        val history = sampler.read(socket, 10000)
+        assertEquals(16, history.size)
+        for (i in 0 until history.size) {
+            assertEquals(1500, history.getLong(i, StatsBuffer.BYTE_MSS))
+        }
+        assertTrue(history.getLong(0, StatsSampler.SAMPLE_TIME) < history.getLong(15, StatsSampler.SAMPLE_TIME))
+        assertEquals(0.0, history.getDouble(15, StatsSampler.SEND_RATE_MBPS), 0.0)
+
+        val smallHistory = sampler.read(socket, 10000, StatsSampler.History(4))
+        assertEquals(4, smallHistory.size)
+        assertTrue(
+            history.getLong(15, StatsSampler.SAMPLE_TIME) <= smallHistory.getLong(3, StatsSampler.SAMPLE_TIME)
+        )
+    }
+
+    @Test
+    fun thresholdTest() {
+        val latch = CountDownLatch(1)
+        sampler.addThreshold(StatsBuffer.BYTE_MSS, true, 1000.0) { s, isCrossed, value ->
+            assertEquals(socket, s)
+            assertTrue(isCrossed)
+            assertEquals(1500.0, value, 0.0)
+            latch.countDown()
+        }
+        sampler.subscribe(socket)
+        assertTrue(latch.await(5, TimeUnit.SECONDS))
+    }
+
+    @Test
+    fun invalidThresholdTest() {
+        try {
+            sampler.addThreshold(StatsSampler.SAMPLE_SIZE, true, 0.0) { _, _, _ -> }
+            fail()
+        } catch (_: IllegalArgumentException) {
+        }
+    }
+
+    @Test
+    fun useAfterCloseTest() {
+        sampler.close()
+        sampler.close()
+        assertFalse(sampler.isValid)
+        try {
+            sampler.subscribe(socket)
+            fail()
+        } catch (_: IllegalStateException) {
+        }
+        try {
+            sampler.read(socket, 1000)
+            fail()
+        } catch (_: IllegalStateException) {
+        }
+        try {
+            sampler.addThreshold(StatsBuffer.MS_RTT, true, 100.0) { _, _, _ -> }
+            fail()
+        } catch (_: IllegalStateException) {
+        }
+    }
+}
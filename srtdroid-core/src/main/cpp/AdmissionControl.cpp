@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <cstring>
+
+#include "AdmissionControl.h"
+
+static const char ACCESS_CONTROL_PREFIX[] = "#!::";
+
+void AdmissionControl::configure(std::vector<Rule> rules, Action defaultAction,
+                                 int defaultRejectReason, RateLimit global, RateLimit perAddress,
+                                 int rateLimitRejectReason) {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->rules = std::move(rules);
+    this->defaultAction = defaultAction;
+    this->defaultRejectReason = defaultRejectReason;
+    this->global = global;
+    this->perAddress = perAddress;
+    this->rateLimitRejectReason = rateLimitRejectReason;
+
+    globalBucket = {global.burst, Clock::now()};
+    addressBuckets.clear();
+    addressesByUse.clear();
+}
+
+AdmissionControl::Action
+AdmissionControl::evaluate(const struct sockaddr *peeraddr, const char *streamid,
+                           int *rejectReason) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Clock::time_point now = Clock::now();
+
+    if ((global.ratePerSecond > 0) && !globalBucket.tryTake(global, now)) {
+        *rejectReason = rateLimitRejectReason;
+        return DENY;
+    }
+    if ((perAddress.ratePerSecond > 0) && !tryTakeAddressToken(peeraddr, now)) {
+        *rejectReason = rateLimitRejectReason;
+        return DENY;
+    }
+
+    *rejectReason = defaultRejectReason;
+    if (rules.empty()) {
+        return defaultAction;
+    }
+
+    std::vector<std::pair<std::string, std::string>> keyValues;
+    parseStreamId(streamid, keyValues);
+
+    for (const Rule &rule: rules) {
+        bool isMatching = false;
+        if (rule.key.empty()) {
+            isMatching = matches(rule.pattern, streamid != nullptr ? streamid : "");
+        } else {
+            for (const auto &keyValue: keyValues) {
+                if ((keyValue.first == rule.key) && matches(rule.pattern, keyValue.second)) {
+                    isMatching = true;
+                    break;
+                }
+            }
+        }
+
+        if (isMatching) {
+            if (rule.rejectReason != 0) {
+                *rejectReason = rule.rejectReason;
+            }
+            return rule.action;
+        }
+    }
+
+    return defaultAction;
+}
+
+void AdmissionControl::parseStreamId(const char *streamid,
+                                     std::vector<std::pair<std::string, std::string>> &keyValues) {
+    if ((streamid == nullptr) || (streamid[0] == '\0')) {
+        return;
+    }
+
+    size_t prefixLength = sizeof(ACCESS_CONTROL_PREFIX) - 1;
+    if (strncmp(streamid, ACCESS_CONTROL_PREFIX, prefixLength) != 0) {
+        keyValues.emplace_back("r", streamid);
+        return;
+    }
+
+    const char *begin = streamid + prefixLength;
+    while (*begin != '\0') {
+        const char *end = strchr(begin, ',');
+        if (end == nullptr) {
+            end = begin + strlen(begin);
+        }
+
+        const char *separator = static_cast<const char *>(memchr(begin, '=', end - begin));
+        if (separator != nullptr) {
+            keyValues.emplace_back(std::string(begin, separator - begin),
+                                   std::string(separator + 1, end - separator - 1));
+        }
+
+        begin = (*end == ',') ? end + 1 : end;
+    }
+}
+
+void AdmissionControl::release(void *admissionControl) {
+    delete static_cast<AdmissionControl *>(admissionControl);
+}
+
+bool AdmissionControl::TokenBucket::tryTake(const RateLimit &rateLimit, Clock::time_point now) {
+    double elapsed = std::chrono::duration<double>(now - lastRefill).count();
+    tokens = std::min(rateLimit.burst, tokens + elapsed * rateLimit.ratePerSecond);
+    lastRefill = now;
+
+    if (tokens < 1.0) {
+        return false;
+    }
+    tokens -= 1.0;
+    return true;
+}
+
+bool AdmissionControl::tryTakeAddressToken(const struct sockaddr *peeraddr,
+                                           Clock::time_point now) {
+    std::string address;
+    if (peeraddr->sa_family == AF_INET) {
+        auto *sa = reinterpret_cast<const struct sockaddr_in *>(peeraddr);
+        address.assign(reinterpret_cast<const char *>(&sa->sin_addr), sizeof(sa->sin_addr));
+    } else if (peeraddr->sa_family == AF_INET6) {
+        auto *sa = reinterpret_cast<const struct sockaddr_in6 *>(peeraddr);
+        address.assign(reinterpret_cast<const char *>(&sa->sin6_addr), sizeof(sa->sin6_addr));
+    } else {
+        return true;
+    }
+
+    auto it = addressBuckets.find(address);
+    if (it == addressBuckets.end()) {
+        if (addressBuckets.size() >= MAX_ADDRESSES) {
+            // Bounded whatever the number of source addresses: drop the least recently used
+            addressBuckets.erase(addressesByUse.back());
+            addressesByUse.pop_back();
+        }
+        addressesByUse.push_front(address);
+        it = addressBuckets.emplace(address, AddressBucket{TokenBucket{perAddress.burst, now},
+                                                           addressesByUse.begin()}).first;
+    } else {
+        addressesByUse.splice(addressesByUse.begin(), addressesByUse, it->second.use);
+    }
+
+    return it->second.bucket.tryTake(perAddress, now);
+}
+
+bool AdmissionControl::matches(const std::string &pattern, const std::string &value) {
+    if (!pattern.empty() && (pattern.back() == '*')) {
+        size_t prefixLength = pattern.size() - 1;
+        return (value.size() >= prefixLength) &&
+               (value.compare(0, prefixLength, pattern, 0, prefixLength) == 0);
+    }
+    return value == pattern;
+}
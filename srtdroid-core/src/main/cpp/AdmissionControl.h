@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "srt/srt.h"
+
+/**
+ * Admission policy of a listener socket, evaluated in the SRT listen callback before the incoming
+ * connection is escalated to Java.
+ *
+ * Rate limits are applied first, then rules are matched in order: the first matching rule decides.
+ * If no rule matches, the default action applies.
+ */
+class AdmissionControl {
+public:
+    enum Action {
+        ALLOW = 0,
+        DENY = 1
+    };
+
+    struct Rule {
+        Action action;
+        /**
+         * Access control key ("r", "m", "u", ...) or empty to match the whole stream ID.
+         */
+        std::string key;
+        /**
+         * Exact value or prefix if it ends with '*'.
+         */
+        std::string pattern;
+        /**
+         * Reject reason of a DENY rule. 0 for the default reject reason.
+         */
+        int rejectReason;
+    };
+
+    struct RateLimit {
+        /**
+         * Connections per second. Disabled if not positive.
+         */
+        double ratePerSecond = 0;
+        /**
+         * Maximum number of connections in a burst.
+         */
+        double burst = 0;
+    };
+
+    AdmissionControl() = default;
+
+    /**
+     * Replaces the policy. Can be called while connections are evaluated.
+     */
+    void configure(std::vector<Rule> rules, Action defaultAction, int defaultRejectReason,
+                   RateLimit global, RateLimit perAddress, int rateLimitRejectReason);
+
+    /**
+     * Evaluates an incoming connection.
+     *
+     * @param peeraddr the address of the incoming connection
+     * @param streamid the stream ID of the incoming connection
+     * @param rejectReason the reject reason to set if the connection is rejected
+     * @return the action on the connection
+     */
+    Action evaluate(const struct sockaddr *peeraddr, const char *streamid, int *rejectReason);
+
+    /**
+     * Parses a stream ID in the SRT access control syntax: `#!::key1=value1,key2=value2`.
+     * A stream ID that doesn't use this syntax is considered as the resource name ("r").
+     *
+     * @param streamid the stream ID
+     * @param keyValues the parsed (key, value) pairs
+     */
+    static void parseStreamId(const char *streamid,
+                              std::vector<std::pair<std::string, std::string>> &keyValues);
+
+    /**
+     * Deletes an AdmissionControl. Suitable as a SocketRegistry user data deleter.
+     */
+    static void release(void *admissionControl);
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct TokenBucket {
+        double tokens;
+        Clock::time_point lastRefill;
+
+        bool tryTake(const RateLimit &rateLimit, Clock::time_point now);
+    };
+
+    struct AddressBucket {
+        TokenBucket bucket;
+        /**
+         * Position in addressesByUse.
+         */
+        std::list<std::string>::iterator use;
+    };
+
+    /**
+     * Maximum number of per address buckets. The least recently used one is dropped beyond.
+     */
+    static const size_t MAX_ADDRESSES = 4096;
+
+    std::mutex mutex;
+    std::vector<Rule> rules;
+    Action defaultAction = ALLOW;
+    int defaultRejectReason = 0;
+    RateLimit global;
+    RateLimit perAddress;
+    int rateLimitRejectReason = 0;
+    TokenBucket globalBucket = {0, Clock::time_point()};
+    std::unordered_map<std::string, AddressBucket> addressBuckets;
+    /**
+     * Addresses of addressBuckets, most recently used first.
+     */
+    std::list<std::string> addressesByUse;
+
+    bool tryTakeAddressToken(const struct sockaddr *peeraddr, Clock::time_point now);
+
+    static bool matches(const std::string &pattern, const std::string &value);
+};
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <chrono>
+
+#include "BitrateController.h"
+#include "StatsSampler.h"
+#include "log.h"
+#include "Models/ModelsSingleton.h"
+#include "Models/Stats.h"
+
+
+BitrateEstimator::Config BitrateEstimator::Config::fromArray(const jdouble *config) {
+    Config res;
+    res.mode = config[0] == BANDWIDTH ? BANDWIDTH : AIMD;
+    res.minBitrate = config[1];
+    res.maxBitrate = config[2];
+    res.initialBitrate = config[3];
+    res.additiveIncrease = config[4];
+    res.decreaseFactor = config[5];
+    res.maxLossPercent = config[6];
+    res.maxRttIncreasePercent = config[7];
+    res.maxSndBufMs = config[8];
+    res.bandwidthHeadroom = config[9];
+    return res;
+}
+
+BitrateEstimator::BitrateEstimator(const Config &config)
+        : config(config),
+          targetBitrate(std::clamp(config.initialBitrate, config.minBitrate, config.maxBitrate)) {
+}
+
+int64_t BitrateEstimator::update(const jlong *sample) {
+    // The first sample of a socket has no interval values
+    if (sample[StatsSampler::INTERVAL_MS] <= 0) {
+        return getTargetBitrate();
+    }
+
+    double rtt = StatsSampler::getValue(sample, Stats::MS_RTT);
+    if ((rtt > 0) && ((minRtt == 0) || (rtt < minRtt))) {
+        minRtt = rtt;
+    }
+    double loss = std::max(StatsSampler::getValue(sample, StatsSampler::SND_LOSS_PERCENT),
+                           StatsSampler::getValue(sample, StatsSampler::RETRANS_PERCENT));
+
+    bool isCongested = (loss > config.maxLossPercent) ||
+                       (sample[Stats::MS_SND_BUF] > config.maxSndBufMs) ||
+                       (sample[Stats::BYTE_AVAIL_SND_BUF] == 0) ||
+                       ((minRtt > 0) &&
+                        (rtt > minRtt * (1 + config.maxRttIncreasePercent / 100)));
+
+    if (isCongested) {
+        targetBitrate *= config.decreaseFactor;
+    } else {
+        targetBitrate += config.additiveIncrease;
+        double bandwidth = StatsSampler::getValue(sample, Stats::MBPS_BANDWIDTH);
+        if ((config.mode == BANDWIDTH) && (bandwidth > 0)) {
+            targetBitrate = std::min(targetBitrate,
+                                     bandwidth * 1000000 * config.bandwidthHeadroom);
+        }
+    }
+    targetBitrate = std::clamp(targetBitrate, config.minBitrate, config.maxBitrate);
+
+    return getTargetBitrate();
+}
+
+int64_t BitrateEstimator::getTargetBitrate() const {
+    return (int64_t) targetBitrate;
+}
+
+BitrateController::BitrateController(JNIEnv *env, jobject controller, SRTSOCKET u,
+                                     const BitrateEstimator::Config &config, int intervalInMs,
+                                     int maxBwOverheadPercent)
+        : u(u), estimator(config), intervalInMs(intervalInMs),
+          maxBwOverheadPercent(maxBwOverheadPercent), isRunning(false) {
+    env->GetJavaVM(&(this->vm));
+
+    if (intervalInMs <= 0) {
+        LOGE("Invalid controller interval");
+        return;
+    }
+
+    this->controller = env->NewGlobalRef(controller);
+
+    isRunning = true;
+    if (pthread_create(&thread, nullptr, BitrateController::run, this) != 0) {
+        LOGE("Can't create controller thread");
+        isRunning = false;
+        return;
+    }
+    hasThread = true;
+}
+
+BitrateController::~BitrateController() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isRunning = false;
+    }
+    wakeUp.notify_all();
+    if (hasThread) {
+        if (pthread_equal(pthread_self(), thread)) {
+            // Deleted by the controller thread itself, see run()
+            pthread_detach(thread);
+        } else {
+            pthread_join(thread, nullptr);
+        }
+    }
+
+    JNIEnv *env = nullptr;
+    vm->GetEnv((void **) &env, JNI_VERSION_1_6);
+    if ((env != nullptr) && (controller != nullptr)) {
+        env->DeleteGlobalRef(controller);
+    }
+}
+
+void BitrateController::release() {
+    isRunning = false;
+    if (hasThread && pthread_equal(pthread_self(), thread)) {
+        // Released from a controller callback: the controller thread still uses this object
+        isReleasedByThread = true;
+        return;
+    }
+    delete this;
+}
+
+bool BitrateController::isValid() const {
+    return hasThread;
+}
+
+void *BitrateController::run(void *opaque) {
+    auto *bitrateController = static_cast<BitrateController *>(opaque);
+    JNIEnv *env = nullptr;
+
+    JavaVMAttachArgs args = {JNI_VERSION_1_6, "SrtBitrateController", nullptr};
+    if (bitrateController->vm->AttachCurrentThread(&env, &args) != JNI_OK) {
+        LOGE("Can't attach controller thread");
+        return nullptr;
+    }
+
+    bitrateController->loop(env);
+
+    JavaVM *vm = bitrateController->vm;
+    if (bitrateController->isReleasedByThread) {
+        delete bitrateController;
+    }
+    vm->DetachCurrentThread();
+    return nullptr;
+}
+
+void BitrateController::loop(JNIEnv *env) {
+    jmethodID onTargetBitrateMethod = ModelsSingleton::getInstance(
+            env)->bitrateControllerOnTargetBitrateMethod;
+    jlong sample[StatsSampler::SAMPLE_SIZE];
+    SRT_TRACEBSTATS tracebstats;
+    SRT_TRACEBSTATS last;
+    int64_t lastTime = 0;
+    bool hasLast = false;
+    int64_t targetBitrate = estimator.getTargetBitrate();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (isRunning) {
+        wakeUp.wait_for(lock, std::chrono::milliseconds(intervalInMs),
+                        [this] { return !isRunning; });
+        if (!isRunning) {
+            break;
+        }
+
+        // Do not clear: other statistics readers must not be disturbed
+        if (srt_bistats(u, &tracebstats, 0, 0) != 0) {
+            continue;
+        }
+        int64_t time = srt_time_now();
+        StatsSampler::write(tracebstats, time, hasLast ? &last : nullptr, lastTime, sample);
+        last = tracebstats;
+        lastTime = time;
+        hasLast = true;
+
+        int64_t bitrate = estimator.update(sample);
+        if (bitrate == targetBitrate) {
+            continue;
+        }
+        targetBitrate = bitrate;
+
+        if (maxBwOverheadPercent > 0) {
+            // SRTO_MAXBW is in bytes per second
+            int64_t maxBw = bitrate / 8 * (100 + maxBwOverheadPercent) / 100;
+            if (srt_setsockflag(u, SRTO_MAXBW, &maxBw, sizeof(maxBw)) != 0) {
+                LOGE("Can't set maximum bandwidth: %s", srt_getlasterror_str());
+            }
+        }
+
+        lock.unlock();
+        env->CallVoidMethod(controller, onTargetBitrateMethod, (jlong) bitrate);
+        if (env->ExceptionCheck()) {
+            LOGE("Exception in controller callback");
+            env->ExceptionDescribe();
+            env->ExceptionClear();
+        }
+        lock.lock();
+    }
+}
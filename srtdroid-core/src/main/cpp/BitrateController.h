@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <jni.h>
+#include <mutex>
+#include <pthread.h>
+
+#include "srt/srt.h"
+
+/**
+ * Computes a target bitrate from statistics samples (see StatsSampler::write).
+ *
+ * It has no dependency on a socket or a clock, so recorded traces always give the same output.
+ */
+class BitrateEstimator {
+public:
+    enum Mode {
+        /** Additive increase, multiplicative decrease on congestion */
+        AIMD = 0,
+        /** Same as AIMD, bounded by a fraction of the estimated link bandwidth */
+        BANDWIDTH
+    };
+
+    /**
+     * Estimator parameters. fromArray reads them in declaration order.
+     */
+    struct Config {
+        Mode mode = AIMD;
+        /** Bitrates in bits per second */
+        double minBitrate = 300000;
+        double maxBitrate = 10000000;
+        double initialBitrate = 2000000;
+        /** Added on each sample without congestion, in bits per second */
+        double additiveIncrease = 50000;
+        /** Multiplies the bitrate on each sample with congestion */
+        double decreaseFactor = 0.75;
+        /** Congestion when lost or retransmitted packets are above this percentage of sent packets */
+        double maxLossPercent = 2;
+        /** Congestion when RTT is above the minimum RTT by more than this percentage */
+        double maxRttIncreasePercent = 50;
+        /** Congestion when the send buffer holds more than this duration */
+        double maxSndBufMs = 500;
+        /** Fraction of the estimated bandwidth usable in BANDWIDTH mode */
+        double bandwidthHeadroom = 0.8;
+
+        static constexpr int SIZE = 10;
+
+        static Config fromArray(const jdouble *config);
+    };
+
+    explicit BitrateEstimator(const Config &config);
+
+    /**
+     * Updates the target bitrate with a new sample.
+     *
+     * @param sample a StatsSampler sample
+     * @return the target bitrate in bits per second
+     */
+    int64_t update(const jlong *sample);
+
+    int64_t getTargetBitrate() const;
+
+private:
+    Config config;
+    double targetBitrate;
+    double minRtt = 0;
+};
+
+/**
+ * Native side of BitrateController: a thread that samples the statistics of a sender socket,
+ * feeds them to a BitrateEstimator and reports target bitrate changes to the Java controller.
+ */
+class BitrateController {
+public:
+    /**
+     * Creates the controller and starts its thread.
+     *
+     * @param env JNI environment
+     * @param controller the Java BitrateController
+     * @param u the sender socket
+     * @param config estimator parameters
+     * @param intervalInMs sampling interval
+     * @param maxBwOverheadPercent if positive, SRTO_MAXBW is set to the target bitrate plus this
+     * percentage on each change. Otherwise, SRTO_MAXBW is left untouched.
+     */
+    BitrateController(JNIEnv *env, jobject controller, SRTSOCKET u,
+                      const BitrateEstimator::Config &config, int intervalInMs,
+                      int maxBwOverheadPercent);
+
+    /**
+     * Stops the controller thread. Use release() once the controller thread has been created.
+     */
+    ~BitrateController();
+
+    /**
+     * Stops the controller thread and deletes the controller. If it is called from a controller
+     * callback, the controller thread deletes the controller once the callback has returned.
+     */
+    void release();
+
+    /**
+     * @return true if the controller thread has been created
+     */
+    bool isValid() const;
+
+private:
+    JavaVM *vm = nullptr;
+    jobject controller = nullptr;
+    SRTSOCKET u;
+    BitrateEstimator estimator;
+    int intervalInMs;
+    int maxBwOverheadPercent;
+    pthread_t thread;
+    bool hasThread = false;
+    std::atomic<bool> isRunning;
+    // Only accessed by the controller thread
+    bool isReleasedByThread = false;
+
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+
+    static void *run(void *opaque);
+
+    void loop(JNIEnv *env);
+};
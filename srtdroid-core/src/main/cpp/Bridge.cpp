@@ -0,0 +1,336 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Bridge.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "log.h"
+#include "Models/ModelsSingleton.h"
+
+// Bounds the time to see a stop request
+static constexpr int POLL_TIMEOUT_IN_MS = 100;
+// Largest UDP datagram and largest SRT message in message mode
+static constexpr int BUFFER_SIZE = 65536;
+
+Bridge::Bridge(JNIEnv *env, jobject bridge, SRTSOCKET u, Direction direction,
+               const struct sockaddr_storage *address, int addressSize, int chunkSize, bool pace)
+        : u(u), direction(direction), chunkSize(chunkSize), pace(pace), buffer(BUFFER_SIZE),
+          isRunning(false) {
+    env->GetJavaVM(&(this->vm));
+    for (auto &counter: counters) {
+        counter = 0;
+    }
+
+    if ((address == nullptr) || (chunkSize <= 0)) {
+        LOGE("Invalid bridge parameters");
+        return;
+    }
+    if (!open(address, addressSize)) {
+        return;
+    }
+
+    eid = srt_epoll_create();
+    if (eid < 0) {
+        LOGE("Can't create bridge epoll");
+        return;
+    }
+    int events = SRT_EPOLL_IN | SRT_EPOLL_ERR;
+    int res;
+    if (direction == UDP_TO_SRT) {
+        res = srt_epoll_add_ssock(eid, fd, &events);
+    } else {
+        res = srt_epoll_add_usock(eid, u, &events);
+    }
+    if (res != 0) {
+        LOGE("Can't add socket to bridge epoll: %s", srt_getlasterror_str());
+        return;
+    }
+
+    this->bridge = env->NewGlobalRef(bridge);
+
+    isRunning = true;
+    if (pthread_create(&thread, nullptr, Bridge::run, this) != 0) {
+        LOGE("Can't create bridge thread");
+        isRunning = false;
+        return;
+    }
+    hasThread = true;
+}
+
+Bridge::~Bridge() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isRunning = false;
+    }
+    wakeUp.notify_all();
+    if (hasThread) {
+        if (pthread_equal(pthread_self(), thread)) {
+            // Deleted by the bridge thread itself, see run()
+            pthread_detach(thread);
+        } else {
+            pthread_join(thread, nullptr);
+        }
+    }
+
+    if (eid >= 0) {
+        srt_epoll_release(eid);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+
+    JNIEnv *env = nullptr;
+    vm->GetEnv((void **) &env, JNI_VERSION_1_6);
+    if ((env != nullptr) && (bridge != nullptr)) {
+        env->DeleteGlobalRef(bridge);
+    }
+}
+
+void Bridge::release() {
+    isRunning = false;
+    if (hasThread && pthread_equal(pthread_self(), thread)) {
+        // Released from a bridge callback: the bridge thread still uses this object
+        isReleasedByThread = true;
+        return;
+    }
+    delete this;
+}
+
+bool Bridge::isValid() const {
+    return hasThread;
+}
+
+int Bridge::getLocalPort() const {
+    struct sockaddr_storage ss = {};
+    socklen_t size = sizeof(ss);
+    if (getsockname(fd, reinterpret_cast<struct sockaddr *>(&ss), &size) != 0) {
+        return -1;
+    }
+    if (ss.ss_family == AF_INET6) {
+        return ntohs(reinterpret_cast<struct sockaddr_in6 *>(&ss)->sin6_port);
+    }
+    return ntohs(reinterpret_cast<struct sockaddr_in *>(&ss)->sin_port);
+}
+
+void Bridge::getCounters(jlong *counters) const {
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        counters[i] = this->counters[i];
+    }
+}
+
+bool Bridge::open(const struct sockaddr_storage *address, int addressSize) {
+    int type = (direction == SRT_TO_TCP) ? SOCK_STREAM : SOCK_DGRAM;
+    fd = socket(address->ss_family, type, 0);
+    if (fd < 0) {
+        LOGE("Can't create bridge socket: %s", strerror(errno));
+        return false;
+    }
+
+    const auto *sa = reinterpret_cast<const struct sockaddr *>(address);
+    if (direction == UDP_TO_SRT) {
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (bind(fd, sa, addressSize) != 0) {
+            LOGE("Can't bind bridge socket: %s", strerror(errno));
+            return false;
+        }
+    } else if (connect(fd, sa, addressSize) != 0) {
+        // UDP: only sets the destination. TCP: connects.
+        LOGE("Can't connect bridge socket: %s", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+void *Bridge::run(void *opaque) {
+    auto *bridge = static_cast<Bridge *>(opaque);
+    JNIEnv *env = nullptr;
+
+    JavaVMAttachArgs args = {JNI_VERSION_1_6, "SrtBridge", nullptr};
+    if (bridge->vm->AttachCurrentThread(&env, &args) != JNI_OK) {
+        LOGE("Can't attach bridge thread");
+        return nullptr;
+    }
+
+    bridge->loop(env);
+
+    JavaVM *vm = bridge->vm;
+    if (bridge->isReleasedByThread) {
+        delete bridge;
+    }
+    vm->DetachCurrentThread();
+    return nullptr;
+}
+
+void Bridge::loop(JNIEnv *env) {
+    std::string reason = forward();
+    if (reason.empty()) {
+        return;
+    }
+
+    jstring message = env->NewStringUTF(reason.c_str());
+    env->CallVoidMethod(bridge, ModelsSingleton::getInstance(env)->bridgeOnClosedMethod, message);
+    if (env->ExceptionCheck()) {
+        LOGE("Exception in bridge callback");
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+    }
+    env->DeleteLocalRef(message);
+}
+
+std::string Bridge::forward() {
+    // srt_epoll_uwait does not report system sockets
+    SRTSOCKET readySocket;
+    int nReadySockets;
+    SYSSOCKET readySysSocket;
+    int nReadySysSockets;
+
+    while (isRunning) {
+        nReadySockets = 1;
+        nReadySysSockets = 1;
+        int res = srt_epoll_wait(eid, &readySocket, &nReadySockets, nullptr, nullptr,
+                                 POLL_TIMEOUT_IN_MS, &readySysSocket, &nReadySysSockets, nullptr,
+                                 nullptr);
+        if (res < 0) {
+            if (srt_getlasterror(nullptr) == SRT_ETIMEOUT) {
+                continue;
+            }
+            return srt_getlasterror_str();
+        }
+
+        std::string reason = (direction == UDP_TO_SRT) ? udpToSrt() : srtToSystem();
+        if (!reason.empty()) {
+            return reason;
+        }
+    }
+
+    return "";
+}
+
+std::string Bridge::srtToSystem() {
+    SRT_MSGCTRL msgctrl = srt_msgctrl_default;
+    int res = srt_recvmsg2(u, buffer.data(), (int) buffer.size(), &msgctrl);
+    if (res < 0) {
+        int error = srt_getlasterror(nullptr);
+        if (error == SRT_EASYNCRCV) {
+            return "";
+        }
+        return srt_strerror(error, 0);
+    }
+    if (res == 0) {
+        return "";
+    }
+    counters[RECEIVED_PACKETS]++;
+    counters[RECEIVED_BYTES] += res;
+
+    if (pace) {
+        waitFor(msgctrl.srctime);
+    }
+
+    if (direction == SRT_TO_TCP) {
+        if (!sendToSystem(buffer.data(), res)) {
+            return strerror(errno);
+        }
+        return "";
+    }
+
+    for (int offset = 0; offset < res; offset += chunkSize) {
+        int len = std::min(chunkSize, res - offset);
+        if (!sendToSystem(&buffer[offset], len)) {
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == ECONNREFUSED)) {
+                // No UDP listener or full socket buffer: only this datagram is lost
+                counters[DROPPED_PACKETS]++;
+                continue;
+            }
+            return strerror(errno);
+        }
+    }
+    return "";
+}
+
+std::string Bridge::udpToSrt() {
+    ssize_t res = recv(fd, buffer.data(), buffer.size(), MSG_DONTWAIT);
+    if (res < 0) {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            return "";
+        }
+        return strerror(errno);
+    }
+    counters[RECEIVED_PACKETS]++;
+    counters[RECEIVED_BYTES] += res;
+
+    // All chunks of a datagram carry its arrival time, so the receiver reproduces the input timing
+    SRT_MSGCTRL msgctrl = srt_msgctrl_default;
+    msgctrl.srctime = srt_time_now();
+    for (int offset = 0; offset < res; offset += chunkSize) {
+        int len = std::min(chunkSize, (int) res - offset);
+        SRT_MSGCTRL chunkMsgctrl = msgctrl;
+        if (srt_sendmsg2(u, &buffer[offset], len, &chunkMsgctrl) <= 0) {
+            int error = srt_getlasterror(nullptr);
+            if ((error == SRT_ECONNLOST) || (error == SRT_ENOCONN) || (error == SRT_EINVSOCK)) {
+                return srt_strerror(error, 0);
+            }
+            counters[DROPPED_PACKETS]++;
+            continue;
+        }
+        counters[SENT_PACKETS]++;
+        counters[SENT_BYTES] += len;
+    }
+    return "";
+}
+
+void Bridge::waitFor(int64_t srcTime) {
+    if (srcTime <= 0) {
+        return;
+    }
+    int64_t now = srt_time_now();
+    if (!hasSrcTimeOffset) {
+        // The first message goes right away: the next ones keep their spacing to it
+        srcTimeOffset = now - srcTime;
+        hasSrcTimeOffset = true;
+        return;
+    }
+    int64_t delay = srcTime + srcTimeOffset - now;
+    if (delay <= 0) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    wakeUp.wait_for(lock, std::chrono::microseconds(delay), [this] { return !isRunning; });
+}
+
+bool Bridge::sendToSystem(const char *data, int len) {
+    // A TCP socket might accept a part of the data
+    while (len > 0) {
+        ssize_t res = send(fd, data, len, MSG_NOSIGNAL);
+        if (res < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        counters[SENT_BYTES] += res;
+        data += res;
+        len -= (int) res;
+    }
+    counters[SENT_PACKETS]++;
+    return true;
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <jni.h>
+#include <mutex>
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+#include "srt/srt.h"
+
+/**
+ * Native side of Bridge: a thread that forwards messages between an SRT socket and a plain
+ * UDP or TCP system socket.
+ *
+ * Both sockets are waited for with the same SRT epoll (srt_epoll_add_ssock for the system
+ * socket), so data never goes through the JVM.
+ */
+class Bridge {
+public:
+    /**
+     * Same order as the Java Bridge.Direction.
+     */
+    enum Direction {
+        SRT_TO_UDP = 0,
+        UDP_TO_SRT,
+        SRT_TO_TCP
+    };
+
+    /**
+     * Counters. Same order as the Java Bridge.Counters.
+     */
+    enum Counter {
+        RECEIVED_PACKETS = 0,
+        RECEIVED_BYTES,
+        SENT_PACKETS,
+        SENT_BYTES,
+        DROPPED_PACKETS,
+        COUNTER_COUNT
+    };
+
+    /**
+     * Creates the system socket and starts the bridge thread.
+     *
+     * @param env JNI environment
+     * @param bridge the Java Bridge
+     * @param u the SRT socket
+     * @param direction the forwarding direction
+     * @param address the UDP or TCP destination, or the local UDP address for UDP_TO_SRT
+     * @param addressSize the size of address
+     * @param chunkSize the maximum size of a UDP datagram or of an SRT message sent by the bridge
+     * @param pace if true, messages sent to the system socket keep the spacing of their source
+     * times
+     */
+    Bridge(JNIEnv *env, jobject bridge, SRTSOCKET u, Direction direction,
+           const struct sockaddr_storage *address, int addressSize, int chunkSize, bool pace);
+
+    /**
+     * Stops the bridge thread and closes the system socket. The SRT socket is not closed.
+     * Use release() once the bridge thread has been created.
+     */
+    ~Bridge();
+
+    /**
+     * Stops the bridge thread and deletes the bridge. If it is called from a bridge callback, the
+     * bridge thread deletes the bridge once the callback has returned.
+     */
+    void release();
+
+    /**
+     * @return true if the bridge thread has been created
+     */
+    bool isValid() const;
+
+    /**
+     * @return the local port of the system socket
+     */
+    int getLocalPort() const;
+
+    /**
+     * @param counters where the COUNTER_COUNT counters are written to
+     */
+    void getCounters(jlong *counters) const;
+
+private:
+    JavaVM *vm = nullptr;
+    jobject bridge = nullptr;
+    SRTSOCKET u;
+    Direction direction;
+    int chunkSize;
+    bool pace;
+    SYSSOCKET fd = -1;
+    int eid = SRT_ERROR;
+    std::vector<char> buffer;
+    pthread_t thread;
+    bool hasThread = false;
+    std::atomic<bool> isRunning;
+    // Only accessed by the bridge thread
+    bool isReleasedByThread = false;
+    bool hasSrcTimeOffset = false;
+    int64_t srcTimeOffset = 0;
+    std::atomic<int64_t> counters[COUNTER_COUNT];
+
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+
+    bool open(const struct sockaddr_storage *address, int addressSize);
+
+    static void *run(void *opaque);
+
+    void loop(JNIEnv *env);
+
+    /**
+     * @return the reason that stopped the bridge, empty if it has been stopped by the destructor
+     */
+    std::string forward();
+
+    /**
+     * @return an error reason, empty on success
+     */
+    std::string srtToSystem();
+
+    /**
+     * @return an error reason, empty on success
+     */
+    std::string udpToSrt();
+
+    /**
+     * Waits until the time elapsed since the first paced message matches the source time elapsed
+     * since it. Returns early if the bridge is stopped.
+     */
+    void waitFor(int64_t srcTime);
+
+    /**
+     * @return false if the system socket is broken
+     */
+    bool sendToSystem(const char *data, int len);
+};
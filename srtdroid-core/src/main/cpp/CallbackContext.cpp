@@ -13,15 +13,25 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
-#include "Models/Models.h"
+#include <pthread.h>
+
 #include "CallbackContext.h"
+#include "log.h"
+
+static pthread_key_t envKey;
+static pthread_once_t envKeyOnce = PTHREAD_ONCE_INIT;
+
+static void detachThread(void *vm) {
+    static_cast<JavaVM *>(vm)->DetachCurrentThread();
+}
 
+static void createEnvKey() {
+    pthread_key_create(&envKey, detachThread);
+}
 
-CallbackContext::CallbackContext(JNIEnv *env, jobject callingSocket) {
+CallbackContext::CallbackContext(JNIEnv *env, SRTSOCKET u, jobject callingSocket) : u(u) {
     env->GetJavaVM(&(this->vm));
 
-    this->sockAddrClazz = static_cast<jclass>(env->NewGlobalRef(
-            env->FindClass(INETSOCKETADDRESS_CLASS)));
     this->callingSocket = env->NewGlobalRef(callingSocket);
 }
 
@@ -31,7 +41,34 @@ CallbackContext::~CallbackContext() {
     vm->GetEnv((void **) &env, JNI_VERSION_1_6);
     if (env != nullptr) {
         env->DeleteGlobalRef(this->callingSocket);
-        env->DeleteGlobalRef(this->sockAddrClazz);
     }
 }
 
+
+JNIEnv *CallbackContext::getEnv() {
+    JNIEnv *env = nullptr;
+    jint res = vm->GetEnv((void **) &env, JNI_VERSION_1_6);
+    if (res == JNI_OK) {
+        return env;
+    }
+    if (res != JNI_EDETACHED) {
+        LOGE("Failed to get env");
+        return nullptr;
+    }
+
+    JavaVMAttachArgs args = {JNI_VERSION_1_6, "SrtCallback", nullptr};
+    if (vm->AttachCurrentThread(&env, &args) != JNI_OK) {
+        LOGE("Failed to attach current thread");
+        return nullptr;
+    }
+
+    // Detach when the thread exits
+    pthread_once(&envKeyOnce, createEnvKey);
+    pthread_setspecific(envKey, vm);
+
+    return env;
+}
+
+void CallbackContext::release(void *cbCtx) {
+    delete static_cast<CallbackContext *>(cbCtx);
+}
@@ -17,20 +17,40 @@
 
 #include <jni.h>
 
+#include "srt/srt.h"
+
 class CallbackContext {
 public:
     JavaVM *vm;
+    SRTSOCKET u;
     jobject callingSocket;
-    jclass sockAddrClazz;
 
 
     /**
-     * Initializes a CallbackContext. It purpores is to be pass as an opaque pointer for SRT callback.
+     * Initializes a CallbackContext. It is owned by the SocketRegistry and looked up by SRT
+     * callbacks from the socket id they get as opaque.
      *
      * @param env JNI environment
+     * @param u the SRT socket that registers the callback
+     * @param callingSocket the Java SrtSocket of u
      * @return a CallbackContext structure
      */
-    CallbackContext(JNIEnv *env, jobject callingSocket);
+    CallbackContext(JNIEnv *env, SRTSOCKET u, jobject callingSocket);
 
     ~CallbackContext();
+
+    /**
+     * Gets the JNI environment of the current thread.
+     *
+     * SRT threads are attached on their first callback and stay attached until they exit, so
+     * bursts of handshakes do not pay an attach/detach round trip each.
+     *
+     * @return the JNI environment or null if the thread can't be attached
+     */
+    JNIEnv *getEnv();
+
+    /**
+     * Deletes a CallbackContext. Suitable as a SocketRegistry user data deleter.
+     */
+    static void release(void *cbCtx);
 };
\ No newline at end of file
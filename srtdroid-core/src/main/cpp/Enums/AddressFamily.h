@@ -20,6 +20,7 @@ using namespace std;
 
 class AddressFamily {
 public:
+    inline static const char *clazzIdentifier = "java/net/StandardProtocolFamily";
     inline static int fallbackError = -EIO;
     inline static map<string, int> map = {{"INET",  AF_INET},
                                           {"INET6", AF_INET6}};
@@ -16,75 +16,94 @@
 #pragma once
 
 #include <jni.h>
+#include <map>
 #include <string>
-#include "Bimap.h"
+#include <unordered_map>
+#include <vector>
 #include "../log.h"
 #include <cerrno>
 
 using namespace std;
 
+/**
+ * Converts a Java enum to its native value and back.
+ *
+ * Tables are built once from the Java enum constants: Java to native is indexed by the enum
+ * ordinal and native to Java returns a cached reference to the enum constant. Java and native
+ * enum orders do not have to match.
+ *
+ * The ordinal is read with the public Enum.ordinal() method: the java.lang.Enum field is a
+ * non-SDK interface on Android.
+ */
 template<typename ValueType>
 class EnumConverter {
 private:
-    Bimap<string, ValueType> biMap;
     ValueType defaultError;
     const char *clazzIdentifier;
-    const char *clazzSignature;
-    jclass clazz;
+    jclass clazz = nullptr;
+    jmethodID ordinalMethod = nullptr;
+    vector<ValueType> nativeValues; // Indexed by Java ordinal
+    vector<jobject> javaValues; // Indexed by Java ordinal
+    unordered_map<ValueType, jobject> javaValueByNative;
     JavaVM *vm;
 
-    const char *getJavaFieldName(JNIEnv *env, jobject enumValue) {
-        if (!clazz) {
-            LOGE("Can't get enum class for %s", clazzIdentifier);
-            return nullptr;
+    void populatesTables(JNIEnv *env, map<string, ValueType> map) {
+        string valuesSignature = string("()[L") + clazzIdentifier + ";";
+        jmethodID valuesMethod = env->GetStaticMethodID(clazz, "values", valuesSignature.c_str());
+        jmethodID nameMethod = env->GetMethodID(clazz, "name", "()Ljava/lang/String;");
+        ordinalMethod = env->GetMethodID(clazz, "ordinal", "()I");
+        if (!valuesMethod || !nameMethod || !ordinalMethod) {
+            LOGE("Can't get enum methods for %s", clazzIdentifier);
+            env->ExceptionClear();
+            ordinalMethod = nullptr;
+            return;
         }
 
-        jmethodID enumNameMethod = env->GetMethodID(clazz, "name", "()Ljava/lang/String;");
-        if (!enumNameMethod) {
-            LOGE("Can't get enum name method");
-            return nullptr;
+        auto values = (jobjectArray) env->CallStaticObjectMethod(clazz, valuesMethod);
+        jsize nValues = env->GetArrayLength(values);
+        nativeValues.assign(nValues, defaultError);
+        javaValues.assign(nValues, nullptr);
+
+        for (jsize ordinal = 0; ordinal < nValues; ordinal++) {
+            jobject enumValue = env->GetObjectArrayElement(values, ordinal);
+            auto enumName = (jstring) env->CallObjectMethod(enumValue, nameMethod);
+            const char *enum_name = env->GetStringUTFChars(enumName, nullptr);
+
+            javaValues[ordinal] = env->NewGlobalRef(enumValue);
+            auto it = map.find(enum_name);
+            if (it != map.end()) {
+                nativeValues[ordinal] = it->second;
+                // Keep the first Java constant if several share the same native value
+                javaValueByNative.emplace(it->second, javaValues[ordinal]);
+            } else {
+                LOGE("No native value for %s.%s", clazzIdentifier, enum_name);
+            }
+
+            env->ReleaseStringUTFChars(enumName, enum_name);
+            env->DeleteLocalRef(enumName);
+            env->DeleteLocalRef(enumValue);
         }
 
-
-        auto enumField = (jstring) env->CallObjectMethod(enumValue, enumNameMethod);
-        if (!enumField) {
-            LOGE("Can't get Java enum field");
-            return nullptr;
-        }
-
-        const char *enum_field = env->GetStringUTFChars(enumField, nullptr);
-        if (!enum_field) {
-            LOGE("Can't get native enum field");
-            return nullptr;
-        }
-
-        const char *dup_enum_field = strdup(enum_field);
-
-        env->ReleaseStringUTFChars(enumField, enum_field);
-
-        return dup_enum_field;
-    }
-
-    void populatesBimap(map<string, ValueType> map) {
-        for (const auto &pair : map) {
-            biMap.set(pair.first, pair.second);
-        }
+        env->DeleteLocalRef(values);
     }
 
 public:
     EnumConverter(JNIEnv *env, map<string, ValueType> map, ValueType fallbackError,
-            const char *clazzIdentifier) : EnumConverter(map, fallbackError) {
-        this->clazz = static_cast<jclass>(env->NewGlobalRef(env->FindClass(clazzIdentifier)));
+                  const char *clazzIdentifier) {
         env->GetJavaVM(&(this->vm));
-
+        this->defaultError = fallbackError;
         this->clazzIdentifier = clazzIdentifier;
-        this->clazzSignature = (char *) malloc(strlen(clazzIdentifier) + 3);
-        sprintf((char *) this->clazzSignature, "L%s;", clazzIdentifier);
-    }
 
-    EnumConverter(map <string, ValueType> map, ValueType fallbackError) {
-        populatesBimap(map);
-        this->defaultError = fallbackError;
+        jclass localClazz = env->FindClass(clazzIdentifier);
+        if (!localClazz) {
+            LOGE("Can't find %s class", clazzIdentifier);
+            env->ExceptionClear();
+            return;
+        }
+        this->clazz = static_cast<jclass>(env->NewGlobalRef(localClazz));
+        env->DeleteLocalRef(localClazz);
+
+        populatesTables(env, map);
     }
 
     ~EnumConverter() {
@@ -92,42 +111,40 @@ public:
 
         vm->GetEnv((void **) &env, JNI_VERSION_1_6);
         if (env != nullptr) {
-            env->DeleteGlobalRef(this->clazz);
-        }
-        if (this->clazzSignature) {
-            free((void *) this->clazzSignature);
+            for (jobject javaValue: javaValues) {
+                if (javaValue) {
+                    env->DeleteGlobalRef(javaValue);
+                }
+            }
+            if (this->clazz) {
+                env->DeleteGlobalRef(this->clazz);
+            }
         }
     }
 
     ValueType getNativeValue(JNIEnv *env, const jobject object) {
-        const char *field_name = getJavaFieldName(env, object);
-        if (!field_name) {
+        if (!ordinalMethod || !object) {
             LOGE("Can't get Java field for %s", clazzIdentifier);
             return defaultError;
         }
 
-        auto value = biMap.valueForKey(field_name);
-        free((void *) field_name);
+        jint ordinal = env->CallIntMethod(object, ordinalMethod);
+        if ((ordinal < 0) || (ordinal >= (jint) nativeValues.size())) {
+            LOGE("Unknown ordinal %d for %s", ordinal, clazzIdentifier);
+            return defaultError;
+        }
 
-        return value;
+        return nativeValues[ordinal];
     }
 
     jobject getJavaValue(JNIEnv *env, const ValueType value) {
-        if (!clazz) {
-            LOGE("Can't get %s class", clazzIdentifier);
-            return nullptr;
-        }
-
-        auto fieldName = biMap.keysForValue(value).begin();
-        jfieldID enumField = env->GetStaticFieldID(clazz, fieldName->c_str(),
-                clazzSignature);
-        if (!enumField) {
+        auto it = javaValueByNative.find(value);
+        if (it == javaValueByNative.end()) {
             LOGE("Can't get field for %s", clazzIdentifier);
             return nullptr;
         }
 
-        jobject object = env->GetStaticObjectField(clazz, enumField);
-
-        return object;
+        // Callers own a local reference, as with GetStaticObjectField
+        return env->NewLocalRef(it->second);
     }
 };
@@ -30,7 +30,9 @@
 class EnumsSingleton {
 private:
     EnumsSingleton(JNIEnv *env) {
-        addressFamily = new EnumConverter<int>(AddressFamily::map, AddressFamily::fallbackError);
+        addressFamily = new EnumConverter<int>(env, AddressFamily::map,
+                                               AddressFamily::fallbackError,
+                                               AddressFamily::clazzIdentifier);
         boundary = new EnumConverter<int>(env, Boundary::map, Boundary::fallbackError,
                                           Boundary::clazzIdentifier);
         epollFlag = new EnumConverter<int>(env, EpollFlag::map, EpollFlag::fallbackError,
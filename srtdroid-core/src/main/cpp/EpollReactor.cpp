@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <vector>
+
+#include "EpollReactor.h"
+#include "log.h"
+#include "Models/ModelsSingleton.h"
+
+
+EpollReactor::EpollReactor(JNIEnv *env, jobject reactor, jobject events, int maxEvents,
+                           int timeoutInMs) : maxEvents(maxEvents), timeoutInMs(timeoutInMs),
+                                              isRunning(false) {
+    env->GetJavaVM(&(this->vm));
+
+    this->events = (jint *) env->GetDirectBufferAddress(events);
+    if ((this->events == nullptr) ||
+        (env->GetDirectBufferCapacity(events) < 2 * (jlong) maxEvents)) {
+        LOGE("Invalid reactor event buffer");
+        return;
+    }
+
+    this->eid = srt_epoll_create();
+    if (this->eid < 0) {
+        LOGE("Can't create reactor epoll");
+        return;
+    }
+    // Waiting on an empty container is not an error for a reactor
+    srt_epoll_set(this->eid, SRT_EPOLL_ENABLE_EMPTY);
+
+    this->reactor = env->NewGlobalRef(reactor);
+
+    isRunning = true;
+    if (pthread_create(&thread, nullptr, EpollReactor::run, this) != 0) {
+        LOGE("Can't create reactor thread");
+        isRunning = false;
+        return;
+    }
+    hasThread = true;
+}
+
+EpollReactor::~EpollReactor() {
+    isRunning = false;
+    if (hasThread) {
+        if (pthread_equal(pthread_self(), thread)) {
+            // Deleted by the reactor thread itself, see run()
+            pthread_detach(thread);
+        } else {
+            pthread_join(thread, nullptr);
+        }
+    }
+
+    if (eid >= 0) {
+        srt_epoll_release(eid);
+    }
+
+    JNIEnv *env = nullptr;
+    vm->GetEnv((void **) &env, JNI_VERSION_1_6);
+    if ((env != nullptr) && (reactor != nullptr)) {
+        env->DeleteGlobalRef(reactor);
+    }
+}
+
+void EpollReactor::release() {
+    isRunning = false;
+    if (hasThread && pthread_equal(pthread_self(), thread)) {
+        // Released from a reactor callback: loop() still uses the reactor
+        isReleasedByThread = true;
+        return;
+    }
+    delete this;
+}
+
+bool EpollReactor::isValid() const {
+    return hasThread;
+}
+
+int EpollReactor::add(SRTSOCKET u, int events) {
+    return srt_epoll_add_usock(eid, u, &events);
+}
+
+int EpollReactor::update(SRTSOCKET u, int events) {
+    return srt_epoll_update_usock(eid, u, &events);
+}
+
+int EpollReactor::remove(SRTSOCKET u) {
+    return srt_epoll_remove_usock(eid, u);
+}
+
+void *EpollReactor::run(void *opaque) {
+    auto *epollReactor = static_cast<EpollReactor *>(opaque);
+    JNIEnv *env = nullptr;
+
+    JavaVMAttachArgs args = {JNI_VERSION_1_6, "SrtEpollReactor", nullptr};
+    if (epollReactor->vm->AttachCurrentThread(&env, &args) != JNI_OK) {
+        LOGE("Can't attach reactor thread");
+        return nullptr;
+    }
+
+    epollReactor->loop(env);
+
+    JavaVM *vm = epollReactor->vm;
+    if (epollReactor->isReleasedByThread) {
+        delete epollReactor;
+    }
+    vm->DetachCurrentThread();
+    return nullptr;
+}
+
+void EpollReactor::loop(JNIEnv *env) {
+    jmethodID onEventsMethod = ModelsSingleton::getInstance(env)->epollReactorOnEventsMethod;
+    jmethodID onFailedMethod = ModelsSingleton::getInstance(env)->epollReactorOnFailedMethod;
+    std::vector<SRT_EPOLL_EVENT> epoll_events(maxEvents);
+
+    while (isRunning) {
+        int res = srt_epoll_uwait(eid, epoll_events.data(), maxEvents, timeoutInMs);
+        if (res < 0) {
+            if (srt_getlasterror(nullptr) == SRT_ETIMEOUT) {
+                continue;
+            }
+            // Waiters would never be resumed: report the failure to the Java reactor
+            LOGE("Reactor wait failed: %s", srt_getlasterror_str());
+            jstring message = env->NewStringUTF(srt_getlasterror_str());
+            env->CallVoidMethod(reactor, onFailedMethod, message);
+            if (env->ExceptionCheck()) {
+                LOGE("Exception in reactor callback");
+                env->ExceptionDescribe();
+                env->ExceptionClear();
+            }
+            env->DeleteLocalRef(message);
+            break;
+        }
+        if ((res == 0) || !isRunning) {
+            continue;
+        }
+
+        // uwait returns the total number of ready sockets, that might be more than maxEvents.
+        int nEvents = res < maxEvents ? res : maxEvents;
+        for (int i = 0; i < nEvents; i++) {
+            events[2 * i] = epoll_events[i].fd;
+            events[2 * i + 1] = epoll_events[i].events;
+        }
+
+        env->CallVoidMethod(reactor, onEventsMethod, nEvents);
+        if (env->ExceptionCheck()) {
+            LOGE("Exception in reactor callback");
+            env->ExceptionDescribe();
+            env->ExceptionClear();
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <jni.h>
+#include <pthread.h>
+
+#include "srt/srt.h"
+
+/**
+ * Native side of EpollReactor: a long-lived thread that waits on a single SRT epoll container and
+ * reports ready sockets to the Java reactor.
+ *
+ * Ready sockets are written as (socket, events) pairs into a direct buffer shared with the Java
+ * reactor, then the Java reactor is notified once per wake up.
+ */
+class EpollReactor {
+public:
+    /**
+     * Creates the SRT epoll container and starts the reactor thread.
+     *
+     * @param env JNI environment
+     * @param reactor the Java EpollReactor
+     * @param events a direct buffer of at least 2 * maxEvents ints
+     * @param maxEvents maximum number of events reported per wake up
+     * @param timeoutInMs wait timeout. Also bounds the time to stop the reactor.
+     */
+    EpollReactor(JNIEnv *env, jobject reactor, jobject events, int maxEvents, int timeoutInMs);
+
+    /**
+     * Stops the reactor thread and releases the SRT epoll container.
+     * Use release() once the reactor thread has been created.
+     */
+    ~EpollReactor();
+
+    /**
+     * Stops the reactor thread and deletes the reactor. If it is called from a reactor callback,
+     * the reactor thread deletes the reactor once the callback has returned.
+     */
+    void release();
+
+    /**
+     * @return true if the epoll container and the reactor thread have been created
+     */
+    bool isValid() const;
+
+    int add(SRTSOCKET u, int events);
+
+    int update(SRTSOCKET u, int events);
+
+    int remove(SRTSOCKET u);
+
+private:
+    JavaVM *vm = nullptr;
+    jobject reactor = nullptr;
+    jint *events = nullptr;
+    int maxEvents;
+    int timeoutInMs;
+    int eid = -1;
+    pthread_t thread;
+    bool hasThread = false;
+    std::atomic<bool> isRunning;
+    // Only accessed by the reactor thread
+    bool isReleasedByThread = false;
+
+    static void *run(void *opaque);
+
+    void loop(JNIEnv *env);
+};
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "FanOutGroup.h"
+
+#include <algorithm>
+
+bool FanOutGroup::add(SRTSOCKET u) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto &member: members) {
+        if (member.u == u) {
+            return false;
+        }
+    }
+    members.push_back({u, {0}});
+    return true;
+}
+
+bool FanOutGroup::remove(SRTSOCKET u) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = std::find_if(members.begin(), members.end(),
+                           [u](const Member &member) { return member.u == u; });
+    if (it == members.end()) {
+        return false;
+    }
+    members.erase(it);
+    return true;
+}
+
+int FanOutGroup::send(const char *data, int len, const SRT_MSGCTRL *msgctrl,
+                      std::vector<Eviction> &evictions, int *nMembers) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (nMembers != nullptr) {
+        *nMembers = (int) members.size();
+    }
+    int nSent = 0;
+    for (auto it = members.begin(); it != members.end();) {
+        // Each member writes its own message number
+        SRT_MSGCTRL memberMsgctrl = (msgctrl != nullptr) ? *msgctrl : srt_msgctrl_default;
+        int res = srt_sendmsg2(it->u, data, len, &memberMsgctrl);
+        if (res > 0) {
+            it->counters[SENT_PACKETS]++;
+            it->counters[SENT_BYTES] += res;
+            nSent++;
+            ++it;
+            continue;
+        }
+
+        int error = srt_getlasterror(nullptr);
+        if (isBroken(error)) {
+            evictions.push_back({it->u, error});
+            it = members.erase(it);
+        } else {
+            it->counters[DROPPED_PACKETS]++;
+            ++it;
+        }
+    }
+
+    return nSent;
+}
+
+bool FanOutGroup::getCounters(SRTSOCKET u, jlong *counters) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto &member: members) {
+        if (member.u == u) {
+            for (int i = 0; i < COUNTER_COUNT; i++) {
+                counters[i] = member.counters[i];
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FanOutGroup::isBroken(int error) {
+    switch (error) {
+        case SRT_ECONNLOST:
+        case SRT_ENOCONN:
+        case SRT_EINVSOCK:
+        case SRT_ESCLOSED:
+        case SRT_ECONNFAIL:
+            return true;
+        default:
+            return false;
+    }
+}
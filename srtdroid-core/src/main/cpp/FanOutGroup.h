@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <jni.h>
+#include <mutex>
+#include <vector>
+
+#include "srt/srt.h"
+
+/**
+ * Native side of FanOutGroup: sends each message to every member socket with srt_sendmsg2.
+ *
+ * A member that fails to send only drops the message. A member whose connection is broken is
+ * evicted.
+ */
+class FanOutGroup {
+public:
+    /**
+     * Member counters. Same order as the Java FanOutGroup.Counters.
+     */
+    enum Counter {
+        SENT_PACKETS = 0,
+        SENT_BYTES,
+        DROPPED_PACKETS,
+        COUNTER_COUNT
+    };
+
+    struct Eviction {
+        SRTSOCKET u;
+        int error;
+    };
+
+    /**
+     * @return false if the socket is already a member
+     */
+    bool add(SRTSOCKET u);
+
+    /**
+     * @return false if the socket is not a member
+     */
+    bool remove(SRTSOCKET u);
+
+    /**
+     * Sends a message to every member.
+     *
+     * @param data the message
+     * @param len the size of the message
+     * @param msgctrl the message parameters or nullptr for defaults
+     * @param evictions where the members evicted by this call are appended to
+     * @param nMembers if not nullptr, where the number of members at the time of the call is
+     * written to
+     * @return the number of members that have accepted the message
+     */
+    int send(const char *data, int len, const SRT_MSGCTRL *msgctrl,
+             std::vector<Eviction> &evictions, int *nMembers = nullptr);
+
+    /**
+     * @param u a member
+     * @param counters where the COUNTER_COUNT counters of the member are written to
+     * @return false if the socket is not a member
+     */
+    bool getCounters(SRTSOCKET u, jlong *counters);
+
+private:
+    struct Member {
+        SRTSOCKET u;
+        int64_t counters[COUNTER_COUNT];
+    };
+
+    std::mutex mutex;
+    std::vector<Member> members;
+
+    /**
+     * @return true if the member connection can't recover from the error
+     */
+    static bool isBroken(int error);
+};
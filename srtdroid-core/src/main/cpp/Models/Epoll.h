@@ -16,67 +16,21 @@
 #pragma once
 
 #include "Models.h"
+#include "ModelsSingleton.h"
 
 class Epoll {
 public:
     static int getNative(JNIEnv *env, jobject epoll) {
-        jclass epollClazz = env->GetObjectClass(epoll);
-        if (!epollClazz) {
-            LOGE("Can't get Epoll class");
-            return -1;
-        }
-
-        jfieldID eidField = env->GetFieldID(epollClazz, "eid", "I");
-        if (!eidField) {
-            LOGE("Can't get eid field");
-            env->DeleteLocalRef(epollClazz);
-            return -1;
-        }
-
-        jint eid = env->GetIntField(epoll, eidField);
-
-        env->DeleteLocalRef(epollClazz);
-
-        return eid;
+        return env->GetIntField(epoll, ModelsSingleton::getInstance(env)->epollEidField);
     }
 
     static jobject getJava(JNIEnv *env, int eid) {
-        jclass epollClazz = env->FindClass(EPOLL_CLASS);
-        if (!epollClazz) {
-            LOGE("Can't find Epoll class");
-            return nullptr;
-        }
-
-        jmethodID epollConstructorMethod = env->GetMethodID(epollClazz, "<init>", "()V");
-        if (!epollConstructorMethod) {
-            LOGE("Can't get Epoll constructor");
-            env->DeleteLocalRef(epollClazz);
-            return nullptr;
-        }
+        ModelsSingleton *models = ModelsSingleton::getInstance(env);
 
-        jobject epoll = env->NewObject(epollClazz, epollConstructorMethod, eid);
-
-        env->DeleteLocalRef(epollClazz);
-
-        return epoll;
+        return env->NewObject(models->epollClazz, models->epollConstructorMethod, eid);
     }
 
     static void setJava(JNIEnv *env, jobject epoll, int eid) {
-        jclass epollClazz = env->GetObjectClass(epoll);
-        if (!epollClazz) {
-            LOGE("Can't get Epoll class");
-            return;
-        }
-
-        jfieldID eidField = env->GetFieldID(epollClazz, "eid", "I");
-        if (!eidField) {
-            LOGE("Can't get eid field");
-            env->DeleteLocalRef(epollClazz);
-            return;
-        }
-
-        env->SetIntField(epoll, eidField, eid);
-
-        env->DeleteLocalRef(epollClazz);
+        env->SetIntField(epoll, ModelsSingleton::getInstance(env)->epollEidField, eid);
     }
-};
\ No newline at end of file
+};
@@ -16,62 +16,37 @@
 #pragma once
 
 #include "Models.h"
+#include "ModelsSingleton.h"
 
 class EpollEvent {
 public:
     static SRT_EPOLL_EVENT *getNative(JNIEnv *env, jobject epollEvent, SRT_EPOLL_EVENT *srt_event) {
-        jclass epollEventClazz = env->GetObjectClass(epollEvent);
-        if (!epollEventClazz) {
-            LOGE("Can't get EpollEvent class");
-            return nullptr;
-        }
+        ModelsSingleton *models = ModelsSingleton::getInstance(env);
 
-        jfieldID
-                socketField = env->GetFieldID(epollEventClazz, "socket", "L"
-                                                                         SRTSOCKET_CLASS
-                                                                         ";");
-        if (!socketField) {
-            LOGE("Can't get Socket field");
-            env->DeleteLocalRef(epollEventClazz);
-            return nullptr;
-        }
-        jobject srtSocket = env->GetObjectField(epollEvent, socketField);
+        jobject srtSocket = env->GetObjectField(epollEvent, models->epollEventSocketField);
         srt_event->fd = Socket::getNative(env, srtSocket);
+        env->DeleteLocalRef(srtSocket);
 
-        jfieldID
-                epollOptsField = env->GetFieldID(epollEventClazz, "events", "L" LIST_CLASS ";");
-        if (!epollOptsField) {
-            LOGE("Can't get events field");
-            env->DeleteLocalRef(epollEventClazz);
-            return nullptr;
-        }
-        jobject epollOpts = static_cast<jobjectArray>(env->GetObjectField(epollEvent,
-                                                                          epollOptsField));
+        jobject epollOpts = env->GetObjectField(epollEvent, models->epollEventEventsField);
         srt_event->events = EpollOpts::getNative(env, epollOpts);
-
-        env->DeleteLocalRef(epollEventClazz);
+        env->DeleteLocalRef(epollOpts);
 
         return srt_event;
     }
 
     static jobject getJava(JNIEnv *env, SRT_EPOLL_EVENT epoll_event) {
-        jclass clazz = env->FindClass(EPOLLEVENT_CLASS);
-        if (!clazz) {
-            LOGE("Can't get EpollEvent class");
-            return nullptr;
-        }
-
-        jmethodID constructor = env->GetMethodID(clazz, "<init>", "(L" SRTSOCKET_CLASS ";L" LIST_CLASS ";)V");
-        if (!constructor) {
-            LOGE("Can't get EpollEvent constructor");
-            return nullptr;
-        }
+        ModelsSingleton *models = ModelsSingleton::getInstance(env);
 
         jobject srtSocket = Socket::getJava(env, epoll_event.fd);
         jobject jevents = EpollOpts::getJava(env, epoll_event.events);
 
-        jobject epollEvent = env->NewObject(clazz, constructor, srtSocket, jevents);
+        jobject epollEvent = env->NewObject(models->epollEventClazz,
+                                            models->epollEventConstructorMethod, srtSocket,
+                                            jevents);
+
+        env->DeleteLocalRef(srtSocket);
+        env->DeleteLocalRef(jevents);
 
         return epollEvent;
     }
-};
\ No newline at end of file
+};
@@ -35,16 +35,9 @@ public:
         int max = SRT_EPOLL_ENABLE_OUTPUTCHECK;
         int epoll_flag;
 
-        jclass epollFlagClazz = env->FindClass(EPOLLFLAG_CLASS);
-        if (!epollFlagClazz) {
-            LOGE("Can't find EpollFlag class");
-            return nullptr;
-        }
-
         jobject epollFlagList = List::newJavaList(env);
         if (!epollFlagList) {
             LOGE("Can't create EpollFlag List");
-            env->DeleteLocalRef(epollFlagClazz);
             return nullptr;
         }
 
@@ -61,8 +54,6 @@ public:
             }
         }
 
-        env->DeleteLocalRef(epollFlagClazz);
-
         return epollFlagList;
     }
 };
\ No newline at end of file
@@ -15,76 +15,33 @@
  */
 #pragma once
 
+#include "ModelsSingleton.h"
+
 class InetSocketAddress {
 public:
     static struct sockaddr_storage *
     getNative(JNIEnv *env, jobject inetSocketAddress, int *size) {
-        // Get InetSocketAddress class
-        jclass inetSocketAddressClazz = env->GetObjectClass(inetSocketAddress);
-        if (!inetSocketAddressClazz) {
-            LOGE("Can't get InetSocketAddress class");
-            return nullptr;
-        }
+        ModelsSingleton *models = ModelsSingleton::getInstance(env);
 
         // Port
-        jmethodID inetSocketAddressGetPortMethod = env->GetMethodID(inetSocketAddressClazz,
-                                                                    "getPort",
-                                                                    "()I");
-        if (!inetSocketAddressGetPortMethod) {
-            LOGE("Can't get getPort method");
-            env->DeleteLocalRef(inetSocketAddressClazz);
-            return nullptr;
-        }
-        int port = env->CallIntMethod(inetSocketAddress, inetSocketAddressGetPortMethod);
+        int port = env->CallIntMethod(inetSocketAddress, models->inetSocketAddressGetPortMethod);
 
         // Hostname
-        jmethodID inetSocketAddressGetAddressMethod = env->GetMethodID(inetSocketAddressClazz,
-                                                                       "getAddress",
-                                                                       "()Ljava/net/InetAddress;");
-        if (!inetSocketAddressGetAddressMethod) {
-            LOGE("Can't get getAddress method");
-            env->DeleteLocalRef(inetSocketAddressClazz);
-            return nullptr;
-        }
-
         jobject inetAddress = env->CallObjectMethod(inetSocketAddress,
-                                                    inetSocketAddressGetAddressMethod);
+                                                    models->inetSocketAddressGetAddressMethod);
         if (!inetAddress) {
             LOGE("Can't get InetAddress");
-            env->DeleteLocalRef(inetSocketAddressClazz);
-            return nullptr;
-        }
-
-        // Get InetAddress class
-        jclass inetAddressClazz = env->GetObjectClass(inetAddress);
-        if (!inetAddressClazz) {
-            LOGE("Can't get InetSocketAddress class");
-            env->DeleteLocalRef(inetSocketAddressClazz);
-            return nullptr;
-        }
-
-        jmethodID inetAddressGetHostAddressMethod = env->GetMethodID(inetAddressClazz,
-                                                                     "getHostAddress",
-                                                                     "()Ljava/lang/String;");
-        if (!inetAddressGetHostAddressMethod) {
-            LOGE("Can't get getHostAddress method");
-            env->DeleteLocalRef(inetSocketAddressClazz);
-            env->DeleteLocalRef(inetAddressClazz);
             return nullptr;
         }
 
         auto hostName = (jstring) env->CallObjectMethod(inetAddress,
-                                                        inetAddressGetHostAddressMethod);
+                                                        models->inetAddressGetHostAddressMethod);
+        env->DeleteLocalRef(inetAddress);
         if (!hostName) {
             LOGE("Can't get Hostname");
-            env->DeleteLocalRef(inetSocketAddressClazz);
-            env->DeleteLocalRef(inetAddressClazz);
             return nullptr;
         }
 
-        env->DeleteLocalRef(inetSocketAddressClazz);
-        env->DeleteLocalRef(inetAddressClazz);
-
         const char *hostname = env->GetStringUTFChars(hostName, nullptr);
 
         // Get hostname type: IPv4 or IPv6
@@ -115,37 +72,17 @@ public:
         freeaddrinfo(ai);
 
         env->ReleaseStringUTFChars(hostName, hostname);
+        env->DeleteLocalRef(hostName);
 
         return ss;
     }
 
     static jobject
     getJava(JNIEnv *env, struct sockaddr_storage *ss) {
-        jclass inetSocketAddressClazz = env->FindClass(INETSOCKETADDRESS_CLASS);
-        jobject inetSocketAddress = getJava(env, inetSocketAddressClazz, ss);
-        env->DeleteLocalRef(inetSocketAddressClazz);
-        return inetSocketAddress;
-    }
-
-    static jobject
-    getJava(JNIEnv *env, jclass clazz, struct sockaddr_storage *ss) {
         if (ss == nullptr) {
             return nullptr;
         }
 
-        if (!clazz) {
-            LOGE("Can't get InetSocketAddress class");
-            return nullptr;
-        }
-
-        jmethodID inetSocketAddressConstructorMethod = env->GetMethodID(clazz,
-                                                                        "<init>",
-                                                                        "(Ljava/lang/String;I)V");
-        if (!inetSocketAddressConstructorMethod) {
-            LOGE("Can't get InetSocketAddress constructor");
-            return nullptr;
-        }
-
         char ip[INET6_ADDRSTRLEN] = {0};
         int port = 0;
         if (ss->ss_family == AF_INET) {
@@ -166,10 +103,13 @@ public:
             LOGE("Unknown socket family %d", ss->ss_family);
         }
 
+        ModelsSingleton *models = ModelsSingleton::getInstance(env);
+
         jstring hostName = env->NewStringUTF(ip);
-        jobject inetSocketAddress = env->NewObject(clazz,
-                                                   inetSocketAddressConstructorMethod, hostName,
-                                                   (jint) port);
+        jobject inetSocketAddress = env->NewObject(models->inetSocketAddressClazz,
+                                                   models->inetSocketAddressConstructorMethod,
+                                                   hostName, (jint) port);
+        env->DeleteLocalRef(hostName);
 
         return inetSocketAddress;
     }
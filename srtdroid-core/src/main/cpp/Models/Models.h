@@ -16,18 +16,29 @@
 #pragma once
 
 #define INETSOCKETADDRESS_CLASS "java/net/InetSocketAddress"
+#define INETADDRESS_CLASS "java/net/InetAddress"
 #define LONG_CLASS "java/lang/Long"
 #define BOOLEAN_CLASS "java/lang/Boolean"
 #define INT_CLASS "java/lang/Integer"
 #define PAIR_CLASS "android/util/Pair"
 #define LIST_CLASS "java/util/List"
+#define ARRAYLIST_CLASS "java/util/ArrayList"
 
 
 #define ERROR_CLASS "io/github/thibaultbee/srtdroid/core/models/SrtError"
 #define SRT_CLASS "io/github/thibaultbee/srtdroid/core/Srt"
 #define TIME_CLASS "io/github/thibaultbee/srtdroid/core/models/Time"
+#define BRIDGE_CLASS "io/github/thibaultbee/srtdroid/core/models/Bridge"
+#define BITRATECONTROLLER_CLASS "io/github/thibaultbee/srtdroid/core/models/BitrateController"
 #define EPOLL_CLASS "io/github/thibaultbee/srtdroid/core/models/Epoll"
 #define EPOLLEVENT_CLASS "io/github/thibaultbee/srtdroid/core/models/EpollEvent"
+#define EPOLLREACTOR_CLASS "io/github/thibaultbee/srtdroid/core/models/EpollReactor"
+#define FANOUTGROUP_CLASS "io/github/thibaultbee/srtdroid/core/models/FanOutGroup"
 #define MSGCTRL_CLASS "io/github/thibaultbee/srtdroid/core/models/MsgCtrl"
+#define RECVRING_CLASS "io/github/thibaultbee/srtdroid/core/models/RecvRing"
+#define RELAY_CLASS "io/github/thibaultbee/srtdroid/core/models/Relay"
+#define SENDRING_CLASS "io/github/thibaultbee/srtdroid/core/models/SendRing"
 #define SRTSOCKET_CLASS "io/github/thibaultbee/srtdroid/core/models/SrtSocket"
 #define STATS_CLASS "io/github/thibaultbee/srtdroid/core/models/Stats"
+#define STATSCOLUMNS_CLASS "io/github/thibaultbee/srtdroid/core/models/StatsColumns"
+#define STATSSAMPLER_CLASS "io/github/thibaultbee/srtdroid/core/models/StatsSampler"
@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <jni.h>
+
+#include "../log.h"
+#include "../Enums/Enums.h"
+#include "Models.h"
+
+/**
+ * Registry of the Java classes, fields and methods used by the native code.
+ *
+ * Everything is resolved once, from JNI_OnLoad, and classes are pinned with global references so
+ * converters never have to call FindClass, GetFieldID or GetMethodID on the hot path. It must be
+ * created from a thread that can see application classes (callback threads can't).
+ */
+class ModelsSingleton {
+private:
+    bool loaded = true;
+
+    jclass findClass(JNIEnv *env, const char *className) {
+        jclass clazz = env->FindClass(className);
+        if (!clazz) {
+            LOGE("Can't find %s class", className);
+            env->ExceptionClear();
+            loaded = false;
+            return nullptr;
+        }
+
+        auto globalClazz = static_cast<jclass>(env->NewGlobalRef(clazz));
+        env->DeleteLocalRef(clazz);
+
+        return globalClazz;
+    }
+
+    jfieldID getFieldID(JNIEnv *env, jclass clazz, const char *name, const char *signature) {
+        if (!clazz) {
+            return nullptr;
+        }
+
+        jfieldID field = env->GetFieldID(clazz, name, signature);
+        if (!field) {
+            LOGE("Can't get %s field", name);
+            env->ExceptionClear();
+            loaded = false;
+        }
+
+        return field;
+    }
+
+    jmethodID getMethodID(JNIEnv *env, jclass clazz, const char *name, const char *signature) {
+        if (!clazz) {
+            return nullptr;
+        }
+
+        jmethodID method = env->GetMethodID(clazz, name, signature);
+        if (!method) {
+            LOGE("Can't get %s method", name);
+            env->ExceptionClear();
+            loaded = false;
+        }
+
+        return method;
+    }
+
+    ModelsSingleton(JNIEnv *env) {
+        // Java types
+        longClazz = findClass(env, LONG_CLASS);
+        longConstructorMethod = getMethodID(env, longClazz, "<init>", "(J)V");
+        booleanClazz = findClass(env, BOOLEAN_CLASS);
+        booleanConstructorMethod = getMethodID(env, booleanClazz, "<init>", "(Z)V");
+        integerClazz = findClass(env, INT_CLASS);
+        integerConstructorMethod = getMethodID(env, integerClazz, "<init>", "(I)V");
+
+        pairClazz = findClass(env, PAIR_CLASS);
+        pairConstructorMethod = getMethodID(env, pairClazz, "<init>",
+                                            "(Ljava/lang/Object;Ljava/lang/Object;)V");
+
+        listClazz = findClass(env, LIST_CLASS);
+        listSizeMethod = getMethodID(env, listClazz, "size", "()I");
+        listGetMethod = getMethodID(env, listClazz, "get", "(I)Ljava/lang/Object;");
+        listAddMethod = getMethodID(env, listClazz, "add", "(Ljava/lang/Object;)Z");
+        arrayListClazz = findClass(env, ARRAYLIST_CLASS);
+        arrayListConstructorMethod = getMethodID(env, arrayListClazz, "<init>", "()V");
+
+        inetSocketAddressClazz = findClass(env, INETSOCKETADDRESS_CLASS);
+        inetSocketAddressConstructorMethod = getMethodID(env, inetSocketAddressClazz, "<init>",
+                                                         "(Ljava/lang/String;I)V");
+        inetSocketAddressGetPortMethod = getMethodID(env, inetSocketAddressClazz, "getPort",
+                                                     "()I");
+        inetSocketAddressGetAddressMethod = getMethodID(env, inetSocketAddressClazz,
+                                                        "getAddress",
+                                                        "()L" INETADDRESS_CLASS ";");
+        inetAddressClazz = findClass(env, INETADDRESS_CLASS);
+        inetAddressGetHostAddressMethod = getMethodID(env, inetAddressClazz, "getHostAddress",
+                                                      "()Ljava/lang/String;");
+
+        // srtdroid types
+        srtSocketClazz = findClass(env, SRTSOCKET_CLASS);
+        srtSocketField = getFieldID(env, srtSocketClazz, "srtsocket", "I");
+        srtSocketConstructorMethod = getMethodID(env, srtSocketClazz, "<init>", "(I)V");
+        srtSocketOnListenMethod = getMethodID(env, srtSocketClazz, "onListen",
+                                              "(L" SRTSOCKET_CLASS ";IL" INETSOCKETADDRESS_CLASS ";Ljava/lang/String;)I");
+        srtSocketOnConnectMethod = getMethodID(env, srtSocketClazz, "onConnect",
+                                               "(L" SRTSOCKET_CLASS ";L" ERRORTYPE_CLASS ";L" INETSOCKETADDRESS_CLASS ";I)V");
+        srtSocketOnSendBufferWatermarkMethod = getMethodID(env, srtSocketClazz,
+                                                           "onSendBufferWatermark", "(ZJ)V");
+
+        epollClazz = findClass(env, EPOLL_CLASS);
+        epollEidField = getFieldID(env, epollClazz, "eid", "I");
+        epollConstructorMethod = getMethodID(env, epollClazz, "<init>", "(I)V");
+
+        epollEventClazz = findClass(env, EPOLLEVENT_CLASS);
+        epollEventConstructorMethod = getMethodID(env, epollEventClazz, "<init>",
+                                                  "(L" SRTSOCKET_CLASS ";L" LIST_CLASS ";)V");
+        epollEventSocketField = getFieldID(env, epollEventClazz, "socket",
+                                           "L" SRTSOCKET_CLASS ";");
+        epollEventEventsField = getFieldID(env, epollEventClazz, "events", "L" LIST_CLASS ";");
+
+        epollReactorClazz = findClass(env, EPOLLREACTOR_CLASS);
+        epollReactorOnEventsMethod = getMethodID(env, epollReactorClazz, "onEvents", "(I)V");
+        epollReactorOnFailedMethod = getMethodID(env, epollReactorClazz, "onFailed",
+                                                 "(Ljava/lang/String;)V");
+
+        fanOutGroupClazz = findClass(env, FANOUTGROUP_CLASS);
+        fanOutGroupOnEvictedMethod = getMethodID(env, fanOutGroupClazz, "onEvicted",
+                                                 "(IL" ERRORTYPE_CLASS ";)V");
+
+        bridgeClazz = findClass(env, BRIDGE_CLASS);
+        bridgeOnClosedMethod = getMethodID(env, bridgeClazz, "onClosed", "(Ljava/lang/String;)V");
+
+        recvRingClazz = findClass(env, RECVRING_CLASS);
+        recvRingOnAvailableMethod = getMethodID(env, recvRingClazz, "onAvailable", "()V");
+        recvRingOnClosedMethod = getMethodID(env, recvRingClazz, "onClosed",
+                                             "(Ljava/lang/String;)V");
+
+        relayClazz = findClass(env, RELAY_CLASS);
+        relayOnOutputEvictedMethod = getMethodID(env, relayClazz, "onOutputEvicted",
+                                                 "(IL" ERRORTYPE_CLASS ";)V");
+        relayOnInputClosedMethod = getMethodID(env, relayClazz, "onInputClosed",
+                                               "(L" ERRORTYPE_CLASS ";)V");
+
+        statsSamplerClazz = findClass(env, STATSSAMPLER_CLASS);
+        statsSamplerOnThresholdMethod = getMethodID(env, statsSamplerClazz, "onThreshold",
+                                                    "(IIZD)V");
+
+        bitrateControllerClazz = findClass(env, BITRATECONTROLLER_CLASS);
+        bitrateControllerOnTargetBitrateMethod = getMethodID(env, bitrateControllerClazz,
+                                                             "onTargetBitrate", "(J)V");
+
+        statsClazz = findClass(env, STATS_CLASS);
+        statsConstructorMethod = getMethodID(env, statsClazz, "<init>",
+                                             "(JJJIIIIIIIJIIIJJJJJJJJJIIIIIIIIDDJIDJIIIJJJJJJJDIIIDDIIDIIIIIIIIIIIIIIIIIIJJJJJJJJ)V");
+    }
+
+    inline static ModelsSingleton *instance;
+
+public:
+    jclass longClazz;
+    jmethodID longConstructorMethod;
+    jclass booleanClazz;
+    jmethodID booleanConstructorMethod;
+    jclass integerClazz;
+    jmethodID integerConstructorMethod;
+
+    jclass pairClazz;
+    jmethodID pairConstructorMethod;
+
+    jclass listClazz;
+    jmethodID listSizeMethod;
+    jmethodID listGetMethod;
+    jmethodID listAddMethod;
+    jclass arrayListClazz;
+    jmethodID arrayListConstructorMethod;
+
+    jclass inetSocketAddressClazz;
+    jmethodID inetSocketAddressConstructorMethod;
+    jmethodID inetSocketAddressGetPortMethod;
+    jmethodID inetSocketAddressGetAddressMethod;
+    jclass inetAddressClazz;
+    jmethodID inetAddressGetHostAddressMethod;
+
+    jclass srtSocketClazz;
+    jfieldID srtSocketField;
+    jmethodID srtSocketConstructorMethod;
+    jmethodID srtSocketOnListenMethod;
+    jmethodID srtSocketOnConnectMethod;
+    jmethodID srtSocketOnSendBufferWatermarkMethod;
+
+    jclass epollClazz;
+    jfieldID epollEidField;
+    jmethodID epollConstructorMethod;
+
+    jclass epollEventClazz;
+    jmethodID epollEventConstructorMethod;
+    jfieldID epollEventSocketField;
+    jfieldID epollEventEventsField;
+
+    jclass epollReactorClazz;
+    jmethodID epollReactorOnEventsMethod;
+    jmethodID epollReactorOnFailedMethod;
+
+    jclass fanOutGroupClazz;
+    jmethodID fanOutGroupOnEvictedMethod;
+
+    jclass bridgeClazz;
+    jmethodID bridgeOnClosedMethod;
+
+    jclass recvRingClazz;
+    jmethodID recvRingOnAvailableMethod;
+    jmethodID recvRingOnClosedMethod;
+
+    jclass relayClazz;
+    jmethodID relayOnOutputEvictedMethod;
+    jmethodID relayOnInputClosedMethod;
+
+    jclass statsSamplerClazz;
+    jmethodID statsSamplerOnThresholdMethod;
+
+    jclass bitrateControllerClazz;
+    jmethodID bitrateControllerOnTargetBitrateMethod;
+
+    jclass statsClazz;
+    jmethodID statsConstructorMethod;
+
+    /**
+     * @return true if every class, field and method has been resolved
+     */
+    bool isLoaded() const {
+        return loaded;
+    }
+
+    static ModelsSingleton *getInstance(JNIEnv *env) {
+        if (instance == nullptr) {
+            instance = new ModelsSingleton(env);
+        }
+        return instance;
+    }
+};
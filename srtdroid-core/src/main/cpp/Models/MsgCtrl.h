@@ -15,89 +15,32 @@
  */
 #pragma once
 
+#include <cstddef>
+
 #include "Models.h"
 
+/*
+ * Layout of the SRT_MSGCTRL the Kotlin MsgCtrl owns as a direct ByteBuffer. Offsets must match
+ * MsgCtrl.kt.
+ */
+#define MSGCTRL_BUFFER_SIZE 48
+
+static_assert(offsetof(SRT_MSGCTRL, flags) == 0, "MsgCtrl flags offset mismatch");
+static_assert(offsetof(SRT_MSGCTRL, msgttl) == 4, "MsgCtrl ttl offset mismatch");
+static_assert(offsetof(SRT_MSGCTRL, inorder) == 8, "MsgCtrl inOrder offset mismatch");
+static_assert(offsetof(SRT_MSGCTRL, boundary) == 12, "MsgCtrl boundary offset mismatch");
+static_assert(offsetof(SRT_MSGCTRL, srctime) == 16, "MsgCtrl srcTime offset mismatch");
+static_assert(offsetof(SRT_MSGCTRL, pktseq) == 24, "MsgCtrl pktSeq offset mismatch");
+static_assert(offsetof(SRT_MSGCTRL, msgno) == 28, "MsgCtrl no offset mismatch");
+static_assert(sizeof(SRT_MSGCTRL) <= MSGCTRL_BUFFER_SIZE, "MsgCtrl buffer is too small");
+
 class MsgCtrl {
 public:
     static SRT_MSGCTRL *
-    getNative(JNIEnv *env, jobject msgCtrl) {
-        SRT_MSGCTRL *srt_msgctrl = nullptr;
-
-        if (msgCtrl == nullptr)
-            return nullptr;
-
-        jclass msgCtrlClazz = env->GetObjectClass(msgCtrl);
-        if (!msgCtrlClazz) {
-            LOGE("Can't get MsgCtrl class");
-            return nullptr;
-        }
-
-        jfieldID msgCtrlFlagsField = env->GetFieldID(msgCtrlClazz, "flags", "I");
-        if (!msgCtrlFlagsField) {
-            LOGE("Can't get flags field");
-            env->DeleteLocalRef(msgCtrlClazz);
-            return nullptr;
-        }
-
-        jfieldID msgCtrlTtlField = env->GetFieldID(msgCtrlClazz, "ttl", "I");
-        if (!msgCtrlTtlField) {
-            LOGE("Can't get ttl field");
-            env->DeleteLocalRef(msgCtrlClazz);
+    getNative(JNIEnv *env, jobject msgCtrlBuffer) {
+        if (msgCtrlBuffer == nullptr)
             return nullptr;
-        }
-
-        jfieldID msgCtrlInOrderField = env->GetFieldID(msgCtrlClazz, "inOrder", "Z");
-        if (!msgCtrlInOrderField) {
-            LOGE("Can't get inOrder field");
-            env->DeleteLocalRef(msgCtrlClazz);
-            return nullptr;
-        }
-
-        jfieldID msgCtrlBondaryField = env->GetFieldID(msgCtrlClazz, "boundary",
-        "L" BOUNDARY_CLASS ";");
-        if (!msgCtrlBondaryField) {
-            LOGE("Can't get boundary field");
-            env->DeleteLocalRef(msgCtrlClazz);
-            return nullptr;
-        }
-
-        jfieldID msgCtrlSrcTimeField = env->GetFieldID(msgCtrlClazz, "srcTime", "J");
-        if (!msgCtrlSrcTimeField) {
-            LOGE("Can't get srcTime field");
-            env->DeleteLocalRef(msgCtrlClazz);
-            return nullptr;
-        }
-
-        jfieldID msgCtrlPktSeqField = env->GetFieldID(msgCtrlClazz, "pktSeq", "I");
-        if (!msgCtrlPktSeqField) {
-            LOGE("Can't get pktSeq field");
-            env->DeleteLocalRef(msgCtrlClazz);
-            return nullptr;
-        }
-
-        jfieldID msgCtrlNoField = env->GetFieldID(msgCtrlClazz, "no", "I");
-        if (!msgCtrlNoField) {
-            LOGE("Can't get message number field");
-            env->DeleteLocalRef(msgCtrlClazz);
-            return nullptr;
-        }
-
-        srt_msgctrl = (SRT_MSGCTRL *) malloc(sizeof(SRT_MSGCTRL));
-        if (srt_msgctrl != nullptr) {
-            srt_msgctrl->flags = env->GetIntField(msgCtrl, msgCtrlFlagsField);
-            srt_msgctrl->msgttl = env->GetIntField(msgCtrl, msgCtrlTtlField);
-            srt_msgctrl->inorder = env->GetBooleanField(msgCtrl, msgCtrlInOrderField);
-            srt_msgctrl->boundary = EnumsSingleton::getInstance(env)->boundary->getNativeValue(env,
-                                                                                               env->GetObjectField(
-                                                                                                       msgCtrl,
-                                                                                                       msgCtrlBondaryField));
-            srt_msgctrl->srctime = (uint64_t) env->GetLongField(msgCtrl, msgCtrlSrcTimeField);
-            srt_msgctrl->pktseq = env->GetIntField(msgCtrl, msgCtrlPktSeqField);
-            srt_msgctrl->msgno = env->GetIntField(msgCtrl, msgCtrlNoField);
-        }
-
-        env->DeleteLocalRef(msgCtrlClazz);
 
-        return srt_msgctrl;
+        return (SRT_MSGCTRL *) env->GetDirectBufferAddress(msgCtrlBuffer);
     }
-};
\ No newline at end of file
+};
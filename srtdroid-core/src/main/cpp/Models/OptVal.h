@@ -15,169 +15,26 @@
  */
 #pragma once
 
+#include "ModelsSingleton.h"
 #include "Primitive.h"
 
 class OptVal {
-private:
-    static const char *
-    getClassName(JNIEnv *env, jobject object) {
-        jclass objectClazz = env->GetObjectClass(object);
-        if (!objectClazz) {
-            LOGE("Can't get object class");
-            return nullptr;
-        }
-
-        // As object could be an Int, String,... First step is to get class object.
-        jmethodID objectGetClassMethod = env->GetMethodID(objectClazz, "getClass",
-                                                          "()Ljava/lang/Class;");
-        if (!objectGetClassMethod) {
-            LOGE("Can't get getClass method");
-            env->DeleteLocalRef(objectClazz);
-            return nullptr;
-        }
-
-        jobject objectClazzObject = env->CallObjectMethod(object, objectGetClassMethod);
-        if (!objectClazzObject) {
-            LOGE("Can't get class object");
-            env->DeleteLocalRef(objectClazz);
-            return nullptr;
-        }
-
-        jclass clazzClazz = env->GetObjectClass(objectClazzObject);
-        if (!clazzClazz) {
-            LOGE("Can't get class");
-            env->DeleteLocalRef(objectClazz);
-            return nullptr;
-        }
-
-        // Then get class name
-        jmethodID objectClazzGetNameMethod = env->GetMethodID(clazzClazz, "getName",
-                                                              "()Ljava/lang/String;");
-        if (!objectClazzGetNameMethod) {
-            LOGE("Can't get getName method");
-            env->DeleteLocalRef(objectClazz);
-            env->DeleteLocalRef(clazzClazz);
-            return nullptr;
-        }
-
-        auto className = (jstring) env->CallObjectMethod(objectClazzObject,
-                                                         objectClazzGetNameMethod);
-        if (!className) {
-            LOGE("Can't get class name");
-            env->DeleteLocalRef(objectClazz);
-            env->DeleteLocalRef(clazzClazz);
-            return nullptr;
-        }
-
-        const char *class_name = env->GetStringUTFChars(className, nullptr);
-        const char *dup_class_name = strdup(class_name);
-
-        env->ReleaseStringUTFChars(className, class_name);
-
-        env->DeleteLocalRef(objectClazz);
-        env->DeleteLocalRef(clazzClazz);
-
-        return dup_class_name;
-    }
-
 public:
-    static void *
-    getNative(JNIEnv *env, jobject optVal, int *optval_len) {
-        void *srt_optval = nullptr;
-
-        if (optval_len == nullptr) {
-            LOGE("Can't get optlen");
-            return nullptr;
-        }
-
-        jclass optValClazz = env->GetObjectClass(optVal);
-        if (!optValClazz) {
-            LOGE("Can't get OptVal class");
-            return nullptr;
-        }
-
-        const char *class_name = getClassName(env, optVal);
-        if (class_name == nullptr) {
-            return nullptr;
-        }
-
-        if (strcmp(class_name, "java.lang.String") == 0) {
-            const char *optval = env->GetStringUTFChars((jstring) optVal, nullptr);
-            *optval_len = strlen(optval);
-            srt_optval = strdup(optval);
-            env->ReleaseStringUTFChars((jstring) optVal, optval);
-        } else if (strcmp(class_name, ENUM_PACKAGE".Transtype") == 0) {
-            SRT_TRANSTYPE transtype = EnumsSingleton::getInstance(env)->transType->getNativeValue(
-                    env,
-                    optVal);
-            *optval_len = sizeof(transtype);
-            srt_optval = malloc(static_cast<size_t>(*optval_len));
-            *(SRT_TRANSTYPE *) srt_optval = transtype;
-        } else if (strcmp(class_name, ENUM_PACKAGE".KMState") == 0) {
-            SRT_KM_STATE kmstate = EnumsSingleton::getInstance(env)->kmState->getNativeValue(env,
-                                                                                             optVal);
-            *optval_len = sizeof(kmstate);
-            srt_optval = malloc(static_cast<size_t>(*optval_len));
-            *(SRT_KM_STATE *) srt_optval = kmstate;
-        } else if (strcmp(class_name, "java.lang.Long") == 0) {
-            jmethodID longValueMethod = env->GetMethodID(optValClazz, "longValue", "()J");
-            if (!longValueMethod) {
-                LOGE("Can't get longValue method");
-                return nullptr;
-            }
-            *optval_len = sizeof(int64_t);
-            srt_optval = malloc(static_cast<size_t>(*optval_len));
-            *(int64_t *) srt_optval = env->CallLongMethod(optVal, longValueMethod);
-        } else if (strcmp(class_name, "java.lang.Integer") == 0) {
-            jmethodID intValueMethod = env->GetMethodID(optValClazz, "intValue", "()I");
-            if (!intValueMethod) {
-                LOGE("Can't get intValue method");
-                return nullptr;
-            }
-            *optval_len = sizeof(int);
-            srt_optval = malloc(static_cast<size_t>(*optval_len));
-            *(int *) srt_optval = env->CallIntMethod(optVal, intValueMethod);
-        } else if (strcmp(class_name, "java.lang.Boolean") == 0) {
-            jmethodID booleanValueMethod = env->GetMethodID(optValClazz, "booleanValue", "()Z");
-            if (!booleanValueMethod) {
-                LOGE("Can't get booleanValue method");
-                return nullptr;
-            }
-            *optval_len = sizeof(bool);
-            srt_optval = malloc(static_cast<size_t>(*optval_len));
-            *(bool *) srt_optval = (env->CallBooleanMethod(optVal, booleanValueMethod) == JNI_TRUE);
-        } else {
-            LOGE("OptVal: unknown class %s", class_name);
-        }
-
-        free((void *) class_name);
-        env->DeleteLocalRef(optValClazz);
-
-        return srt_optval;
-    }
-
-    static jobject getJava(JNIEnv *env, int u, int level, jobject sockOpt) {
-        jobject optVal = nullptr;
-
-        int sockopt = EnumsSingleton::getInstance(env)->sockOpt->getNativeValue(env, sockOpt);
-        if (sockopt < 0) {
-            return nullptr;
-        }
-
+    enum Type {
+        INT,
+        LONG,
+        BOOL,
+        STRING,
+        KMSTATE,
+        TRANSTYPE
+    };
+
+    static Type getType(int sockopt) {
         switch (sockopt) {
             case SRTO_INPUTBW:
             case SRTO_MININPUTBW:
-            case SRTO_MAXBW: {
-                // Int64
-                int64_t optval = 0;
-                int optlen = sizeof(optval);
-                if (srt_getsockopt(u, level, (SRT_SOCKOPT) sockopt, &optval, &optlen) != 0) {
-                    LOGE("Can't execute long getsockopt");
-                    return nullptr;
-                }
-                optVal = Primitive::newJavaLong(env, optval);
-                break;
-            }
+            case SRTO_MAXBW:
+                return LONG;
             case SRTO_MESSAGEAPI:
             case SRTO_NAKREPORT:
             case SRTO_RCVSYN:
@@ -188,73 +45,98 @@ public:
             case SRTO_ENFORCEDENCRYPTION:
             case SRTO_TLPKTDROP:
             case SRTO_DRIFTTRACER:
-            case SRTO_TSBPDMODE: {
-                // Boolean
-                bool optval = false;
-                int optlen = sizeof(bool);
-                if (srt_getsockopt(u, level, (SRT_SOCKOPT) sockopt, (void *) &optval, &optlen) !=
-                    0) {
-                    LOGE("Can't execute bool getsockopt");
-                    return nullptr;
-                }
-                optVal = Primitive::newJavaBoolean(env, optval);
-                break;
-            }
+            case SRTO_TSBPDMODE:
+                return BOOL;
             case SRTO_PACKETFILTER:
             case SRTO_PASSPHRASE:
             case SRTO_BINDTODEVICE:
-            case SRTO_STREAMID: {
-                // String
-                const char optval[512] = {0};
-                int optlen = sizeof(optval);
-                if (srt_getsockopt(u, level, (SRT_SOCKOPT) sockopt, (void *) &optval, &optlen) !=
-                    0) {
-                    LOGE("Can't execute string getsockopt");
-                    return nullptr;
-                }
-                optVal = env->NewStringUTF(optval);
-                break;
-            }
+            case SRTO_STREAMID:
+                return STRING;
             case SRTO_KMSTATE:
             case SRTO_RCVKMSTATE:
-            case SRTO_SNDKMSTATE: {
-                // KMState
-                SRT_KM_STATE optval;
-                int optlen = sizeof(SRT_KM_STATE);
-                if (srt_getsockopt(u, level, (SRT_SOCKOPT) sockopt, (void *) &optval, &optlen) !=
-                    0) {
-                    LOGE("Can't execute SRT_KM_STATE getsockopt");
-                    return nullptr;
-                }
-                optVal = EnumsSingleton::getInstance(env)->kmState->getJavaValue(env, optval);
-                break;
+            case SRTO_SNDKMSTATE:
+                return KMSTATE;
+            case SRTO_TRANSTYPE:
+                return TRANSTYPE;
+            default:
+                return INT;
+        }
+    }
+
+    /**
+     * Reads a non string option as an int64_t.
+     * Booleans are 0 or 1 and enums are their native values.
+     *
+     * @return 0 on success, otherwise -1
+     */
+    static int getNumber(int u, int level, int sockopt, int64_t *value) {
+        int optlen;
+        switch (getType(sockopt)) {
+            case LONG: {
+                optlen = sizeof(int64_t);
+                return srt_getsockopt(u, level, (SRT_SOCKOPT) sockopt, value, &optlen);
             }
-            case SRTO_TRANSTYPE: {
-                // Transtype
-                SRT_TRANSTYPE optval;
-                int optlen = sizeof(SRT_TRANSTYPE);
-                if (srt_getsockopt(u, level, (SRT_SOCKOPT) sockopt, (void *) &optval, &optlen) !=
-                    0) {
-                    LOGE("Can't execute SRT_TRANSTYPE getsockopt");
-                    return nullptr;
+            case BOOL: {
+                bool optval = false;
+                optlen = sizeof(bool);
+                if (srt_getsockopt(u, level, (SRT_SOCKOPT) sockopt, &optval, &optlen) != 0) {
+                    return -1;
                 }
-                optVal = EnumsSingleton::getInstance(env)->transType->getJavaValue(env, optval);
-                break;
+                *value = optval;
+                return 0;
             }
+            case STRING:
+                return -1;
             default: {
-                // Int
+                // Int and enums
                 int optval = 0;
-                int optlen = sizeof(int);
-                if (srt_getsockopt(u, level, (SRT_SOCKOPT) sockopt, (void *) &optval, &optlen) !=
-                    0) {
-                    LOGE("Can't execute int getsockopt");
-                    return nullptr;
+                optlen = sizeof(int);
+                if (srt_getsockopt(u, level, (SRT_SOCKOPT) sockopt, &optval, &optlen) != 0) {
+                    return -1;
                 }
-                optVal = Primitive::newJavaInt(env, optval);
-                break;
+                *value = optval;
+                return 0;
+            }
+        }
+    }
+
+    static jobject getJava(JNIEnv *env, int u, int level, jobject sockOpt) {
+        int sockopt = EnumsSingleton::getInstance(env)->sockOpt->getNativeValue(env, sockOpt);
+        if (sockopt < 0) {
+            return nullptr;
+        }
+
+        Type type = getType(sockopt);
+        if (type == STRING) {
+            char optval[512] = {0};
+            int optlen = sizeof(optval);
+            if (srt_getsockopt(u, level, (SRT_SOCKOPT) sockopt, (void *) &optval, &optlen) != 0) {
+                LOGE("Can't execute string getsockopt");
+                return nullptr;
             }
+            return env->NewStringUTF(optval);
         }
 
-        return optVal;
+        int64_t optval = 0;
+        if (getNumber(u, level, sockopt, &optval) != 0) {
+            LOGE("Can't execute getsockopt");
+            return nullptr;
+        }
+        switch (type) {
+            case LONG:
+                return Primitive::newJavaLong(env, optval);
+            case BOOL:
+                return Primitive::newJavaBoolean(env, optval != 0);
+            case KMSTATE: {
+                auto kmstate = (SRT_KM_STATE) optval;
+                return EnumsSingleton::getInstance(env)->kmState->getJavaValue(env, kmstate);
+            }
+            case TRANSTYPE: {
+                auto transtype = (SRT_TRANSTYPE) optval;
+                return EnumsSingleton::getInstance(env)->transType->getJavaValue(env, transtype);
+            }
+            default:
+                return Primitive::newJavaInt(env, (int) optval);
+        }
     }
-};
\ No newline at end of file
+};
@@ -16,28 +16,13 @@
 #pragma once
 
 #include "Models.h"
+#include "ModelsSingleton.h"
 
 class Pair {
 public:
     static jobject newJavaPair(JNIEnv *env, jobject first, jobject second) {
-        jclass pairClazz = env->FindClass(PAIR_CLASS);
-        if (!pairClazz) {
-            LOGE("Can't get Pair class");
-            return nullptr;
-        }
+        ModelsSingleton *models = ModelsSingleton::getInstance(env);
 
-        jmethodID pairConstructorMethod = env->GetMethodID(pairClazz, "<init>",
-                                                           "(Ljava/lang/Object;Ljava/lang/Object;)V");
-        if (!pairConstructorMethod) {
-            LOGE("Can't get Pair constructor");
-            env->DeleteLocalRef(pairClazz);
-            return nullptr;
-        }
-
-        jobject pair = env->NewObject(pairClazz, pairConstructorMethod, first, second);
-
-        env->DeleteLocalRef(pairClazz);
-
-        return pair;
+        return env->NewObject(models->pairClazz, models->pairConstructorMethod, first, second);
     }
-};
\ No newline at end of file
+};
@@ -16,49 +16,26 @@
 #pragma once
 
 #include "Models.h"
+#include "ModelsSingleton.h"
 
 class Primitive {
 public:
     static jobject newJavaLong(JNIEnv *env, int64_t val) {
-        jclass longClazz = env->FindClass(LONG_CLASS);
-        if (!longClazz) {
-            LOGE("Can't find Long class");
-            return nullptr;
-        }
-        jmethodID longConstructorMethod = env->GetMethodID(longClazz, "<init>", "(J)V");
-        if (!longConstructorMethod) {
-            LOGE("Can't find Long constructor");
-            return nullptr;
-        }
-        return env->NewObject(longClazz, longConstructorMethod, val);
+        ModelsSingleton *models = ModelsSingleton::getInstance(env);
+
+        return env->NewObject(models->longClazz, models->longConstructorMethod, (jlong) val);
     }
 
     static jobject newJavaBoolean(JNIEnv *env, bool val) {
-        jclass boolClazz = env->FindClass(BOOLEAN_CLASS);
-        if (!boolClazz) {
-            LOGE("Can't find Boolean class");
-            return nullptr;
-        }
-        jmethodID booleanConstructorMethod = env->GetMethodID(boolClazz, "<init>", "(Z)V");
-        if (!booleanConstructorMethod) {
-            LOGE("Can't find Boolean constructor");
-            return nullptr;
-        }
-        return env->NewObject(boolClazz, booleanConstructorMethod, val);
+        ModelsSingleton *models = ModelsSingleton::getInstance(env);
+
+        return env->NewObject(models->booleanClazz, models->booleanConstructorMethod,
+                              (jboolean) val);
     }
 
     static jobject newJavaInt(JNIEnv *env, int val) {
-        jclass intClazz = env->FindClass(INT_CLASS);
-        if (!intClazz) {
-            LOGE("Can't find Integer class");
-            return nullptr;
-        }
-        jmethodID integerConstructorMethod = env->GetMethodID(intClazz, "<init>", "(I)V");
-        if (!integerConstructorMethod) {
-            LOGE("Can't find Integer constructor");
-            return nullptr;
-        }
-        return env->NewObject(intClazz, integerConstructorMethod, val);
-    }
+        ModelsSingleton *models = ModelsSingleton::getInstance(env);
 
-};
\ No newline at end of file
+        return env->NewObject(models->integerClazz, models->integerConstructorMethod, (jint) val);
+    }
+};
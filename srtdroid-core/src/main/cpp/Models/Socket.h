@@ -16,70 +16,21 @@
 #pragma once
 
 #include "Models.h"
+#include "ModelsSingleton.h"
+#include "../SocketRegistry.h"
 
 class Socket {
 public:
     static SRTSOCKET getNative(JNIEnv *env, jobject srtSocket) {
-        jclass socketClazz = env->GetObjectClass(srtSocket);
-        if (!socketClazz) {
-            LOGE("Can't get Socket class");
-            return SRT_INVALID_SOCK;
-        }
-
-        jfieldID srtSocketField = env->GetFieldID(socketClazz, "srtsocket", "I");
-        if (!srtSocketField) {
-            LOGE("Can't get srtsocket field");
-            env->DeleteLocalRef(socketClazz);
-            return SRT_INVALID_SOCK;
-        }
-
-        jint srtsocket = env->GetIntField(srtSocket, srtSocketField);
-
-        env->DeleteLocalRef(socketClazz);
-
-        return srtsocket;
+        return env->GetIntField(srtSocket, ModelsSingleton::getInstance(env)->srtSocketField);
     }
 
     static jobject getJava(JNIEnv *env, SRTSOCKET srtsocket) {
-        jclass srtSocketClazz = env->FindClass(SRTSOCKET_CLASS);
-        jobject inetSocketAddress = getJava(env, srtSocketClazz, srtsocket);
-        env->DeleteLocalRef(srtSocketClazz);
-        return inetSocketAddress;
-    }
-
-    static jobject getJava(JNIEnv *env, jclass clazz, SRTSOCKET srtsocket) {
-        if (!clazz) {
-            LOGE("Can't find Srt Socket class");
-            return nullptr;
-        }
-
-        jmethodID srtSocketConstructorMethod = env->GetMethodID(clazz, "<init>", "(I)V");
-        if (!srtSocketConstructorMethod) {
-            LOGE("Can't get SrtSocket constructor");
-            return nullptr;
-        }
-
-        jobject srtSocket = env->NewObject(clazz, srtSocketConstructorMethod, srtsocket);
-        return srtSocket;
+        return SocketRegistry::getInstance()->getJava(env, srtsocket);
     }
 
     static void setJava(JNIEnv *env, jobject srtSocket, SRTSOCKET srtsocket) {
-        jclass socketClazz = env->GetObjectClass(srtSocket);
-        if (!socketClazz) {
-            LOGE("Can't get Socket class");
-            return;
-        }
-
-        jfieldID srtSocketField = env->GetFieldID(socketClazz, "srtsocket", "I");
-        if (!srtSocketField) {
-            LOGE("Can't get srtsocket field");
-            env->DeleteLocalRef(socketClazz);
-            return;
-        }
-
-        env->SetIntField(srtSocket, srtSocketField, srtsocket);
-
-        env->DeleteLocalRef(socketClazz);
+        env->SetIntField(srtSocket, ModelsSingleton::getInstance(env)->srtSocketField, srtsocket);
     }
 
     static SRTSOCKET *getNativeSockets(JNIEnv *env, jobject srtSocketList, int *nSockets) {
@@ -93,8 +44,9 @@ public:
         for (int i = 0; i < *nSockets; i++) {
             jobject srtSocket = List::get(env, srtSocketList, i);
             srtsocket[i] = Socket::getNative(env, srtSocket);
+            env->DeleteLocalRef(srtSocket);
         }
 
         return srtsocket;
     }
-};
\ No newline at end of file
+};
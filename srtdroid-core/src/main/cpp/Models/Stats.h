@@ -15,122 +15,337 @@
  */
 #pragma once
 
+#include <array>
+#include <cstring>
+#include <type_traits>
+
 #include "Models.h"
+#include "ModelsSingleton.h"
 
 class Stats {
 public:
     static jobject getJava(JNIEnv *env, SRT_TRACEBSTATS tracebstats) {
-        jclass statsClazz = env->FindClass(STATS_CLASS);
-        if (!statsClazz) {
-            LOGE("Can't find Srt Stats class");
-            return nullptr;
-        }
+        ModelsSingleton *models = ModelsSingleton::getInstance(env);
 
-        jmethodID statsConstructorMethod = env->GetMethodID(statsClazz, "<init>",
-                                                            "(JJJIIIIIIIJIIIJJJJJJJJJIIIIIIIIDDJIDJIIIJJJJJJJDIIIDDIIDIIIIIIIIIIIIIIIIIIJJJJJJJJ)V");
-        if (!statsConstructorMethod) {
-            LOGE("Can't get Stats constructor");
-            env->DeleteLocalRef(statsClazz);
-            return nullptr;
-        }
+        jobject stats = env->NewObject(models->statsClazz, models->statsConstructorMethod,
+                                       tracebstats.msTimeStamp,
+                                       tracebstats.pktSentTotal,
+                                       tracebstats.pktRecvTotal,
+                                       tracebstats.pktSndLossTotal,
+                                       tracebstats.pktRcvLossTotal,
+                                       tracebstats.pktRetransTotal,
+                                       tracebstats.pktSentACKTotal,
+                                       tracebstats.pktRecvACKTotal,
+                                       tracebstats.pktSentNAKTotal,
+                                       tracebstats.pktRecvNAKTotal,
+                                       tracebstats.usSndDurationTotal,
+
+                                       tracebstats.pktSndDropTotal,
+                                       tracebstats.pktRcvDropTotal,
+                                       tracebstats.pktRcvUndecryptTotal,
+                                       (jlong) tracebstats.byteSentTotal,
+                                       (jlong) tracebstats.byteRecvTotal,
+                                       (jlong) tracebstats.byteRcvLossTotal,
+                                       (jlong) tracebstats.byteRetransTotal,
+                                       (jlong) tracebstats.byteSndDropTotal,
+                                       (jlong) tracebstats.byteRcvDropTotal,
+                                       (jlong) tracebstats.byteRcvUndecryptTotal,
+                                       tracebstats.pktSent,
+                                       tracebstats.pktRecv,
+                                       tracebstats.pktSndLoss,
+                                       tracebstats.pktRcvLoss,
+                                       tracebstats.pktRetrans,
+                                       tracebstats.pktRcvRetrans,
+                                       tracebstats.pktSentACK,
+                                       tracebstats.pktRecvACK,
+                                       tracebstats.pktSentNAK,
+                                       tracebstats.pktRecvNAK,
+                                       tracebstats.mbpsSendRate,
+                                       tracebstats.mbpsRecvRate,
+                                       tracebstats.usSndDuration,
+                                       tracebstats.pktReorderDistance,
+                                       tracebstats.pktRcvAvgBelatedTime,
+                                       tracebstats.pktRcvBelated,
+
+                                       tracebstats.pktSndDrop,
+                                       tracebstats.pktRcvDrop,
+                                       tracebstats.pktRcvUndecrypt,
+                                       (jlong) tracebstats.byteSent,
+                                       (jlong) tracebstats.byteRecv,
+                                       (jlong) tracebstats.byteRcvLoss,
+                                       (jlong) tracebstats.byteRetrans,
+                                       (jlong) tracebstats.byteSndDrop,
+                                       (jlong) tracebstats.byteRcvDrop,
+                                       (jlong) tracebstats.byteRcvUndecrypt,
+
+                                       tracebstats.usPktSndPeriod,
+                                       tracebstats.pktFlowWindow,
+                                       tracebstats.pktCongestionWindow,
+                                       tracebstats.pktFlightSize,
+                                       tracebstats.msRTT,
+                                       tracebstats.mbpsBandwidth,
+                                       tracebstats.byteAvailSndBuf,
+                                       tracebstats.byteAvailRcvBuf,
+
+                                       tracebstats.mbpsMaxBW,
+                                       tracebstats.byteMSS,
 
-        jobject srtSocket = env->NewObject(statsClazz, statsConstructorMethod,
-                                           tracebstats.msTimeStamp,
-                                           tracebstats.pktSentTotal,
-                                           tracebstats.pktRecvTotal,
-                                           tracebstats.pktSndLossTotal,
-                                           tracebstats.pktRcvLossTotal,
-                                           tracebstats.pktRetransTotal,
-                                           tracebstats.pktSentACKTotal,
-                                           tracebstats.pktRecvACKTotal,
-                                           tracebstats.pktSentNAKTotal,
-                                           tracebstats.pktRecvNAKTotal,
-                                           tracebstats.usSndDurationTotal,
-
-                                           tracebstats.pktSndDropTotal,
-                                           tracebstats.pktRcvDropTotal,
-                                           tracebstats.pktRcvUndecryptTotal,
-                                           (jlong) tracebstats.byteSentTotal,
-                                           (jlong) tracebstats.byteRecvTotal,
-                                           (jlong) tracebstats.byteRcvLossTotal,
-                                           (jlong) tracebstats.byteRetransTotal,
-                                           (jlong) tracebstats.byteSndDropTotal,
-                                           (jlong) tracebstats.byteRcvDropTotal,
-                                           (jlong) tracebstats.byteRcvUndecryptTotal,
-                                           tracebstats.pktSent,
-                                           tracebstats.pktRecv,
-                                           tracebstats.pktSndLoss,
-                                           tracebstats.pktRcvLoss,
-                                           tracebstats.pktRetrans,
-                                           tracebstats.pktRcvRetrans,
-                                           tracebstats.pktSentACK,
-                                           tracebstats.pktRecvACK,
-                                           tracebstats.pktSentNAK,
-                                           tracebstats.pktRecvNAK,
-                                           tracebstats.mbpsSendRate,
-                                           tracebstats.mbpsRecvRate,
-                                           tracebstats.usSndDuration,
-                                           tracebstats.pktReorderDistance,
-                                           tracebstats.pktRcvAvgBelatedTime,
-                                           tracebstats.pktRcvBelated,
-
-                                           tracebstats.pktSndDrop,
-                                           tracebstats.pktRcvDrop,
-                                           tracebstats.pktRcvUndecrypt,
-                                           (jlong) tracebstats.byteSent,
-                                           (jlong) tracebstats.byteRecv,
-                                           (jlong) tracebstats.byteRcvLoss,
-                                           (jlong) tracebstats.byteRetrans,
-                                           (jlong) tracebstats.byteSndDrop,
-                                           (jlong) tracebstats.byteRcvDrop,
-                                           (jlong) tracebstats.byteRcvUndecrypt,
-
-                                           tracebstats.usPktSndPeriod,
-                                           tracebstats.pktFlowWindow,
-                                           tracebstats.pktCongestionWindow,
-                                           tracebstats.pktFlightSize,
-                                           tracebstats.msRTT,
-                                           tracebstats.mbpsBandwidth,
-                                           tracebstats.byteAvailSndBuf,
-                                           tracebstats.byteAvailRcvBuf,
-
-                                           tracebstats.mbpsMaxBW,
-                                           tracebstats.byteMSS,
-
-                                           tracebstats.pktSndBuf,
-                                           tracebstats.byteSndBuf,
-                                           tracebstats.msSndBuf,
-                                           tracebstats.msSndTsbPdDelay,
-
-                                           tracebstats.pktRcvBuf,
-                                           tracebstats.byteRcvBuf,
-                                           tracebstats.msRcvBuf,
-                                           tracebstats.msRcvTsbPdDelay,
-
-                                           tracebstats.pktSndFilterExtraTotal,
-                                           tracebstats.pktRcvFilterExtraTotal,
-                                           tracebstats.pktRcvFilterSupplyTotal,
-                                           tracebstats.pktRcvFilterLossTotal,
-
-                                           tracebstats.pktSndFilterExtra,
-                                           tracebstats.pktRcvFilterExtra,
-                                           tracebstats.pktRcvFilterSupply,
-                                           tracebstats.pktRcvFilterLoss,
-                                           tracebstats.pktReorderTolerance,
-
-                                           (jlong) tracebstats.pktSentUniqueTotal,
-                                           (jlong) tracebstats.pktRecvUniqueTotal,
-                                           (jlong) tracebstats.byteSentUniqueTotal,
-                                           (jlong) tracebstats.byteRecvUniqueTotal,
-
-                                           (jlong) tracebstats.pktSentUnique,
-                                           (jlong) tracebstats.pktRecvUnique,
-                                           (jlong) tracebstats.byteSentUnique,
-                                           (jlong) tracebstats.byteRecvUnique
+                                       tracebstats.pktSndBuf,
+                                       tracebstats.byteSndBuf,
+                                       tracebstats.msSndBuf,
+                                       tracebstats.msSndTsbPdDelay,
+
+                                       tracebstats.pktRcvBuf,
+                                       tracebstats.byteRcvBuf,
+                                       tracebstats.msRcvBuf,
+                                       tracebstats.msRcvTsbPdDelay,
+
+                                       tracebstats.pktSndFilterExtraTotal,
+                                       tracebstats.pktRcvFilterExtraTotal,
+                                       tracebstats.pktRcvFilterSupplyTotal,
+                                       tracebstats.pktRcvFilterLossTotal,
+
+                                       tracebstats.pktSndFilterExtra,
+                                       tracebstats.pktRcvFilterExtra,
+                                       tracebstats.pktRcvFilterSupply,
+                                       tracebstats.pktRcvFilterLoss,
+                                       tracebstats.pktReorderTolerance,
+
+                                       (jlong) tracebstats.pktSentUniqueTotal,
+                                       (jlong) tracebstats.pktRecvUniqueTotal,
+                                       (jlong) tracebstats.byteSentUniqueTotal,
+                                       (jlong) tracebstats.byteRecvUniqueTotal,
+
+                                       (jlong) tracebstats.pktSentUnique,
+                                       (jlong) tracebstats.pktRecvUnique,
+                                       (jlong) tracebstats.byteSentUnique,
+                                       (jlong) tracebstats.byteRecvUnique
         );
 
-        env->DeleteLocalRef(statsClazz);
+        return stats;
+    }
+
+    /**
+     * Indexes of the fields written by write(). Same names as StatsBuffer constants.
+     */
+    enum Field {
+        MS_TIME_STAMP = 0,
+        PKT_SENT_TOTAL,
+        PKT_RECV_TOTAL,
+        PKT_SND_LOSS_TOTAL,
+        PKT_RCV_LOSS_TOTAL,
+        PKT_RETRANS_TOTAL,
+        PKT_SENT_ACK_TOTAL,
+        PKT_RECV_ACK_TOTAL,
+        PKT_SENT_NAK_TOTAL,
+        PKT_RECV_NAK_TOTAL,
+        US_SND_DURATION_TOTAL,
+        PKT_SND_DROP_TOTAL,
+        PKT_RCV_DROP_TOTAL,
+        PKT_RCV_UNDECRYPT_TOTAL,
+        BYTE_SENT_TOTAL,
+        BYTE_RECV_TOTAL,
+        BYTE_RCV_LOSS_TOTAL,
+        BYTE_RETRANS_TOTAL,
+        BYTE_SND_DROP_TOTAL,
+        BYTE_RCV_DROP_TOTAL,
+        BYTE_RCV_UNDECRYPT_TOTAL,
+        PKT_SENT,
+        PKT_RECV,
+        PKT_SND_LOSS,
+        PKT_RCV_LOSS,
+        PKT_RETRANS,
+        PKT_RCV_RETRANS,
+        PKT_SENT_ACK,
+        PKT_RECV_ACK,
+        PKT_SENT_NAK,
+        PKT_RECV_NAK,
+        MBPS_SEND_RATE,
+        MBPS_RECV_RATE,
+        US_SND_DURATION,
+        PKT_REORDER_DISTANCE,
+        PKT_RCV_AVG_BELATED_TIME,
+        PKT_RCV_BELATED,
+        PKT_SND_DROP,
+        PKT_RCV_DROP,
+        PKT_RCV_UNDECRYPT,
+        BYTE_SENT,
+        BYTE_RECV,
+        BYTE_RCV_LOSS,
+        BYTE_RETRANS,
+        BYTE_SND_DROP,
+        BYTE_RCV_DROP,
+        BYTE_RCV_UNDECRYPT,
+        US_PKT_SND_PERIOD,
+        PKT_FLOW_WINDOW,
+        PKT_CONGESTION_WINDOW,
+        PKT_FLIGHT_SIZE,
+        MS_RTT,
+        MBPS_BANDWIDTH,
+        BYTE_AVAIL_SND_BUF,
+        BYTE_AVAIL_RCV_BUF,
+        MBPS_MAX_BW,
+        BYTE_MSS,
+        PKT_SND_BUF,
+        BYTE_SND_BUF,
+        MS_SND_BUF,
+        MS_SND_TSB_PD_DELAY,
+        PKT_RCV_BUF,
+        BYTE_RCV_BUF,
+        MS_RCV_BUF,
+        MS_RCV_TSB_PD_DELAY,
+        PKT_SND_FILTER_EXTRA_TOTAL,
+        PKT_RCV_FILTER_EXTRA_TOTAL,
+        PKT_RCV_FILTER_SUPPLY_TOTAL,
+        PKT_RCV_FILTER_LOSS_TOTAL,
+        PKT_SND_FILTER_EXTRA,
+        PKT_RCV_FILTER_EXTRA,
+        PKT_RCV_FILTER_SUPPLY,
+        PKT_RCV_FILTER_LOSS,
+        PKT_REORDER_TOLERANCE,
+        PKT_SENT_UNIQUE_TOTAL,
+        PKT_RECV_UNIQUE_TOTAL,
+        BYTE_SENT_UNIQUE_TOTAL,
+        BYTE_RECV_UNIQUE_TOTAL,
+        PKT_SENT_UNIQUE,
+        PKT_RECV_UNIQUE,
+        BYTE_SENT_UNIQUE,
+        BYTE_RECV_UNIQUE
+    };
+
+    /**
+     * Version of the index layout written by write(). It matches StatsBuffer.LAYOUT_VERSION.
+     * Fields are in the same order as the Stats constructor. Indexes are never reused: new fields
+     * are appended and the version is bumped.
+     */
+    static constexpr int LAYOUT_VERSION = 1;
+
+    /**
+     * Number of fields written by write().
+     */
+    static constexpr int LAYOUT_SIZE = 82;
+    static_assert(BYTE_RECV_UNIQUE + 1 == LAYOUT_SIZE, "Field and LAYOUT_SIZE mismatch");
+
+    /**
+     * Writes SRT_TRACEBSTATS fields into LAYOUT_SIZE elements of out, stride elements apart.
+     * In a jlong output, floating point fields are stored as their IEEE 754 bits.
+     */
+    template<typename T>
+    static void write(const SRT_TRACEBSTATS &tracebstats, T *out, int stride = 1) {
+        put(&out[0 * stride], tracebstats.msTimeStamp);
+        put(&out[1 * stride], tracebstats.pktSentTotal);
+        put(&out[2 * stride], tracebstats.pktRecvTotal);
+        put(&out[3 * stride], tracebstats.pktSndLossTotal);
+        put(&out[4 * stride], tracebstats.pktRcvLossTotal);
+        put(&out[5 * stride], tracebstats.pktRetransTotal);
+        put(&out[6 * stride], tracebstats.pktSentACKTotal);
+        put(&out[7 * stride], tracebstats.pktRecvACKTotal);
+        put(&out[8 * stride], tracebstats.pktSentNAKTotal);
+        put(&out[9 * stride], tracebstats.pktRecvNAKTotal);
+        put(&out[10 * stride], tracebstats.usSndDurationTotal);
+        put(&out[11 * stride], tracebstats.pktSndDropTotal);
+        put(&out[12 * stride], tracebstats.pktRcvDropTotal);
+        put(&out[13 * stride], tracebstats.pktRcvUndecryptTotal);
+        put(&out[14 * stride], tracebstats.byteSentTotal);
+        put(&out[15 * stride], tracebstats.byteRecvTotal);
+        put(&out[16 * stride], tracebstats.byteRcvLossTotal);
+        put(&out[17 * stride], tracebstats.byteRetransTotal);
+        put(&out[18 * stride], tracebstats.byteSndDropTotal);
+        put(&out[19 * stride], tracebstats.byteRcvDropTotal);
+        put(&out[20 * stride], tracebstats.byteRcvUndecryptTotal);
+        put(&out[21 * stride], tracebstats.pktSent);
+        put(&out[22 * stride], tracebstats.pktRecv);
+        put(&out[23 * stride], tracebstats.pktSndLoss);
+        put(&out[24 * stride], tracebstats.pktRcvLoss);
+        put(&out[25 * stride], tracebstats.pktRetrans);
+        put(&out[26 * stride], tracebstats.pktRcvRetrans);
+        put(&out[27 * stride], tracebstats.pktSentACK);
+        put(&out[28 * stride], tracebstats.pktRecvACK);
+        put(&out[29 * stride], tracebstats.pktSentNAK);
+        put(&out[30 * stride], tracebstats.pktRecvNAK);
+        put(&out[31 * stride], tracebstats.mbpsSendRate);
+        put(&out[32 * stride], tracebstats.mbpsRecvRate);
+        put(&out[33 * stride], tracebstats.usSndDuration);
+        put(&out[34 * stride], tracebstats.pktReorderDistance);
+        put(&out[35 * stride], tracebstats.pktRcvAvgBelatedTime);
+        put(&out[36 * stride], tracebstats.pktRcvBelated);
+        put(&out[37 * stride], tracebstats.pktSndDrop);
+        put(&out[38 * stride], tracebstats.pktRcvDrop);
+        put(&out[39 * stride], tracebstats.pktRcvUndecrypt);
+        put(&out[40 * stride], tracebstats.byteSent);
+        put(&out[41 * stride], tracebstats.byteRecv);
+        put(&out[42 * stride], tracebstats.byteRcvLoss);
+        put(&out[43 * stride], tracebstats.byteRetrans);
+        put(&out[44 * stride], tracebstats.byteSndDrop);
+        put(&out[45 * stride], tracebstats.byteRcvDrop);
+        put(&out[46 * stride], tracebstats.byteRcvUndecrypt);
+        put(&out[47 * stride], tracebstats.usPktSndPeriod);
+        put(&out[48 * stride], tracebstats.pktFlowWindow);
+        put(&out[49 * stride], tracebstats.pktCongestionWindow);
+        put(&out[50 * stride], tracebstats.pktFlightSize);
+        put(&out[51 * stride], tracebstats.msRTT);
+        put(&out[52 * stride], tracebstats.mbpsBandwidth);
+        put(&out[53 * stride], tracebstats.byteAvailSndBuf);
+        put(&out[54 * stride], tracebstats.byteAvailRcvBuf);
+        put(&out[55 * stride], tracebstats.mbpsMaxBW);
+        put(&out[56 * stride], tracebstats.byteMSS);
+        put(&out[57 * stride], tracebstats.pktSndBuf);
+        put(&out[58 * stride], tracebstats.byteSndBuf);
+        put(&out[59 * stride], tracebstats.msSndBuf);
+        put(&out[60 * stride], tracebstats.msSndTsbPdDelay);
+        put(&out[61 * stride], tracebstats.pktRcvBuf);
+        put(&out[62 * stride], tracebstats.byteRcvBuf);
+        put(&out[63 * stride], tracebstats.msRcvBuf);
+        put(&out[64 * stride], tracebstats.msRcvTsbPdDelay);
+        put(&out[65 * stride], tracebstats.pktSndFilterExtraTotal);
+        put(&out[66 * stride], tracebstats.pktRcvFilterExtraTotal);
+        put(&out[67 * stride], tracebstats.pktRcvFilterSupplyTotal);
+        put(&out[68 * stride], tracebstats.pktRcvFilterLossTotal);
+        put(&out[69 * stride], tracebstats.pktSndFilterExtra);
+        put(&out[70 * stride], tracebstats.pktRcvFilterExtra);
+        put(&out[71 * stride], tracebstats.pktRcvFilterSupply);
+        put(&out[72 * stride], tracebstats.pktRcvFilterLoss);
+        put(&out[73 * stride], tracebstats.pktReorderTolerance);
+        put(&out[74 * stride], tracebstats.pktSentUniqueTotal);
+        put(&out[75 * stride], tracebstats.pktRecvUniqueTotal);
+        put(&out[76 * stride], tracebstats.byteSentUniqueTotal);
+        put(&out[77 * stride], tracebstats.byteRecvUniqueTotal);
+        put(&out[78 * stride], tracebstats.pktSentUnique);
+        put(&out[79 * stride], tracebstats.pktRecvUnique);
+        put(&out[80 * stride], tracebstats.byteSentUnique);
+        put(&out[81 * stride], tracebstats.byteRecvUnique);
+    }
+
+    /**
+     * @return true if the field at index field of the layout is a floating point field
+     */
+    static bool isDouble(int field) {
+        static const std::array<bool, LAYOUT_SIZE> isDoubleField = [] {
+            std::array<bool, LAYOUT_SIZE> fields{};
+            write(SRT_TRACEBSTATS{}, fields.data());
+            return fields;
+        }();
+        return (field >= 0) && (field < LAYOUT_SIZE) && isDoubleField[field];
+    }
+
+private:
+    template<typename V>
+    static void put(bool *out, V) {
+        *out = std::is_floating_point<V>::value;
+    }
+
+    template<typename V>
+    static void put(jlong *out, V value) {
+        if constexpr (std::is_floating_point<V>::value) {
+            static_assert(sizeof(V) == sizeof(jlong), "Unexpected floating point size");
+            memcpy(out, &value, sizeof(jlong));
+        } else {
+            *out = (jlong) value;
+        }
+    }
 
-        return srtSocket;
+    template<typename V>
+    static void put(jdouble *out, V value) {
+        *out = (jdouble) value;
     }
-};
\ No newline at end of file
+};
@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "RecvRing.h"
+
+#include <chrono>
+
+#include "log.h"
+#include "Models/ModelsSingleton.h"
+
+// Bounds the time to see a stop request
+static constexpr int POLL_TIMEOUT_IN_MS = 100;
+// Wait for the consumer when the ring is full
+static constexpr int FULL_WAIT_IN_MS = 1;
+
+RecvRing::RecvRing(JNIEnv *env, jobject recvRing, jobject buffer, SRTSOCKET u, int capacity,
+                   int slotSize)
+        : ring(env->GetDirectBufferAddress(buffer), capacity, slotSize), u(u), isRunning(false) {
+    env->GetJavaVM(&(this->vm));
+    for (auto &counter: counters) {
+        counter = 0;
+    }
+
+    if (!SpscRing::isValid(env->GetDirectBufferAddress(buffer),
+                           env->GetDirectBufferCapacity(buffer), capacity, slotSize)) {
+        LOGE("Invalid receive ring buffer");
+        return;
+    }
+
+    eid = srt_epoll_create();
+    if (eid < 0) {
+        LOGE("Can't create receive ring epoll");
+        return;
+    }
+    int events = SRT_EPOLL_IN | SRT_EPOLL_ERR;
+    if (srt_epoll_add_usock(eid, u, &events) != 0) {
+        LOGE("Can't add socket to receive ring epoll: %s", srt_getlasterror_str());
+        return;
+    }
+
+    this->recvRing = env->NewGlobalRef(recvRing);
+    // Keeps the ring memory alive until the pump thread has stopped
+    this->buffer = env->NewGlobalRef(buffer);
+
+    isRunning = true;
+    if (pthread_create(&thread, nullptr, RecvRing::run, this) != 0) {
+        LOGE("Can't create receive ring thread");
+        isRunning = false;
+        return;
+    }
+    hasThread = true;
+}
+
+RecvRing::~RecvRing() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isRunning = false;
+    }
+    wakeUp.notify_all();
+    if (hasThread) {
+        if (pthread_equal(pthread_self(), thread)) {
+            // Deleted by the pump thread itself, see run()
+            pthread_detach(thread);
+        } else {
+            pthread_join(thread, nullptr);
+        }
+    }
+
+    if (eid >= 0) {
+        srt_epoll_release(eid);
+    }
+
+    JNIEnv *env = nullptr;
+    vm->GetEnv((void **) &env, JNI_VERSION_1_6);
+    if (env != nullptr) {
+        if (recvRing != nullptr) {
+            env->DeleteGlobalRef(recvRing);
+        }
+        if (buffer != nullptr) {
+            env->DeleteGlobalRef(buffer);
+        }
+    }
+}
+
+void RecvRing::release() {
+    isRunning = false;
+    if (hasThread && pthread_equal(pthread_self(), thread)) {
+        // Released from a ring callback: the pump thread still uses this object
+        isReleasedByThread = true;
+        return;
+    }
+    delete this;
+}
+
+bool RecvRing::isValid() const {
+    return hasThread;
+}
+
+void RecvRing::getCounters(jlong *counters) const {
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        counters[i] = this->counters[i];
+    }
+}
+
+void *RecvRing::run(void *opaque) {
+    auto *recvRing = static_cast<RecvRing *>(opaque);
+    JNIEnv *env = nullptr;
+
+    JavaVMAttachArgs args = {JNI_VERSION_1_6, "SrtRecvRing", nullptr};
+    if (recvRing->vm->AttachCurrentThread(&env, &args) != JNI_OK) {
+        LOGE("Can't attach receive ring thread");
+        return nullptr;
+    }
+
+    recvRing->loop(env);
+
+    JavaVM *vm = recvRing->vm;
+    if (recvRing->isReleasedByThread) {
+        delete recvRing;
+    }
+    vm->DetachCurrentThread();
+    return nullptr;
+}
+
+void RecvRing::loop(JNIEnv *env) {
+    int error = pump(env);
+    if (error == 0) {
+        return;
+    }
+
+    // Slots are all published: the consumer reads them before it sees the error
+    jstring message = env->NewStringUTF(srt_strerror(error, 0));
+    env->CallVoidMethod(recvRing, ModelsSingleton::getInstance(env)->recvRingOnClosedMethod,
+                        message);
+    if (env->ExceptionCheck()) {
+        LOGE("Exception in receive ring callback");
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+    }
+    env->DeleteLocalRef(message);
+}
+
+int RecvRing::pump(JNIEnv *env) {
+    jmethodID onAvailableMethod = ModelsSingleton::getInstance(env)->recvRingOnAvailableMethod;
+    int32_t head = ring.head().load(std::memory_order_relaxed);
+    int capacity = ring.getCapacity();
+    bool isFull = false;
+    SRT_EPOLL_EVENT event;
+
+    while (isRunning) {
+        if (head - ring.tail().load(std::memory_order_acquire) >= capacity) {
+            // Back pressure: SRT keeps the messages in its receive buffer
+            if (!isFull) {
+                counters[FULL_EVENTS]++;
+                isFull = true;
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeUp.wait_for(lock, std::chrono::milliseconds(FULL_WAIT_IN_MS),
+                            [this] { return !isRunning; });
+            continue;
+        }
+        isFull = false;
+
+        int res = srt_epoll_uwait(eid, &event, 1, POLL_TIMEOUT_IN_MS);
+        if (res < 0) {
+            int error = srt_getlasterror(nullptr);
+            if (error == SRT_ETIMEOUT) {
+                continue;
+            }
+            return error;
+        }
+        if (event.events & SRT_EPOLL_ERR) {
+            return SRT_ECONNLOST;
+        }
+
+        uint8_t *slot = ring.slot(head);
+        SRT_MSGCTRL msgctrl = srt_msgctrl_default;
+        res = srt_recvmsg2(u, (char *) slot + SpscRing::SLOT_PAYLOAD_OFFSET,
+                           ring.getMaxPayloadSize(), &msgctrl);
+        if (res < 0) {
+            int error = srt_getlasterror(nullptr);
+            if (error == SRT_EASYNCRCV) {
+                continue;
+            }
+            return error;
+        }
+        if (res == 0) {
+            continue;
+        }
+
+        SpscRing::put<int32_t>(slot, SpscRing::SLOT_LENGTH_OFFSET, res);
+        SpscRing::put<int32_t>(slot, SpscRing::SLOT_PKTSEQ_OFFSET, msgctrl.pktseq);
+        SpscRing::put<int32_t>(slot, SpscRing::SLOT_MSGNO_OFFSET, msgctrl.msgno);
+        SpscRing::put<int64_t>(slot, SpscRing::SLOT_SRCTIME_OFFSET, msgctrl.srctime);
+        SpscRing::put<int64_t>(slot, SpscRing::SLOT_TIME_OFFSET, srt_time_now());
+        head++;
+        // Sequentially consistent: the head is visible before the consumer state is read
+        ring.head().store(head);
+        counters[RECEIVED_PACKETS]++;
+        counters[RECEIVED_BYTES] += res;
+
+        if ((ring.waiting().load() != 0) && (ring.waiting().exchange(0) != 0)) {
+            env->CallVoidMethod(recvRing, onAvailableMethod);
+            if (env->ExceptionCheck()) {
+                LOGE("Exception in receive ring callback");
+                env->ExceptionDescribe();
+                env->ExceptionClear();
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <jni.h>
+#include <mutex>
+#include <pthread.h>
+
+#include "srt/srt.h"
+
+#include "SpscRing.h"
+
+/**
+ * Native side of RecvRing: a pump thread that receives the messages of a socket with
+ * srt_recvmsg2 into a SpscRing read by Java.
+ *
+ * Java is the consumer. It is only called when it waits for new slots and when the pump stops.
+ */
+class RecvRing {
+public:
+    /**
+     * Counters. Same order as the Java RecvRing.Counters.
+     */
+    enum Counter {
+        RECEIVED_PACKETS = 0,
+        RECEIVED_BYTES,
+        FULL_EVENTS,
+        COUNTER_COUNT
+    };
+
+    /**
+     * Creates the ring and starts its pump thread.
+     *
+     * @param env JNI environment
+     * @param recvRing the Java RecvRing
+     * @param buffer the direct ByteBuffer that holds the ring
+     * @param u the socket to receive from
+     * @param capacity the number of slots
+     * @param slotSize the size of a slot
+     */
+    RecvRing(JNIEnv *env, jobject recvRing, jobject buffer, SRTSOCKET u, int capacity,
+             int slotSize);
+
+    /**
+     * Stops the pump thread. Use release() once the pump thread has been created.
+     */
+    ~RecvRing();
+
+    /**
+     * Stops the pump thread and deletes the ring. If it is called from a ring callback, the pump
+     * thread deletes the ring once the callback has returned.
+     */
+    void release();
+
+    /**
+     * @return true if the pump thread has been created
+     */
+    bool isValid() const;
+
+    /**
+     * @param counters where the COUNTER_COUNT counters are written to
+     */
+    void getCounters(jlong *counters) const;
+
+private:
+    JavaVM *vm = nullptr;
+    jobject recvRing = nullptr;
+    jobject buffer = nullptr;
+    SpscRing ring;
+    SRTSOCKET u;
+    int eid = SRT_ERROR;
+    pthread_t thread;
+    bool hasThread = false;
+    std::atomic<bool> isRunning;
+    // Only accessed by the pump thread
+    bool isReleasedByThread = false;
+    std::atomic<int64_t> counters[COUNTER_COUNT];
+
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+
+    static void *run(void *opaque);
+
+    void loop(JNIEnv *env);
+
+    /**
+     * @return the SRT error that stopped the pump, 0 if it has been stopped by the destructor
+     */
+    int pump(JNIEnv *env);
+};
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Relay.h"
+
+#include "log.h"
+#include "Enums/EnumsSingleton.h"
+#include "Models/ModelsSingleton.h"
+
+// Bounds the time to see a stop request
+static constexpr int POLL_TIMEOUT_IN_MS = 100;
+
+Relay::Relay(JNIEnv *env, jobject relay, SRTSOCKET input, int maxPayloadSize)
+        : input(input), buffer(maxPayloadSize > 0 ? maxPayloadSize : 0), isRunning(false) {
+    env->GetJavaVM(&(this->vm));
+    for (auto &counter: counters) {
+        counter = 0;
+    }
+
+    if (maxPayloadSize <= 0) {
+        LOGE("Invalid relay payload size");
+        return;
+    }
+
+    eid = srt_epoll_create();
+    if (eid < 0) {
+        LOGE("Can't create relay epoll");
+        return;
+    }
+    int events = SRT_EPOLL_IN | SRT_EPOLL_ERR;
+    if (srt_epoll_add_usock(eid, input, &events) != 0) {
+        LOGE("Can't add input to relay epoll: %s", srt_getlasterror_str());
+        return;
+    }
+
+    this->relay = env->NewGlobalRef(relay);
+
+    isRunning = true;
+    if (pthread_create(&thread, nullptr, Relay::run, this) != 0) {
+        LOGE("Can't create relay thread");
+        isRunning = false;
+        return;
+    }
+    hasThread = true;
+}
+
+Relay::~Relay() {
+    isRunning = false;
+    if (hasThread) {
+        if (pthread_equal(pthread_self(), thread)) {
+            // Deleted by the relay thread itself, see run()
+            pthread_detach(thread);
+        } else {
+            pthread_join(thread, nullptr);
+        }
+    }
+
+    if (eid >= 0) {
+        srt_epoll_release(eid);
+    }
+
+    JNIEnv *env = nullptr;
+    vm->GetEnv((void **) &env, JNI_VERSION_1_6);
+    if ((env != nullptr) && (relay != nullptr)) {
+        env->DeleteGlobalRef(relay);
+    }
+}
+
+void Relay::release() {
+    isRunning = false;
+    if (hasThread && pthread_equal(pthread_self(), thread)) {
+        // Released from a relay callback: the relay thread still uses this object
+        isReleasedByThread = true;
+        return;
+    }
+    delete this;
+}
+
+bool Relay::isValid() const {
+    return hasThread;
+}
+
+FanOutGroup &Relay::getOutputs() {
+    return outputs;
+}
+
+void Relay::getCounters(jlong *counters) const {
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        counters[i] = this->counters[i];
+    }
+}
+
+void *Relay::run(void *opaque) {
+    auto *relay = static_cast<Relay *>(opaque);
+    JNIEnv *env = nullptr;
+
+    JavaVMAttachArgs args = {JNI_VERSION_1_6, "SrtRelay", nullptr};
+    if (relay->vm->AttachCurrentThread(&env, &args) != JNI_OK) {
+        LOGE("Can't attach relay thread");
+        return nullptr;
+    }
+
+    relay->loop(env);
+
+    JavaVM *vm = relay->vm;
+    if (relay->isReleasedByThread) {
+        delete relay;
+    }
+    vm->DetachCurrentThread();
+    return nullptr;
+}
+
+void Relay::loop(JNIEnv *env) {
+    int error = forward(env);
+    if (error == 0) {
+        return;
+    }
+
+    jobject errorType = EnumsSingleton::getInstance(env)->errorType->getJavaValue(
+            env, (SRT_ERRNO) error);
+    env->CallVoidMethod(relay, ModelsSingleton::getInstance(env)->relayOnInputClosedMethod,
+                        errorType);
+    if (env->ExceptionCheck()) {
+        LOGE("Exception in relay callback");
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+    }
+    env->DeleteLocalRef(errorType);
+}
+
+int Relay::forward(JNIEnv *env) {
+    std::vector<FanOutGroup::Eviction> evictions;
+    SRT_EPOLL_EVENT event;
+
+    while (isRunning) {
+        int res = srt_epoll_uwait(eid, &event, 1, POLL_TIMEOUT_IN_MS);
+        if (res < 0) {
+            int error = srt_getlasterror(nullptr);
+            if (error == SRT_ETIMEOUT) {
+                continue;
+            }
+            return error;
+        }
+        if (event.events & SRT_EPOLL_ERR) {
+            return SRT_ECONNLOST;
+        }
+
+        SRT_MSGCTRL msgctrl = srt_msgctrl_default;
+        res = srt_recvmsg2(input, buffer.data(), (int) buffer.size(), &msgctrl);
+        if (res < 0) {
+            int error = srt_getlasterror(nullptr);
+            if (error == SRT_EASYNCRCV) {
+                continue;
+            }
+            return error;
+        }
+        if (res == 0) {
+            continue;
+        }
+        int64_t recvTime = srt_time_now();
+        counters[RECEIVED_PACKETS]++;
+        counters[RECEIVED_BYTES] += res;
+
+        // Only the source time is carried: outputs number their own messages
+        SRT_MSGCTRL outputMsgctrl = srt_msgctrl_default;
+        outputMsgctrl.srctime = msgctrl.srctime;
+        int nOutputs = 0;
+        int nSent = outputs.send(buffer.data(), res, &outputMsgctrl, evictions, &nOutputs);
+
+        int64_t latency = srt_time_now() - recvTime;
+        counters[SENT_PACKETS] += nSent;
+        counters[DROPPED_PACKETS] += nOutputs - nSent;
+        counters[LATENCY_SUM_US] += latency;
+        if (latency > counters[LATENCY_MAX_US]) {
+            counters[LATENCY_MAX_US] = latency;
+        }
+
+        for (const auto &eviction: evictions) {
+            if (!isRunning) {
+                // Released by a previous callback
+                break;
+            }
+            onOutputEvicted(env, eviction);
+        }
+        evictions.clear();
+    }
+
+    return 0;
+}
+
+void Relay::onOutputEvicted(JNIEnv *env, const FanOutGroup::Eviction &eviction) {
+    jobject errorType = EnumsSingleton::getInstance(env)->errorType->getJavaValue(
+            env, (SRT_ERRNO) eviction.error);
+    env->CallVoidMethod(relay, ModelsSingleton::getInstance(env)->relayOnOutputEvictedMethod,
+                        eviction.u, errorType);
+    if (env->ExceptionCheck()) {
+        LOGE("Exception in relay callback");
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+    }
+    env->DeleteLocalRef(errorType);
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <jni.h>
+#include <pthread.h>
+#include <vector>
+
+#include "srt/srt.h"
+
+#include "FanOutGroup.h"
+
+/**
+ * Native side of Relay: a thread that forwards the messages of an input socket to output sockets
+ * without going through the JVM.
+ *
+ * Messages are received with srt_recvmsg2 and sent with srt_sendmsg2 with their source time, so
+ * the input timing is carried to the outputs. Outputs are a FanOutGroup.
+ */
+class Relay {
+public:
+    /**
+     * Counters. Same order as the Java Relay.Counters.
+     */
+    enum Counter {
+        RECEIVED_PACKETS = 0,
+        RECEIVED_BYTES,
+        SENT_PACKETS,
+        DROPPED_PACKETS,
+        LATENCY_SUM_US,
+        LATENCY_MAX_US,
+        COUNTER_COUNT
+    };
+
+    /**
+     * Creates the relay and starts its thread.
+     *
+     * @param env JNI environment
+     * @param relay the Java Relay
+     * @param input the socket to receive from
+     * @param maxPayloadSize the maximum size of a message
+     */
+    Relay(JNIEnv *env, jobject relay, SRTSOCKET input, int maxPayloadSize);
+
+    /**
+     * Stops the relay thread. Use release() once the relay thread has been created.
+     */
+    ~Relay();
+
+    /**
+     * Stops the relay thread and deletes the relay. If it is called from a relay callback, the
+     * relay thread deletes the relay once the callback has returned.
+     */
+    void release();
+
+    /**
+     * @return true if the relay thread has been created
+     */
+    bool isValid() const;
+
+    FanOutGroup &getOutputs();
+
+    /**
+     * @param counters where the COUNTER_COUNT counters are written to
+     */
+    void getCounters(jlong *counters) const;
+
+private:
+    JavaVM *vm = nullptr;
+    jobject relay = nullptr;
+    SRTSOCKET input;
+    int eid = SRT_ERROR;
+    std::vector<char> buffer;
+    FanOutGroup outputs;
+    pthread_t thread;
+    bool hasThread = false;
+    std::atomic<bool> isRunning;
+    // Only accessed by the relay thread
+    bool isReleasedByThread = false;
+    std::atomic<int64_t> counters[COUNTER_COUNT];
+
+    static void *run(void *opaque);
+
+    void loop(JNIEnv *env);
+
+    /**
+     * @return the SRT error that stopped the relay, 0 if it has been stopped by the destructor
+     */
+    int forward(JNIEnv *env);
+
+    void onOutputEvicted(JNIEnv *env, const FanOutGroup::Eviction &eviction);
+};
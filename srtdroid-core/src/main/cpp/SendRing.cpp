@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "SendRing.h"
+
+#include <chrono>
+
+#include "log.h"
+
+// Bounds the wake-up delay if a wake() is missed
+static constexpr int MAX_WAIT_IN_MS = 10;
+
+SendRing::SendRing(JNIEnv *env, jobject buffer, SRTSOCKET u, int capacity, int slotSize)
+        : ring(env->GetDirectBufferAddress(buffer), capacity, slotSize), u(u), isRunning(false) {
+    env->GetJavaVM(&(this->vm));
+    for (auto &counter: counters) {
+        counter = 0;
+    }
+
+    if (!SpscRing::isValid(env->GetDirectBufferAddress(buffer),
+                           env->GetDirectBufferCapacity(buffer), capacity, slotSize)) {
+        LOGE("Invalid send ring buffer");
+        return;
+    }
+
+    // Keeps the ring memory alive until the drain thread has stopped
+    this->buffer = env->NewGlobalRef(buffer);
+
+    isRunning = true;
+    if (pthread_create(&thread, nullptr, SendRing::run, this) != 0) {
+        LOGE("Can't create send ring thread");
+        isRunning = false;
+        return;
+    }
+    hasThread = true;
+}
+
+SendRing::~SendRing() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isRunning = false;
+    }
+    wakeUp.notify_all();
+    if (hasThread) {
+        pthread_join(thread, nullptr);
+    }
+
+    JNIEnv *env = nullptr;
+    vm->GetEnv((void **) &env, JNI_VERSION_1_6);
+    if ((env != nullptr) && (buffer != nullptr)) {
+        env->DeleteGlobalRef(buffer);
+    }
+}
+
+bool SendRing::isValid() const {
+    return hasThread;
+}
+
+void SendRing::wake() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ring.waiting().store(0);
+    }
+    wakeUp.notify_all();
+}
+
+void SendRing::getCounters(jlong *counters) const {
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        counters[i] = this->counters[i];
+    }
+}
+
+void *SendRing::run(void *opaque) {
+    auto *sendRing = static_cast<SendRing *>(opaque);
+    JNIEnv *env = nullptr;
+
+    // Attached so that the thread is visible to the runtime (name, traces)
+    JavaVMAttachArgs args = {JNI_VERSION_1_6, "SrtSendRing", nullptr};
+    if (sendRing->vm->AttachCurrentThread(&env, &args) != JNI_OK) {
+        LOGE("Can't attach send ring thread");
+        return nullptr;
+    }
+
+    sendRing->loop();
+
+    sendRing->vm->DetachCurrentThread();
+    return nullptr;
+}
+
+void SendRing::loop() {
+    int32_t tail = ring.tail().load(std::memory_order_relaxed);
+
+    while (isRunning) {
+        int32_t head = ring.head().load(std::memory_order_acquire);
+        if (head == tail) {
+            // Announces the wait before checking again, so a producer either sees the flag or
+            // its slot is seen here.
+            ring.waiting().store(1);
+            head = ring.head().load();
+            if (head == tail) {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeUp.wait_for(lock, std::chrono::milliseconds(MAX_WAIT_IN_MS),
+                                [this] { return !isRunning || (ring.waiting().load() == 0); });
+            }
+            ring.waiting().store(0);
+            continue;
+        }
+
+        while ((tail != head) && isRunning) {
+            send(ring.slot(tail));
+            tail++;
+            ring.tail().store(tail, std::memory_order_release);
+        }
+    }
+}
+
+void SendRing::send(const uint8_t *slot) {
+    auto length = SpscRing::get<int32_t>(slot, SpscRing::SLOT_LENGTH_OFFSET);
+    auto time = SpscRing::get<int64_t>(slot, SpscRing::SLOT_TIME_OFFSET);
+    // The ring lives in a Java buffer: never trust a slot
+    if ((length <= 0) || (length > ring.getMaxPayloadSize())) {
+        counters[SEND_FAILURES]++;
+        return;
+    }
+
+    SRT_MSGCTRL msgctrl = srt_msgctrl_default;
+    msgctrl.msgttl = SpscRing::get<int32_t>(slot, SpscRing::SLOT_TTL_OFFSET);
+    msgctrl.srctime = SpscRing::get<int64_t>(slot, SpscRing::SLOT_SRCTIME_OFFSET);
+    if (msgctrl.srctime == 0) {
+        // Queueing time must not shift the packet delivery time
+        msgctrl.srctime = time;
+    }
+
+    int res = srt_sendmsg2(u, (const char *) slot + SpscRing::SLOT_PAYLOAD_OFFSET, length,
+                           &msgctrl);
+    if (res <= 0) {
+        counters[SEND_FAILURES]++;
+        return;
+    }
+
+    int64_t latency = srt_time_now() - time;
+    counters[SENT_PACKETS]++;
+    counters[SENT_BYTES] += res;
+    counters[DRAIN_LATENCY_SUM_US] += latency;
+    int64_t maxLatency = counters[DRAIN_LATENCY_MAX_US];
+    while ((latency > maxLatency) &&
+           !counters[DRAIN_LATENCY_MAX_US].compare_exchange_weak(maxLatency, latency)) {
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <jni.h>
+#include <mutex>
+#include <pthread.h>
+
+#include "srt/srt.h"
+
+#include "SpscRing.h"
+
+/**
+ * Native side of SendRing: a thread that drains a SpscRing filled by Java into srt_sendmsg2.
+ *
+ * Java is the producer and only calls wake() when the drain thread waits for new slots.
+ */
+class SendRing {
+public:
+    /**
+     * Counters. Same order as the Java SendRing.Counters.
+     */
+    enum Counter {
+        SENT_PACKETS = 0,
+        SENT_BYTES,
+        SEND_FAILURES,
+        DRAIN_LATENCY_SUM_US,
+        DRAIN_LATENCY_MAX_US,
+        COUNTER_COUNT
+    };
+
+    /**
+     * Creates the ring and starts its drain thread.
+     *
+     * @param env JNI environment
+     * @param buffer the direct ByteBuffer that holds the ring
+     * @param u the socket to send to
+     * @param capacity the number of slots
+     * @param slotSize the size of a slot
+     */
+    SendRing(JNIEnv *env, jobject buffer, SRTSOCKET u, int capacity, int slotSize);
+
+    /**
+     * Stops the drain thread. Slots that have not been sent yet are discarded.
+     */
+    ~SendRing();
+
+    /**
+     * @return true if the drain thread has been created
+     */
+    bool isValid() const;
+
+    /**
+     * Wakes up the drain thread.
+     */
+    void wake();
+
+    /**
+     * @param counters where the COUNTER_COUNT counters are written to
+     */
+    void getCounters(jlong *counters) const;
+
+private:
+    JavaVM *vm = nullptr;
+    jobject buffer = nullptr;
+    SpscRing ring;
+    SRTSOCKET u;
+    pthread_t thread;
+    bool hasThread = false;
+    std::atomic<bool> isRunning;
+    std::atomic<int64_t> counters[COUNTER_COUNT];
+
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+
+    static void *run(void *opaque);
+
+    void loop();
+
+    void send(const uint8_t *slot);
+};
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <vector>
+
+#include "SendWatermark.h"
+#include "log.h"
+#include "Models/ModelsSingleton.h"
+#include "SocketRegistry.h"
+
+SendWatermark *SendWatermark::getInstance() {
+    static SendWatermark instance;
+    return &instance;
+}
+
+int SendWatermark::set(JNIEnv *env, SRTSOCKET u, Metric metric, int64_t low, int64_t high,
+                       int intervalInMs) {
+    if (intervalInMs <= 0) {
+        LOGE("Invalid watermark interval");
+        return -1;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!startThread(env)) {
+            return -1;
+        }
+
+        Watermark &watermark = watermarks[u];
+        watermark.metric = metric;
+        watermark.low = low;
+        watermark.high = high;
+        watermark.interval = std::chrono::milliseconds(intervalInMs);
+        watermark.nextCheck = Clock::now() + watermark.interval;
+        watermark.isHigh = false;
+    }
+    wakeUp.notify_all();
+    return 0;
+}
+
+void SendWatermark::remove(SRTSOCKET u) {
+    std::lock_guard<std::mutex> lock(mutex);
+    watermarks.erase(u);
+}
+
+bool SendWatermark::startThread(JNIEnv *env) {
+    if (hasThread) {
+        return true;
+    }
+
+    env->GetJavaVM(&vm);
+    pthread_t thread;
+    if (pthread_create(&thread, nullptr, SendWatermark::run, this) != 0) {
+        LOGE("Can't create watermark thread");
+        return false;
+    }
+    // Lives as long as the process, like the instance
+    pthread_detach(thread);
+    hasThread = true;
+    return true;
+}
+
+int64_t SendWatermark::getLevel(SRTSOCKET u, Metric metric) {
+    size_t blocks = 0;
+    size_t bytes = 0;
+    // Returns the buffer timespan in milliseconds
+    int timespan = srt_getsndbuffer(u, &blocks, &bytes);
+    if (timespan < 0) {
+        return -1;
+    }
+
+    switch (metric) {
+        case PACKETS:
+            return (int64_t) blocks;
+        case BYTES:
+            return (int64_t) bytes;
+        default:
+            return timespan;
+    }
+}
+
+void *SendWatermark::run(void *opaque) {
+    auto *sendWatermark = static_cast<SendWatermark *>(opaque);
+    JNIEnv *env = nullptr;
+
+    JavaVMAttachArgs args = {JNI_VERSION_1_6, "SrtSendWatermark", nullptr};
+    if (sendWatermark->vm->AttachCurrentThread(&env, &args) != JNI_OK) {
+        LOGE("Can't attach watermark thread");
+        std::lock_guard<std::mutex> lock(sendWatermark->mutex);
+        // Next set() tries again
+        sendWatermark->hasThread = false;
+        return nullptr;
+    }
+
+    sendWatermark->loop(env);
+
+    sendWatermark->vm->DetachCurrentThread();
+    return nullptr;
+}
+
+void SendWatermark::loop(JNIEnv *env) {
+    struct Crossing {
+        SRTSOCKET u;
+        bool isHigh;
+        int64_t level;
+    };
+
+    jmethodID onWatermarkMethod = ModelsSingleton::getInstance(
+            env)->srtSocketOnSendBufferWatermarkMethod;
+    std::vector<Crossing> crossings;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        if (watermarks.empty()) {
+            wakeUp.wait(lock, [this] { return !watermarks.empty(); });
+        }
+
+        Clock::time_point nextCheck = Clock::time_point::max();
+        for (auto &it: watermarks) {
+            nextCheck = std::min(nextCheck, it.second.nextCheck);
+        }
+        // set() and remove() change the schedule: compute it again when woken up
+        if (wakeUp.wait_until(lock, nextCheck) == std::cv_status::no_timeout) {
+            continue;
+        }
+
+        Clock::time_point now = Clock::now();
+        for (auto it = watermarks.begin(); it != watermarks.end();) {
+            Watermark &watermark = it->second;
+            if (watermark.nextCheck > now) {
+                ++it;
+                continue;
+            }
+            watermark.nextCheck = now + watermark.interval;
+
+            int64_t level = getLevel(it->first, watermark.metric);
+            if (level < 0) {
+                // Closed behind our back
+                it = watermarks.erase(it);
+                continue;
+            }
+
+            if ((level >= watermark.high) && !watermark.isHigh) {
+                watermark.isHigh = true;
+                crossings.push_back({it->first, true, level});
+            } else if ((level <= watermark.low) && watermark.isHigh) {
+                watermark.isHigh = false;
+                crossings.push_back({it->first, false, level});
+            }
+            ++it;
+        }
+
+        if (crossings.empty()) {
+            continue;
+        }
+
+        // Java listeners may reconfigure the watermarks or close sockets
+        lock.unlock();
+        for (const Crossing &crossing: crossings) {
+            jobject srtSocket = SocketRegistry::getInstance()->getJava(env, crossing.u);
+            if (srtSocket == nullptr) {
+                continue;
+            }
+            env->CallVoidMethod(srtSocket, onWatermarkMethod, (jboolean) crossing.isHigh,
+                                (jlong) crossing.level);
+            if (env->ExceptionCheck()) {
+                LOGE("Exception in send buffer watermark listener");
+                env->ExceptionDescribe();
+                env->ExceptionClear();
+            }
+            env->DeleteLocalRef(srtSocket);
+        }
+        crossings.clear();
+        lock.lock();
+    }
+}
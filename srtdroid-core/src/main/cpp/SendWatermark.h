@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <jni.h>
+#include <mutex>
+#include <pthread.h>
+#include <unordered_map>
+
+#include "srt/srt.h"
+
+/**
+ * High and low watermarks on the send buffer occupancy of sockets.
+ *
+ * A single process-wide thread checks the occupancy of every watched socket, so senders pay
+ * nothing for it and watching more sockets does not add threads: crossing the high watermark and
+ * then going back under the low watermark are reported once each to the Java SrtSocket, from the
+ * watermark thread. The thread is started with the first watermark and waits while no socket is
+ * watched.
+ */
+class SendWatermark {
+public:
+    /**
+     * Units of the send buffer occupancy. Same order as the Java SendBufferMetric.
+     */
+    enum Metric {
+        MS = 0,
+        PACKETS,
+        BYTES
+    };
+
+    static SendWatermark *getInstance();
+
+    /**
+     * Sets the watermarks of a socket. The crossing state of the socket is reset.
+     *
+     * @param env JNI environment
+     * @param u the sender socket
+     * @param metric the unit of low and high
+     * @param low the low watermark
+     * @param high the high watermark
+     * @param intervalInMs the occupancy check interval of this socket
+     * @return 0 on success, -1 if the watermark thread can't be started
+     */
+    int set(JNIEnv *env, SRTSOCKET u, Metric metric, int64_t low, int64_t high,
+            int intervalInMs);
+
+    /**
+     * Stops watching a socket. Nothing happens if it is not watched.
+     *
+     * @param u the SRT socket
+     */
+    void remove(SRTSOCKET u);
+
+    /**
+     * Gets the send buffer occupancy without building statistics.
+     *
+     * @param u the SRT socket
+     * @param metric the unit
+     * @return the occupancy or -1 on error
+     */
+    static int64_t getLevel(SRTSOCKET u, Metric metric);
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Watermark {
+        Metric metric;
+        int64_t low;
+        int64_t high;
+        std::chrono::milliseconds interval;
+        Clock::time_point nextCheck;
+        bool isHigh = false;
+    };
+
+    JavaVM *vm = nullptr;
+    bool hasThread = false;
+
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::unordered_map<SRTSOCKET, Watermark> watermarks;
+
+    SendWatermark() = default;
+
+    /**
+     * Must hold the lock.
+     */
+    bool startThread(JNIEnv *env);
+
+    static void *run(void *opaque);
+
+    void loop(JNIEnv *env);
+};
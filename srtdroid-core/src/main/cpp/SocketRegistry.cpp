@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "SocketRegistry.h"
+#include "Models/ModelsSingleton.h"
+
+
+SocketRegistry *SocketRegistry::getInstance() {
+    static SocketRegistry instance;
+    return &instance;
+}
+
+void SocketRegistry::put(JNIEnv *env, SRTSOCKET u, jobject srtSocket) {
+    if (u == SRT_INVALID_SOCK) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Entry &entry = insert(u);
+        if (entry.srtSocket != nullptr) {
+            env->DeleteWeakGlobalRef(entry.srtSocket);
+        }
+        entry.srtSocket = env->NewWeakGlobalRef(srtSocket);
+    }
+    purgeIfDue(env);
+}
+
+jobject SocketRegistry::getJava(JNIEnv *env, SRTSOCKET u) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(u);
+        if ((it != entries.end()) && (it->second.srtSocket != nullptr)) {
+            // Null if the SrtSocket has been garbage collected
+            jobject srtSocket = env->NewLocalRef(it->second.srtSocket);
+            if (srtSocket != nullptr) {
+                return srtSocket;
+            }
+        }
+    }
+
+    // Not under the lock: the SrtSocket constructor runs Java code
+    ModelsSingleton *models = ModelsSingleton::getInstance(env);
+    jobject srtSocket = env->NewObject(models->srtSocketClazz, models->srtSocketConstructorMethod,
+                                       u);
+    if ((srtSocket == nullptr) || (u == SRT_INVALID_SOCK)) {
+        return srtSocket;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Entry &entry = insert(u);
+        if (entry.srtSocket != nullptr) {
+            // Another thread might have registered a SrtSocket in the meantime
+            jobject registeredSrtSocket = env->NewLocalRef(entry.srtSocket);
+            if (registeredSrtSocket != nullptr) {
+                env->DeleteLocalRef(srtSocket);
+                srtSocket = registeredSrtSocket;
+            } else {
+                env->DeleteWeakGlobalRef(entry.srtSocket);
+                entry.srtSocket = env->NewWeakGlobalRef(srtSocket);
+            }
+        } else {
+            entry.srtSocket = env->NewWeakGlobalRef(srtSocket);
+        }
+    }
+    purgeIfDue(env);
+
+    return srtSocket;
+}
+
+void SocketRegistry::setUserData(JNIEnv *env, SRTSOCKET u, void *userData,
+                                 UserDataDeleter deleter, Slot slot) {
+    std::shared_ptr<void> data;
+    if (userData != nullptr) {
+        data = std::shared_ptr<void>(userData, [deleter](void *d) {
+            if (deleter != nullptr) {
+                deleter(d);
+            }
+        });
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // The previous data is released when data goes out of scope, out of the lock
+        insert(u).userData[slot].swap(data);
+    }
+    purgeIfDue(env);
+}
+
+std::shared_ptr<void> SocketRegistry::getUserData(SRTSOCKET u, Slot slot) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(u);
+    if (it == entries.end()) {
+        return nullptr;
+    }
+    return it->second.userData[slot];
+}
+
+void SocketRegistry::remove(JNIEnv *env, SRTSOCKET u) {
+    std::vector<std::shared_ptr<void>> garbage;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(u);
+    if (it != entries.end()) {
+        release(env, it->second, garbage);
+        entries.erase(it);
+    }
+    // garbage is destroyed after the lock is released
+}
+
+SocketRegistry::Entry &SocketRegistry::insert(SRTSOCKET u) {
+    auto it = entries.find(u);
+    if (it != entries.end()) {
+        return it->second;
+    }
+
+    if (--insertionsBeforePurge <= 0) {
+        isPurgeDue = true;
+        insertionsBeforePurge = PURGE_PERIOD;
+    }
+    return entries[u];
+}
+
+void SocketRegistry::release(JNIEnv *env, Entry &entry,
+                             std::vector<std::shared_ptr<void>> &garbage) {
+    if (entry.srtSocket != nullptr) {
+        env->DeleteWeakGlobalRef(entry.srtSocket);
+        entry.srtSocket = nullptr;
+    }
+    for (auto &userData: entry.userData) {
+        if (userData != nullptr) {
+            garbage.push_back(std::move(userData));
+        }
+    }
+}
+
+void SocketRegistry::purgeIfDue(JNIEnv *env) {
+    std::vector<SRTSOCKET> sockets;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!isPurgeDue) {
+            return;
+        }
+        isPurgeDue = false;
+        sockets.reserve(entries.size());
+        for (auto &entry: entries) {
+            sockets.push_back(entry.first);
+        }
+    }
+
+    // srt_getsockstate takes SRT locks: not under the registry lock
+    std::vector<std::pair<SRTSOCKET, SRT_SOCKSTATUS>> candidates;
+    for (SRTSOCKET u: sockets) {
+        SRT_SOCKSTATUS status = srt_getsockstate(u);
+        if ((status == SRTS_CLOSED) || (status == SRTS_NONEXIST) || (status == SRTS_BROKEN)) {
+            candidates.emplace_back(u, status);
+        }
+    }
+    if (candidates.empty()) {
+        return;
+    }
+
+    std::vector<std::shared_ptr<void>> garbage;
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto &candidate: candidates) {
+        auto it = entries.find(candidate.first);
+        if (it == entries.end()) {
+            continue;
+        }
+        // A broken socket is only dead once its SrtSocket has been garbage collected
+        bool isDead = (candidate.second != SRTS_BROKEN) ||
+                      ((it->second.srtSocket != nullptr) &&
+                       env->IsSameObject(it->second.srtSocket, nullptr));
+        if (isDead) {
+            release(env, it->second, garbage);
+            entries.erase(it);
+        }
+    }
+    // garbage is destroyed after the lock is released
+}
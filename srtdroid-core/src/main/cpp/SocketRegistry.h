@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <jni.h>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "srt/srt.h"
+
+/**
+ * Maps SRT sockets to their Java SrtSocket and to native per-socket data.
+ *
+ * Java objects are held with weak global references so the registry never keeps a SrtSocket
+ * alive: a socket surfaced several times by native code (accept, epoll, callbacks) is the same
+ * SrtSocket as long as the application keeps it.
+ * Entries are removed when the socket is closed. Entries of sockets that have been closed
+ * or broken behind our back are purged when new entries are added.
+ *
+ * User data is reference counted: an SRT callback that got user data keeps it alive even if the
+ * socket is closed meanwhile. Deleters never run under the registry lock.
+ */
+class SocketRegistry {
+public:
+    typedef void (*UserDataDeleter)(void *userData);
+
+    /**
+     * Independent user data slots of a socket.
+     */
+    enum Slot {
+        APPLICATION = 0,
+        LISTEN_CALLBACK,
+        CONNECT_CALLBACK,
+        ADMISSION_CONTROL,
+        SLOT_COUNT
+    };
+
+    static SocketRegistry *getInstance();
+
+    /**
+     * Registers the Java SrtSocket of a socket.
+     *
+     * @param env JNI environment
+     * @param u the SRT socket
+     * @param srtSocket the Java SrtSocket
+     */
+    void put(JNIEnv *env, SRTSOCKET u, jobject srtSocket);
+
+    /**
+     * Gets the Java SrtSocket of a socket. It is created and registered if it does not exist.
+     *
+     * @param env JNI environment
+     * @param u the SRT socket
+     * @return a local reference to the Java SrtSocket
+     */
+    jobject getJava(JNIEnv *env, SRTSOCKET u);
+
+    /**
+     * Attaches native data to a socket. Previous data is deleted.
+     *
+     * @param env JNI environment
+     * @param u the SRT socket
+     * @param userData the data
+     * @param deleter called on userData when the entry is removed or on replacement. Might be null.
+     * @param slot the slot of the data
+     */
+    void setUserData(JNIEnv *env, SRTSOCKET u, void *userData, UserDataDeleter deleter,
+                     Slot slot = APPLICATION);
+
+    /**
+     * @param u the SRT socket
+     * @param slot the slot of the data
+     * @return a reference to the data attached to the socket or null
+     */
+    std::shared_ptr<void> getUserData(SRTSOCKET u, Slot slot = APPLICATION);
+
+    /**
+     * Removes a socket: its Java reference is released and its data is deleted.
+     *
+     * @param env JNI environment
+     * @param u the SRT socket
+     */
+    void remove(JNIEnv *env, SRTSOCKET u);
+
+private:
+    struct Entry {
+        jweak srtSocket = nullptr;
+        std::shared_ptr<void> userData[SLOT_COUNT];
+    };
+
+    /**
+     * Number of insertions between two purges of dead entries.
+     */
+    static const int PURGE_PERIOD = 64;
+
+    std::mutex mutex;
+    std::unordered_map<SRTSOCKET, Entry> entries;
+    int insertionsBeforePurge = PURGE_PERIOD;
+    bool isPurgeDue = false;
+
+    SocketRegistry() = default;
+
+    /**
+     * Must hold the lock.
+     */
+    Entry &insert(SRTSOCKET u);
+
+    /**
+     * Must hold the lock. User data is moved to garbage, to be released out of the lock.
+     */
+    static void release(JNIEnv *env, Entry &entry, std::vector<std::shared_ptr<void>> &garbage);
+
+    /**
+     * Must not hold the lock.
+     */
+    void purgeIfDue(JNIEnv *env);
+};
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * A single-producer single-consumer ring of fixed size slots, shared with Java in a direct
+ * ByteBuffer. Must be kept in sync with SpscRing.kt.
+ *
+ * The buffer starts with a header that holds the indexes, then the slots. Indexes are free running
+ * 32 bits counters: a slot index is the counter modulo the capacity, which is a power of 2. Each
+ * index has its own cache line as it is written by a single side.
+ */
+class SpscRing {
+public:
+    /** Next index to write, written by the producer */
+    static constexpr int HEAD_OFFSET = 0;
+    /** Next index to read, written by the consumer */
+    static constexpr int TAIL_OFFSET = 64;
+    /** Non zero when the consumer waits for the producer */
+    static constexpr int WAITING_OFFSET = 128;
+    static constexpr int HEADER_SIZE = 192;
+
+    /** Slot fields */
+    static constexpr int SLOT_LENGTH_OFFSET = 0;
+    static constexpr int SLOT_TTL_OFFSET = 4;
+    static constexpr int SLOT_PKTSEQ_OFFSET = 8;
+    static constexpr int SLOT_MSGNO_OFFSET = 12;
+    static constexpr int SLOT_SRCTIME_OFFSET = 16;
+    /** Time the slot has been published, in microseconds on the monotonic clock */
+    static constexpr int SLOT_TIME_OFFSET = 24;
+    static constexpr int SLOT_PAYLOAD_OFFSET = 32;
+
+    /**
+     * @param address the buffer address. It must be 8 bytes aligned.
+     * @param capacity the number of slots. It must be a power of 2.
+     * @param slotSize the size of a slot, header included. It must be a multiple of 8.
+     */
+    SpscRing(void *address, int capacity, int slotSize)
+            : address(static_cast<uint8_t *>(address)), capacity(capacity), slotSize(slotSize) {
+    }
+
+    /**
+     * @return true if the buffer address and geometry can be used
+     */
+    static bool isValid(void *address, int64_t bufferSize, int capacity, int slotSize) {
+        return (address != nullptr) && ((reinterpret_cast<uintptr_t>(address) % 8) == 0) &&
+               (capacity > 0) && ((capacity & (capacity - 1)) == 0) &&
+               (slotSize > SLOT_PAYLOAD_OFFSET) && ((slotSize % 8) == 0) &&
+               (bufferSize >= HEADER_SIZE + (int64_t) capacity * slotSize);
+    }
+
+    std::atomic<int32_t> &head() const {
+        return index(HEAD_OFFSET);
+    }
+
+    std::atomic<int32_t> &tail() const {
+        return index(TAIL_OFFSET);
+    }
+
+    std::atomic<int32_t> &waiting() const {
+        return index(WAITING_OFFSET);
+    }
+
+    uint8_t *slot(int32_t index) const {
+        return address + HEADER_SIZE + (int64_t) (index & (capacity - 1)) * slotSize;
+    }
+
+    int getCapacity() const {
+        return capacity;
+    }
+
+    int getMaxPayloadSize() const {
+        return slotSize - SLOT_PAYLOAD_OFFSET;
+    }
+
+    template<typename T>
+    static T get(const uint8_t *slot, int offset) {
+        return *reinterpret_cast<const T *>(slot + offset);
+    }
+
+    template<typename T>
+    static void put(uint8_t *slot, int offset, T value) {
+        *reinterpret_cast<T *>(slot + offset) = value;
+    }
+
+private:
+    uint8_t *address;
+    int capacity;
+    int slotSize;
+
+    static_assert(sizeof(std::atomic<int32_t>) == sizeof(int32_t), "Index must be a plain int");
+    static_assert(std::atomic<int32_t>::is_always_lock_free, "Index must be lock free");
+
+    std::atomic<int32_t> &index(int offset) const {
+        return *reinterpret_cast<std::atomic<int32_t> *>(address + offset);
+    }
+};
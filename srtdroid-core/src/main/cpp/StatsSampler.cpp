@@ -0,0 +1,280 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+
+#include "StatsSampler.h"
+#include "log.h"
+#include "Models/ModelsSingleton.h"
+
+
+StatsSampler::StatsSampler(JNIEnv *env, jobject sampler, int intervalInMs, int historySize)
+        : intervalInMs(intervalInMs), historySize(historySize), isRunning(false) {
+    env->GetJavaVM(&(this->vm));
+
+    if ((intervalInMs <= 0) || (historySize <= 0)) {
+        LOGE("Invalid sampler parameters");
+        return;
+    }
+
+    this->sampler = env->NewGlobalRef(sampler);
+
+    isRunning = true;
+    if (pthread_create(&thread, nullptr, StatsSampler::run, this) != 0) {
+        LOGE("Can't create sampler thread");
+        isRunning = false;
+        return;
+    }
+    hasThread = true;
+}
+
+StatsSampler::~StatsSampler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isRunning = false;
+    }
+    wakeUp.notify_all();
+    if (hasThread) {
+        if (pthread_equal(pthread_self(), thread)) {
+            // Deleted by the sampler thread itself, see run()
+            pthread_detach(thread);
+        } else {
+            pthread_join(thread, nullptr);
+        }
+    }
+
+    JNIEnv *env = nullptr;
+    vm->GetEnv((void **) &env, JNI_VERSION_1_6);
+    if ((env != nullptr) && (sampler != nullptr)) {
+        env->DeleteGlobalRef(sampler);
+    }
+}
+
+void StatsSampler::release() {
+    isRunning = false;
+    if (hasThread && pthread_equal(pthread_self(), thread)) {
+        // Released from a sampler callback: the sampler thread still uses this object
+        isReleasedByThread = true;
+        return;
+    }
+    delete this;
+}
+
+bool StatsSampler::isValid() const {
+    return hasThread;
+}
+
+void StatsSampler::subscribe(SRTSOCKET u) {
+    std::lock_guard<std::mutex> lock(mutex);
+    History &history = histories[u];
+    history.samples.assign((size_t) historySize * SAMPLE_SIZE, 0);
+    history.next = 0;
+    history.size = 0;
+    history.crossedThresholds.clear();
+}
+
+void StatsSampler::unsubscribe(SRTSOCKET u) {
+    std::lock_guard<std::mutex> lock(mutex);
+    histories.erase(u);
+}
+
+int StatsSampler::addThreshold(int id, int field, bool isAbove, double value) {
+    if ((field < 0) || (field >= SAMPLE_SIZE)) {
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    thresholds.push_back({id, field, isAbove, value});
+    return 0;
+}
+
+void StatsSampler::removeThreshold(int id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = thresholds.begin(); it != thresholds.end(); it++) {
+        if (it->id == id) {
+            thresholds.erase(it);
+            break;
+        }
+    }
+    for (auto &it: histories) {
+        it.second.crossedThresholds.erase(id);
+    }
+}
+
+int StatsSampler::read(SRTSOCKET u, int64_t windowInMs, jlong *out, int maxSamples) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = histories.find(u);
+    if (it == histories.end()) {
+        return -1;
+    }
+    const History &history = it->second;
+
+    // Samples are in time order: skip the ones before the window, then the oldest extra ones.
+    int64_t minTime = srt_time_now() - windowInMs * 1000;
+    int first = (history.next - history.size + historySize) % historySize;
+    int nSamples = 0;
+    for (int i = history.size - 1; i >= 0; i--) {
+        const jlong *sample = &history.samples[((first + i) % historySize) * SAMPLE_SIZE];
+        if ((sample[SAMPLE_TIME] < minTime) || (nSamples == maxSamples)) {
+            break;
+        }
+        nSamples++;
+    }
+
+    first = (first + history.size - nSamples) % historySize;
+    for (int i = 0; i < nSamples; i++) {
+        const jlong *sample = &history.samples[((first + i) % historySize) * SAMPLE_SIZE];
+        memcpy(&out[i * SAMPLE_SIZE], sample, SAMPLE_SIZE * sizeof(jlong));
+    }
+
+    return nSamples;
+}
+
+double StatsSampler::getValue(const jlong *sample, int field) {
+    bool isDouble = (field >= SEND_RATE_MBPS) || Stats::isDouble(field);
+    if (isDouble) {
+        double value;
+        memcpy(&value, &sample[field], sizeof(double));
+        return value;
+    }
+    return (double) sample[field];
+}
+
+void *StatsSampler::run(void *opaque) {
+    auto *statsSampler = static_cast<StatsSampler *>(opaque);
+    JNIEnv *env = nullptr;
+
+    JavaVMAttachArgs args = {JNI_VERSION_1_6, "SrtStatsSampler", nullptr};
+    if (statsSampler->vm->AttachCurrentThread(&env, &args) != JNI_OK) {
+        LOGE("Can't attach sampler thread");
+        return nullptr;
+    }
+
+    statsSampler->loop(env);
+
+    JavaVM *vm = statsSampler->vm;
+    if (statsSampler->isReleasedByThread) {
+        delete statsSampler;
+    }
+    vm->DetachCurrentThread();
+    return nullptr;
+}
+
+void StatsSampler::loop(JNIEnv *env) {
+    jmethodID onThresholdMethod = ModelsSingleton::getInstance(env)->statsSamplerOnThresholdMethod;
+    std::vector<Event> events;
+    SRT_TRACEBSTATS tracebstats;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (isRunning) {
+        wakeUp.wait_for(lock, std::chrono::milliseconds(intervalInMs),
+                        [this] { return !isRunning; });
+        if (!isRunning) {
+            break;
+        }
+
+        for (auto &it: histories) {
+            // Do not clear: other statistics readers must not be disturbed
+            if (srt_bistats(it.first, &tracebstats, 0, 0) == 0) {
+                sample(it.second, it.first, tracebstats, events);
+            }
+        }
+        if (events.empty()) {
+            continue;
+        }
+
+        // Java listeners may call back into the sampler
+        lock.unlock();
+        for (const Event &event: events) {
+            if (!isRunning) {
+                // Released by a previous callback
+                break;
+            }
+            env->CallVoidMethod(sampler, onThresholdMethod, event.u, event.id,
+                                (jboolean) event.isCrossed, event.value);
+            if (env->ExceptionCheck()) {
+                LOGE("Exception in sampler callback");
+                env->ExceptionDescribe();
+                env->ExceptionClear();
+            }
+        }
+        events.clear();
+        lock.lock();
+    }
+}
+
+static void putDouble(jlong *out, double value) {
+    memcpy(out, &value, sizeof(jlong));
+}
+
+void StatsSampler::write(const SRT_TRACEBSTATS &tracebstats, int64_t time,
+                         const SRT_TRACEBSTATS *last, int64_t lastTime, jlong *sample) {
+    Stats::write(tracebstats, sample);
+    sample[SAMPLE_TIME] = time;
+
+    if (last != nullptr) {
+        int64_t intervalInUs = time - lastTime;
+        int64_t sent = tracebstats.pktSentTotal - last->pktSentTotal;
+        int64_t recv = tracebstats.pktRecvTotal - last->pktRecvTotal;
+        int64_t sndLoss = tracebstats.pktSndLossTotal - last->pktSndLossTotal;
+        int64_t rcvLoss = tracebstats.pktRcvLossTotal - last->pktRcvLossTotal;
+        int64_t retrans = tracebstats.pktRetransTotal - last->pktRetransTotal;
+        int64_t byteSent = (int64_t) (tracebstats.byteSentTotal - last->byteSentTotal);
+        int64_t byteRecv = (int64_t) (tracebstats.byteRecvTotal - last->byteRecvTotal);
+
+        sample[INTERVAL_MS] = intervalInUs / 1000;
+        // Bits per microsecond are megabits per second
+        putDouble(&sample[SEND_RATE_MBPS], intervalInUs > 0 ? byteSent * 8.0 / intervalInUs : 0);
+        putDouble(&sample[RECV_RATE_MBPS], intervalInUs > 0 ? byteRecv * 8.0 / intervalInUs : 0);
+        putDouble(&sample[SND_LOSS_PERCENT], sent > 0 ? 100.0 * sndLoss / sent : 0);
+        putDouble(&sample[RCV_LOSS_PERCENT],
+                  (recv + rcvLoss) > 0 ? 100.0 * rcvLoss / (recv + rcvLoss) : 0);
+        putDouble(&sample[RETRANS_PERCENT], sent > 0 ? 100.0 * retrans / sent : 0);
+    } else {
+        sample[INTERVAL_MS] = 0;
+        for (int field = SEND_RATE_MBPS; field < SAMPLE_SIZE; field++) {
+            putDouble(&sample[field], 0);
+        }
+    }
+}
+
+void StatsSampler::sample(History &history, SRTSOCKET u, const SRT_TRACEBSTATS &tracebstats,
+                          std::vector<Event> &events) {
+    jlong *sample = &history.samples[history.next * SAMPLE_SIZE];
+    int64_t time = srt_time_now();
+    write(tracebstats, time, history.size > 0 ? &history.last : nullptr, history.lastTime, sample);
+    history.last = tracebstats;
+    history.lastTime = time;
+
+    history.next = (history.next + 1) % historySize;
+    if (history.size < historySize) {
+        history.size++;
+    }
+
+    for (const Threshold &threshold: thresholds) {
+        double value = getValue(sample, threshold.field);
+        bool isCrossed = threshold.isAbove ? value > threshold.value : value < threshold.value;
+        bool wasCrossed = history.crossedThresholds.count(threshold.id) != 0;
+        if (isCrossed == wasCrossed) {
+            continue;
+        }
+        if (isCrossed) {
+            history.crossedThresholds.insert(threshold.id);
+        } else {
+            history.crossedThresholds.erase(threshold.id);
+        }
+        events.push_back({u, threshold.id, isCrossed, value});
+    }
+}
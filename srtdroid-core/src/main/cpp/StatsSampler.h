@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <jni.h>
+#include <mutex>
+#include <pthread.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "srt/srt.h"
+#include "Models/Stats.h"
+
+/**
+ * Native side of StatsSampler: a thread that periodically reads the statistics of its subscribed
+ * sockets into a per-socket history ring and reports threshold crossings to the Java sampler.
+ *
+ * Statistics are read with srt_bistats without clearing them, so the sampler does not interfere
+ * with other statistics readers. Interval values are computed from the totals of two consecutive
+ * samples.
+ *
+ * A sample is SAMPLE_SIZE jlong: the Stats layout followed by the computed fields below.
+ * Floating point fields are stored as their IEEE 754 bits.
+ */
+class StatsSampler {
+public:
+    /** Time of the sample, in microseconds (srt_time_now) */
+    static constexpr int SAMPLE_TIME = Stats::LAYOUT_SIZE;
+    /** Time since the previous sample, in milliseconds */
+    static constexpr int INTERVAL_MS = Stats::LAYOUT_SIZE + 1;
+    /** Sending rate since the previous sample, in Mbps (double) */
+    static constexpr int SEND_RATE_MBPS = Stats::LAYOUT_SIZE + 2;
+    /** Receiving rate since the previous sample, in Mbps (double) */
+    static constexpr int RECV_RATE_MBPS = Stats::LAYOUT_SIZE + 3;
+    /** Sender side lost packets since the previous sample, in percent of sent packets (double) */
+    static constexpr int SND_LOSS_PERCENT = Stats::LAYOUT_SIZE + 4;
+    /** Receiver side lost packets since the previous sample, in percent of expected packets (double) */
+    static constexpr int RCV_LOSS_PERCENT = Stats::LAYOUT_SIZE + 5;
+    /** Retransmitted packets since the previous sample, in percent of sent packets (double) */
+    static constexpr int RETRANS_PERCENT = Stats::LAYOUT_SIZE + 6;
+    static constexpr int SAMPLE_SIZE = Stats::LAYOUT_SIZE + 7;
+
+    /**
+     * Creates the sampler and starts its thread.
+     *
+     * @param env JNI environment
+     * @param sampler the Java StatsSampler
+     * @param intervalInMs sampling interval
+     * @param historySize number of samples kept per socket
+     */
+    StatsSampler(JNIEnv *env, jobject sampler, int intervalInMs, int historySize);
+
+    /**
+     * Stops the sampler thread. Use release() once the sampler thread has been created.
+     */
+    ~StatsSampler();
+
+    /**
+     * Stops the sampler thread and deletes the sampler. If it is called from a sampler callback,
+     * the sampler thread deletes the sampler once the callback has returned.
+     */
+    void release();
+
+    /**
+     * @return true if the sampler thread has been created
+     */
+    bool isValid() const;
+
+    void subscribe(SRTSOCKET u);
+
+    void unsubscribe(SRTSOCKET u);
+
+    /**
+     * Adds a threshold on a sample field, checked for every socket on every sample.
+     *
+     * @param id identifier reported to the Java sampler
+     * @param field index of the sample field
+     * @param isAbove true if the threshold is crossed when the value is above value, false when
+     * it is below value
+     * @param value the threshold
+     * @return 0 on success, -1 if field is not a valid index
+     */
+    int addThreshold(int id, int field, bool isAbove, double value);
+
+    void removeThreshold(int id);
+
+    /**
+     * Copies the samples of the last windowInMs, oldest first.
+     *
+     * @param u the subscribed socket
+     * @param windowInMs the window duration
+     * @param out where samples are written to
+     * @param maxSamples maximum number of samples written to out
+     * @return the number of samples written or -1 if u is not subscribed
+     */
+    int read(SRTSOCKET u, int64_t windowInMs, jlong *out, int maxSamples);
+
+    /**
+     * Writes a sample.
+     *
+     * @param tracebstats the statistics
+     * @param time the time of tracebstats, in microseconds
+     * @param last the statistics of the previous sample or null if there is none
+     * @param lastTime the time of last, in microseconds
+     * @param sample where the SAMPLE_SIZE fields are written to
+     */
+    static void write(const SRT_TRACEBSTATS &tracebstats, int64_t time,
+                      const SRT_TRACEBSTATS *last, int64_t lastTime, jlong *sample);
+
+    /**
+     * @return the value of field of sample as a double
+     */
+    static double getValue(const jlong *sample, int field);
+
+private:
+    struct Threshold {
+        int id;
+        int field;
+        bool isAbove;
+        double value;
+    };
+
+    struct History {
+        std::vector<jlong> samples;
+        int next = 0;
+        int size = 0;
+        SRT_TRACEBSTATS last;
+        int64_t lastTime = 0;
+        std::unordered_set<int> crossedThresholds;
+    };
+
+    struct Event {
+        SRTSOCKET u;
+        int id;
+        bool isCrossed;
+        double value;
+    };
+
+    JavaVM *vm = nullptr;
+    jobject sampler = nullptr;
+    int intervalInMs;
+    int historySize;
+    pthread_t thread;
+    bool hasThread = false;
+    std::atomic<bool> isRunning;
+    // Only accessed by the sampler thread
+    bool isReleasedByThread = false;
+
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::unordered_map<SRTSOCKET, History> histories;
+    std::vector<Threshold> thresholds;
+
+    static void *run(void *opaque);
+
+    void loop(JNIEnv *env);
+
+    void sample(History &history, SRTSOCKET u, const SRT_TRACEBSTATS &tracebstats,
+                std::vector<Event> &events);
+};
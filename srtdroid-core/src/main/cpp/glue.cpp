@@ -15,16 +15,31 @@
  */
 
 #include <jni.h>
+#include <algorithm>
+#include <mutex>
+#include <vector>
 
 #include "srt/srt.h"
 #include "srt/logging_api.h"
 
 #include "log.h"
+#include "AdmissionControl.h"
 #include "CallbackContext.h"
+#include "BitrateController.h"
+#include "Bridge.h"
+#include "EpollReactor.h"
+#include "FanOutGroup.h"
+#include "RecvRing.h"
+#include "Relay.h"
+#include "SendRing.h"
+#include "SendWatermark.h"
+#include "StatsSampler.h"
+#include "SocketRegistry.h"
 #include "Enums/EnumsSingleton.h"
 #include "Enums/ErrorType.h"
 #include "Enums/ErrorType.h"
 #include "Models/Models.h"
+#include "Models/ModelsSingleton.h"
 #include "Models/EpollFlags.h"
 #include "Models/Socket.h"
 #include "Models/InetSocketAddress.h"
@@ -37,60 +52,69 @@
 #include "Models/EpollEvent.h"
 
 
-int onListenCallback(JNIEnv *env, jobject ju, jclass sockAddrClazz, SRTSOCKET ns, int hs_version,
+int onListenCallback(JNIEnv *env, jobject ju, SRTSOCKET ns, int hs_version,
                      const struct sockaddr *peeraddr, const char *streamid) {
-    jclass socketClazz = env->GetObjectClass(ju);
-    if (!socketClazz) {
-        LOGE("Can't get Socket class");
-        return 0;
-    }
+    jobject nsSocket = Socket::getJava(env, ns);
+    jobject peerAddress = InetSocketAddress::getJava(env, (sockaddr_storage *) peeraddr);
+    jstring streamId = env->NewStringUTF(streamid);
 
-    jmethodID onListenID = env->GetMethodID(socketClazz, "onListen",
-                                            "(L" SRTSOCKET_CLASS ";IL" INETSOCKETADDRESS_CLASS ";Ljava/lang/String;)I");
-    if (!onListenID) {
-        LOGE("Can't get onListen methodID");
-        env->DeleteLocalRef(socketClazz);
-        return 0;
+    int res = env->CallIntMethod(ju, ModelsSingleton::getInstance(env)->srtSocketOnListenMethod,
+                                 nsSocket, (jint) hs_version, peerAddress, streamId);
+    if (env->ExceptionCheck()) {
+        // The thread stays attached: don't leave the exception pending for the next callback
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+        res = SRT_ERROR;
     }
 
-    jobject nsSocket = Socket::getJava(env, socketClazz, ns);
-    jobject peerAddress = InetSocketAddress::getJava(env, sockAddrClazz,
-                                                     (sockaddr_storage *) peeraddr);
-    jstring streamId = env->NewStringUTF(streamid);
+    env->DeleteLocalRef(nsSocket);
+    env->DeleteLocalRef(peerAddress);
+    env->DeleteLocalRef(streamId);
 
-    int res = env->CallIntMethod(ju, onListenID, nsSocket, (jint) hs_version, peerAddress,
-                                 streamId);
+    return res;
+}
 
-    env->DeleteLocalRef(socketClazz);
+/**
+ * SRT callbacks get the socket id as opaque: contexts are looked up in the registry, that keeps
+ * them alive for the duration of the callback even if the socket is closed meanwhile.
+ */
+static void *toOpaque(SRTSOCKET u) {
+    return reinterpret_cast<void *>((intptr_t) u);
+}
 
-    return res;
+static SRTSOCKET fromOpaque(void *opaque) {
+    return (SRTSOCKET) reinterpret_cast<intptr_t>(opaque);
 }
 
 int srt_listen_cb(void *opaque, SRTSOCKET ns, int hs_version,
                   const struct sockaddr *peeraddr, const char *streamid) {
-    auto *cbCtx = static_cast<CallbackContext *>(opaque);
+    SRTSOCKET u = fromOpaque(opaque);
+
+    // Rejected connections never reach the JVM
+    auto admissionControl = std::static_pointer_cast<AdmissionControl>(
+            SocketRegistry::getInstance()->getUserData(u, SocketRegistry::ADMISSION_CONTROL));
+    if (admissionControl != nullptr) {
+        int rejectReason = 0;
+        if (admissionControl->evaluate(peeraddr, streamid, &rejectReason) ==
+            AdmissionControl::DENY) {
+            srt_setrejectreason(ns, rejectReason);
+            return -1;
+        }
+    }
 
+    auto cbCtx = std::static_pointer_cast<CallbackContext>(
+            SocketRegistry::getInstance()->getUserData(u, SocketRegistry::LISTEN_CALLBACK));
     if (cbCtx == nullptr) {
         LOGE("Failed to get CallbackContext");
         return 0;
     }
 
-    JavaVM *vm = cbCtx->vm;
-    JNIEnv *env = nullptr;
-    if (vm->GetEnv((void **) &env, JNI_VERSION_1_6) == JNI_EDETACHED) {
-        if (vm->AttachCurrentThread(&env, nullptr) != JNI_OK) {
-            LOGE("Failed to attach current thread");
-        }
-    } else {
-        LOGE("Failed to get env");
+    JNIEnv *env = cbCtx->getEnv();
+    if (env == nullptr) {
+        return 0;
     }
 
-    int res = onListenCallback(env, cbCtx->callingSocket, cbCtx->sockAddrClazz, ns, hs_version,
-                               peeraddr, streamid);
-
-    vm->DetachCurrentThread();
-
-    return res;
+    return onListenCallback(env, cbCtx->callingSocket, ns, hs_version, peeraddr, streamid);
 }
 
 void onConnectCallback(JNIEnv *env,
@@ -99,58 +123,42 @@ void onConnectCallback(JNIEnv *env,
                        int errorcode,
                        const struct sockaddr *peeraddr,
                        int token) {
-    jclass socketClazz = env->GetObjectClass(cb->callingSocket);
-    if (!socketClazz) {
-        LOGE("Can't get Socket class");
-        return;
-    }
-
-    jmethodID onConnectID = env->GetMethodID(socketClazz, "onConnect",
-                                             "(L" SRTSOCKET_CLASS ";L" ERRORTYPE_CLASS ";L" INETSOCKETADDRESS_CLASS ";I)V");
-    if (!onConnectID) {
-        LOGE("Can't get onConnect methodID");
-        env->DeleteLocalRef(socketClazz);
-        return;
-    }
-
-    jobject nsSocket = Socket::getJava(env, socketClazz, ns);
-    jobject peerAddress = InetSocketAddress::getJava(env, cb->sockAddrClazz,
-                                                     (sockaddr_storage *) peeraddr);
+    jobject nsSocket = Socket::getJava(env, ns);
+    jobject peerAddress = InetSocketAddress::getJava(env, (sockaddr_storage *) peeraddr);
     jobject error = EnumsSingleton::getInstance(env)->errorType->getJavaValue(env,
                                                                               (SRT_ERRNO) errorcode);
 
-    env->CallVoidMethod(cb->callingSocket, onConnectID, nsSocket, error, peerAddress,
-                        token);
+    env->CallVoidMethod(cb->callingSocket,
+                        ModelsSingleton::getInstance(env)->srtSocketOnConnectMethod, nsSocket,
+                        error, peerAddress, token);
+    if (env->ExceptionCheck()) {
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+    }
 
-    env->DeleteLocalRef(socketClazz);
+    env->DeleteLocalRef(nsSocket);
+    env->DeleteLocalRef(peerAddress);
+    env->DeleteLocalRef(error);
 }
 
 
 void srt_connect_cb(void *opaque, SRTSOCKET ns, int errorcode, const struct sockaddr *peeraddr,
                     int token) {
-    auto *cbCtx = static_cast<CallbackContext *>(opaque);
-
+    auto cbCtx = std::static_pointer_cast<CallbackContext>(
+            SocketRegistry::getInstance()->getUserData(fromOpaque(opaque),
+                                                       SocketRegistry::CONNECT_CALLBACK));
     if (cbCtx == nullptr) {
         LOGE("Failed to get CallbackContext");
         return;
     }
 
-    JavaVM *vm = cbCtx->vm;
-    JNIEnv *env = nullptr;
-    if (vm->GetEnv((void **) &env, JNI_VERSION_1_6) == JNI_EDETACHED) {
-        if (vm->AttachCurrentThread(&env, nullptr) != JNI_OK) {
-            LOGE("Failed to attach current thread");
-        }
-    } else {
-        LOGE("Failed to get env");
+    JNIEnv *env = cbCtx->getEnv();
+    if (env == nullptr) {
+        return;
     }
 
-    onConnectCallback(env, cbCtx, ns, errorcode,
+    onConnectCallback(env, cbCtx.get(), ns, errorcode,
                       peeraddr, token);
-
-    vm->DetachCurrentThread();
-
-    delete cbCtx;
 }
 
 // SRT Logger callback
@@ -200,9 +208,7 @@ nativeGetVersion(JNIEnv *env, jobject obj) {
 
 // Creating and configuring sockets
 jboolean JNICALL
-nativeIsValid(JNIEnv *env, jobject ju) {
-    SRTSOCKET u = Socket::getNative(env, ju);
-
+nativeIsValid(JNIEnv *env, jclass clazz, jint u) {
     return static_cast<jboolean>(u != SRT_INVALID_SOCK);
 }
 
@@ -249,25 +255,101 @@ nativeGetSockState(JNIEnv *env, jobject ju) {
 }
 
 jint JNICALL
-nativeClose(JNIEnv *env, jobject ju) {
-    SRTSOCKET u = Socket::getNative(env, ju);
+nativeClose(JNIEnv *env, jclass clazz, jint u) {
+    int res = srt_close((SRTSOCKET) u);
+
+    // After close, so SRT no longer calls back with the registered contexts
+    SocketRegistry::getInstance()->remove(env, (SRTSOCKET) u);
+    SendWatermark::getInstance()->remove((SRTSOCKET) u);
+
+    return res;
+}
 
-    return (srt_close((SRTSOCKET) u));
+void JNICALL
+nativeRegister(JNIEnv *env, jclass clazz, jint u, jobject ju) {
+    SocketRegistry::getInstance()->put(env, (SRTSOCKET) u, ju);
 }
 
 // Connecting
+/**
+ * Creates the callback context of a socket if it does not exist yet. An existing context is
+ * reused: an in-flight callback might be using it.
+ */
+static void setCallbackContext(JNIEnv *env, SRTSOCKET u, jobject ju, SocketRegistry::Slot slot) {
+    if (SocketRegistry::getInstance()->getUserData(u, slot) != nullptr) {
+        return;
+    }
+    auto *cbCtx = new CallbackContext(env, u, ju);
+    SocketRegistry::getInstance()->setUserData(env, u, cbCtx, CallbackContext::release, slot);
+}
+
 jint JNICALL
 nativeListen(JNIEnv *env, jobject ju, jint backlog) {
     SRTSOCKET u = Socket::getNative(env, ju);
 
-    // Add callback hook
-    auto *cbCtx = new CallbackContext(env, ju);
-    srt_listen_callback(u, srt_listen_cb,
-                        (void *) cbCtx); // TODO: free cbCtx but could not find a way to free callback opaque parameter
+    // Add callback hook. The context is owned by the registry and freed when the socket is closed.
+    setCallbackContext(env, u, ju, SocketRegistry::LISTEN_CALLBACK);
+    srt_listen_callback(u, srt_listen_cb, toOpaque(u));
 
     return srt_listen((SRTSOCKET) u, (int) backlog);
 }
 
+jint JNICALL
+nativeSetAdmissionPolicy(JNIEnv *env, jclass clazz, jint u, jintArray actions,
+                         jobjectArray keys, jobjectArray patterns, jintArray rejectReasons,
+                         jint defaultAction, jint defaultRejectReason, jdoubleArray rateLimits,
+                         jint rateLimitRejectReason) {
+    int nRules = env->GetArrayLength(actions);
+    std::vector<jint> ruleActions(nRules);
+    std::vector<jint> ruleRejectReasons(nRules);
+    env->GetIntArrayRegion(actions, 0, nRules, ruleActions.data());
+    env->GetIntArrayRegion(rejectReasons, 0, nRules, ruleRejectReasons.data());
+
+    std::vector<AdmissionControl::Rule> rules;
+    rules.reserve(nRules);
+    for (int i = 0; i < nRules; i++) {
+        auto key = (jstring) env->GetObjectArrayElement(keys, i);
+        auto pattern = (jstring) env->GetObjectArrayElement(patterns, i);
+        const char *keyChars = env->GetStringUTFChars(key, nullptr);
+        const char *patternChars = env->GetStringUTFChars(pattern, nullptr);
+
+        rules.push_back({(AdmissionControl::Action) ruleActions[i], keyChars, patternChars,
+                         ruleRejectReasons[i]});
+
+        env->ReleaseStringUTFChars(key, keyChars);
+        env->ReleaseStringUTFChars(pattern, patternChars);
+        env->DeleteLocalRef(key);
+        env->DeleteLocalRef(pattern);
+    }
+
+    // Global rate, global burst, per address rate, per address burst
+    jdouble limits[4];
+    env->GetDoubleArrayRegion(rateLimits, 0, 4, limits);
+
+    // The admission control lives as long as the socket: the listen callback might be using it.
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto admissionControl = std::static_pointer_cast<AdmissionControl>(
+            SocketRegistry::getInstance()->getUserData(u, SocketRegistry::ADMISSION_CONTROL));
+    if (admissionControl == nullptr) {
+        auto *newAdmissionControl = new AdmissionControl();
+        SocketRegistry::getInstance()->setUserData(env, u, newAdmissionControl,
+                                                   AdmissionControl::release,
+                                                   SocketRegistry::ADMISSION_CONTROL);
+        admissionControl = std::static_pointer_cast<AdmissionControl>(
+                SocketRegistry::getInstance()->getUserData(u, SocketRegistry::ADMISSION_CONTROL));
+        if (admissionControl == nullptr) {
+            // The socket has been closed meanwhile
+            return SRT_ERROR;
+        }
+    }
+    admissionControl->configure(std::move(rules), (AdmissionControl::Action) defaultAction,
+                                defaultRejectReason, {limits[0], limits[1]},
+                                {limits[2], limits[3]}, rateLimitRejectReason);
+
+    return 0;
+}
+
 jobject JNICALL
 nativeAccept(JNIEnv *env, jobject ju) {
     SRTSOCKET u = Socket::getNative(env, ju);
@@ -293,9 +375,9 @@ nativeConnect(JNIEnv *env, jobject ju, jobject inetSocketAddress) {
     int size = 0;
     const struct sockaddr_storage *ss = InetSocketAddress::getNative(env, inetSocketAddress, &size);
 
-    // Add callback hook
-    auto *cbCtx = new CallbackContext(env, ju);
-    srt_connect_callback(u, srt_connect_cb, (void *) cbCtx);
+    // Add callback hook. The context is owned by the registry and freed when the socket is closed.
+    setCallbackContext(env, u, ju, SocketRegistry::CONNECT_CALLBACK);
+    srt_connect_callback(u, srt_connect_cb, toOpaque(u));
 
     int res = srt_connect((SRTSOCKET) u, reinterpret_cast<const sockaddr *>(ss), size);
 
@@ -373,36 +455,133 @@ nativeGetSockOpt(JNIEnv *env,
     return optVal;
 }
 
+// Typed setters take the native SRT_SOCKOPT value: no reflection on the value and no allocation.
 jint JNICALL
-nativeSetSockOpt(JNIEnv *env,
-                 jobject ju,
-                 jobject sockOpt,
-                 jobject optVal) {
-    SRTSOCKET u = Socket::getNative(env, ju);
-    int sockopt = EnumsSingleton::getInstance(env)->sockOpt->getNativeValue(env, sockOpt);
-    if (sockopt <= 0) {
-        return sockopt;
+nativeSetSockOptInt(JNIEnv *env, jclass clazz, jint u, jint sockopt, jint value) {
+    int optval = value;
+
+    return srt_setsockopt((SRTSOCKET) u, 0 /*level: ignored*/, (SRT_SOCKOPT) sockopt, &optval,
+                          sizeof(optval));
+}
+
+jint JNICALL
+nativeSetSockOptLong(JNIEnv *env, jclass clazz, jint u, jint sockopt, jlong value) {
+    int64_t optval = value;
+
+    return srt_setsockopt((SRTSOCKET) u, 0 /*level: ignored*/, (SRT_SOCKOPT) sockopt, &optval,
+                          sizeof(optval));
+}
+
+jint JNICALL
+nativeSetSockOptBool(JNIEnv *env, jclass clazz, jint u, jint sockopt, jboolean value) {
+    bool optval = (value == JNI_TRUE);
+
+    return srt_setsockopt((SRTSOCKET) u, 0 /*level: ignored*/, (SRT_SOCKOPT) sockopt, &optval,
+                          sizeof(optval));
+}
+
+jint JNICALL
+nativeSetSockOptString(JNIEnv *env, jclass clazz, jint u, jint sockopt, jstring value) {
+    // Larger than any SRT string option (passphrase: 80, stream ID: 512)
+    char optval[1024];
+    if (value == nullptr) {
+        return SRT_ERROR;
     }
-    int optval_len = 0;
-    const void *optval = OptVal::getNative(env, optVal, &optval_len);
+    // Checked by Java first: SockOptions.isStringValueValid
+    int optlen = env->GetStringUTFLength(value);
+    if (optlen >= (int) sizeof(optval)) {
+        return SRT_ERROR;
+    }
+    env->GetStringUTFRegion(value, 0, env->GetStringLength(value), optval);
+    optval[optlen] = '\0';
+
+    return srt_setsockopt((SRTSOCKET) u, 0 /*level: ignored*/, (SRT_SOCKOPT) sockopt, optval,
+                          optlen);
+}
 
-    if (!optval) {
-        return -EFAULT;
+jint JNICALL
+nativeApplyOptions(JNIEnv *env, jclass clazz, jint u, jintArray sockopts, jintArray types,
+                   jlongArray values, jobjectArray strings) {
+    int nOptions = env->GetArrayLength(sockopts);
+    std::vector<jint> sockopt(nOptions);
+    std::vector<jint> type(nOptions);
+    std::vector<jlong> value(nOptions);
+    env->GetIntArrayRegion(sockopts, 0, nOptions, sockopt.data());
+    env->GetIntArrayRegion(types, 0, nOptions, type.data());
+    env->GetLongArrayRegion(values, 0, nOptions, value.data());
+
+    for (int i = 0; i < nOptions; i++) {
+        int res;
+        switch (type[i]) {
+            case OptVal::LONG:
+                res = nativeSetSockOptLong(env, clazz, u, sockopt[i], value[i]);
+                break;
+            case OptVal::BOOL:
+                res = nativeSetSockOptBool(env, clazz, u, sockopt[i], value[i] != 0);
+                break;
+            case OptVal::STRING: {
+                auto string = (jstring) env->GetObjectArrayElement(strings, i);
+                res = nativeSetSockOptString(env, clazz, u, sockopt[i], string);
+                env->DeleteLocalRef(string);
+                break;
+            }
+            default:
+                res = nativeSetSockOptInt(env, clazz, u, sockopt[i], (jint) value[i]);
+                break;
+        }
+        if (res != 0) {
+            // Index of the first failed option
+            return i;
+        }
     }
 
-    int res = srt_setsockopt((SRTSOCKET) u,
-                             0 /*level: ignored*/, (SRT_SOCKOPT) sockopt, optval, optval_len);
-    free((void *) optval);
+    return -1;
+}
+
+jint JNICALL
+nativeSnapshotOptions(JNIEnv *env, jclass clazz, jint u, jintArray sockopts, jlongArray values) {
+    int nOptions = env->GetArrayLength(sockopts);
+    std::vector<jint> sockopt(nOptions);
+    std::vector<jlong> value(nOptions);
+    env->GetIntArrayRegion(sockopts, 0, nOptions, sockopt.data());
+
+    int nRead = 0;
+    for (int i = 0; i < nOptions; i++) {
+        int64_t optval = 0;
+        if (OptVal::getNumber(u, 0 /*level: ignored*/, sockopt[i], &optval) == 0) {
+            value[i] = optval;
+            nRead++;
+        } else {
+            value[i] = INT64_MIN;
+        }
+    }
+    env->SetLongArrayRegion(values, 0, nOptions, value.data());
 
-    return
-            res;
+    return nRead;
 }
 
-// Transmission
+// Send buffer watermarks
 jint JNICALL
-nativeSend2(JNIEnv *env, jobject ju, jobject byteBuffer, jint offset, jint len) {
-    SRTSOCKET u = Socket::getNative(env, ju);
+nativeSetSendBufferWatermarks(JNIEnv *env, jclass clazz, jint u, jint metric, jlong low,
+                              jlong high, jint intervalInMs) {
+    if (high <= 0) {
+        SendWatermark::getInstance()->remove(u);
+        return 0;
+    }
+
+    return SendWatermark::getInstance()->set(env, u, (SendWatermark::Metric) metric, low, high,
+                                             intervalInMs);
+}
+
+jlong JNICALL
+nativeGetSendBufferLevel(JNIEnv *env, jclass clazz, jint u, jint metric) {
+    return SendWatermark::getLevel(u, (SendWatermark::Metric) metric);
+}
 
+// Transmission
+// Transmission natives are static and take the SRT socket id: no SrtSocket dereference per packet.
+jint JNICALL
+nativeSend2(JNIEnv *env, jclass clazz, jint u, jobject byteBuffer, jint offset, jint len) {
     char *buf = (char *) env->GetDirectBufferAddress(byteBuffer);
 
     int res = srt_send(u, &buf[offset], len);
@@ -411,26 +590,25 @@ nativeSend2(JNIEnv *env, jobject ju, jobject byteBuffer, jint offset, jint len)
 }
 
 jint JNICALL
-nativeSend(JNIEnv *env, jobject ju, jbyteArray byteArray, jint offset, jint len) {
-    SRTSOCKET u = Socket::getNative(env, ju);
+nativeSend(JNIEnv *env, jclass clazz, jint u, jbyteArray byteArray, jint offset, jint len) {
     char *buf = (char *) env->GetByteArrayElements(byteArray, nullptr);
 
     int res = srt_send(u, &buf[offset], len);
 
-    env->ReleaseByteArrayElements(byteArray, (jbyte *) buf, 0);
+    env->ReleaseByteArrayElements(byteArray, (jbyte *) buf, JNI_ABORT); // Nothing to copy back
 
     return res;
 }
 
 jint JNICALL
 nativeSendMsg2(JNIEnv *env,
-               jobject ju,
+               jclass clazz,
+               jint u,
                jobject byteBuffer,
                jint offset,
                jint len,
                jint ttl/* = -1*/,
                jboolean inOrder/* = false*/) {
-    SRTSOCKET u = Socket::getNative(env, ju);
     char *buf = (char *) env->GetDirectBufferAddress(byteBuffer);
 
     int res = srt_sendmsg(u, &buf[offset], len, (int) ttl, inOrder);
@@ -441,160 +619,316 @@ nativeSendMsg2(JNIEnv *env,
 
 jint JNICALL
 nativeSendMsg(JNIEnv *env,
-              jobject ju,
+              jclass clazz,
+              jint u,
               jbyteArray byteArray,
               jint offset,
               jint len,
               jint ttl/* = -1*/,
               jboolean inOrder/* = false*/) {
-    SRTSOCKET u = Socket::getNative(env, ju);
     char *buf = (char *) env->GetByteArrayElements(byteArray, nullptr);
 
     int res = srt_sendmsg(u, &buf[offset], len, (int) ttl, inOrder);
 
-    env->ReleaseByteArrayElements(byteArray, (jbyte *) buf, 0);
+    env->ReleaseByteArrayElements(byteArray, (jbyte *) buf, JNI_ABORT); // Nothing to copy back
 
     return res;
 }
 
 jint JNICALL
 nativeSendMsgCtrl2(JNIEnv *env,
-                   jobject ju,
+                   jclass clazz,
+                   jint u,
                    jobject byteBuffer,
                    jint offset,
                    jint len,
-                   jobject msgCtrl) {
-    SRTSOCKET u = Socket::getNative(env, ju);
-    SRT_MSGCTRL *msgctrl = MsgCtrl::getNative(env, msgCtrl);
+                   jobject msgCtrlBuffer) {
+    SRT_MSGCTRL *msgctrl = MsgCtrl::getNative(env, msgCtrlBuffer);
     char *buf = (char *) env->GetDirectBufferAddress(byteBuffer);
 
     int res = srt_sendmsg2(u, &buf[offset], len, msgctrl);
 
-    if (msgctrl != nullptr) {
-        free(msgctrl);
-    }
-
     return res;
 }
 
 jint JNICALL
 nativeSendMsgCtrl(JNIEnv *env,
-                  jobject ju,
+                  jclass clazz,
+                  jint u,
                   jbyteArray byteArray,
                   jint offset,
                   jint len,
-                  jobject msgCtrl) {
-    SRTSOCKET u = Socket::getNative(env, ju);
-    SRT_MSGCTRL *msgctrl = MsgCtrl::getNative(env, msgCtrl);
+                  jobject msgCtrlBuffer) {
+    SRT_MSGCTRL *msgctrl = MsgCtrl::getNative(env, msgCtrlBuffer);
     char *buf = (char *) env->GetByteArrayElements(byteArray, nullptr);
 
     int res = srt_sendmsg2(u, &buf[offset], len, msgctrl);
 
-    env->ReleaseByteArrayElements(byteArray, (jbyte *) buf, 0);
-    if (msgctrl != nullptr) {
-        free(msgctrl);
-    }
-
+    env->ReleaseByteArrayElements(byteArray, (jbyte *) buf, JNI_ABORT); // Nothing to copy back
     return res;
 }
 
-jobject JNICALL
-nativeRecv(JNIEnv *env, jobject ju, jint len) {
-    SRTSOCKET u = Socket::getNative(env, ju);
-    jbyteArray byteArray;
-    auto *buf = (char *) malloc(sizeof(char) * len);
+jint JNICALL
+nativeSendBatch(JNIEnv *env,
+                jclass clazz,
+                jint u,
+                jobject byteBuffer,
+                jintArray offsets,
+                jintArray lengths,
+                jlongArray srcTimes,
+                jint count,
+                jint ttl,
+                jboolean inOrder,
+                jintArray msgNos) {
+    if (count <= 0) {
+        return 0;
+    }
+    char *buf = (char *) env->GetDirectBufferAddress(byteBuffer);
+    if (buf == nullptr) {
+        return SRT_ERROR;
+    }
 
-    int res = srt_recv(u, buf, len);
+    // Reused across calls of the same thread. Java arrays are not pinned as sending might block.
+    static thread_local std::vector<jint> offset;
+    static thread_local std::vector<jint> length;
+    static thread_local std::vector<jlong> srcTime;
+    static thread_local std::vector<jint> msgNo;
+    if (offset.size() < (size_t) count) {
+        offset.resize(count);
+        length.resize(count);
+        srcTime.resize(count);
+        msgNo.resize(count);
+    }
+    env->GetIntArrayRegion(offsets, 0, count, offset.data());
+    env->GetIntArrayRegion(lengths, 0, count, length.data());
+    env->GetLongArrayRegion(srcTimes, 0, count, srcTime.data());
+    if (env->ExceptionCheck()) {
+        // ArrayIndexOutOfBoundsException is thrown on return
+        return SRT_ERROR;
+    }
 
-    if (res > 0) {
-        byteArray = env->NewByteArray(res);
-        env->SetByteArrayRegion(byteArray, 0, res, (jbyte *) buf);
-    } else {
-        byteArray = env->NewByteArray(0);
+    int nSent = 0;
+    for (; nSent < count; nSent++) {
+        // srt_sendmsg2 writes back to msgctrl (msgno, pktseq): each message starts from defaults
+        SRT_MSGCTRL msgctrl = srt_msgctrl_default;
+        msgctrl.msgttl = ttl;
+        msgctrl.inorder = inOrder;
+        msgctrl.srctime = srcTime[nSent];
+        if (srt_sendmsg2(u, &buf[offset[nSent]], length[nSent], &msgctrl) <= 0) {
+            break;
+        }
+        msgNo[nSent] = msgctrl.msgno;
     }
 
-    if (buf != nullptr) {
-        free(buf);
+    if (nSent == 0) {
+        // The send buffer is full: not an error in non-blocking mode
+        if (srt_getlasterror(nullptr) == SRT_EASYNCSND) {
+            return 0;
+        }
+        return SRT_ERROR;
     }
+    env->SetIntArrayRegion(msgNos, 0, nSent, msgNo.data());
 
-    return Pair::newJavaPair(env, Primitive::newJavaInt(env, res), byteArray);
+    return nSent;
 }
 
-jobject JNICALL
-nativeRecvA(JNIEnv *env, jobject ju, jbyteArray byteArray, jint offset, jint len) {
-    SRTSOCKET u = Socket::getNative(env, ju);
+jint JNICALL
+nativeRecvB(JNIEnv *env, jclass clazz, jint u, jobject byteBuffer, jint offset, jint len) {
+    char *buf = (char *) env->GetDirectBufferAddress(byteBuffer);
+
+    int res = srt_recv(u, &buf[offset], len);
+
+    return res;
+}
+
+jint JNICALL
+nativeRecvA(JNIEnv *env, jclass clazz, jint u, jbyteArray byteArray, jint offset, jint len) {
     int bufferLength = env->GetArrayLength(byteArray);
     int res = -1;
     if (bufferLength >= (offset + len)) {
-        char *buf = reinterpret_cast<char *>(env->GetByteArrayElements(byteArray, nullptr));
-        res = srt_recv(u, &buf[offset], (int) len);
-        env->ReleaseByteArrayElements(byteArray, reinterpret_cast<jbyte *>(buf), 0); // 0 - free buf
+        // Only copy back what has been received
+        auto *buf = (char *) malloc(sizeof(char) * len);
+        res = srt_recv(u, buf, (int) len);
+        if (res > 0) {
+            env->SetByteArrayRegion(byteArray, offset, res, (jbyte *) buf);
+        }
+        free(buf);
     }
 
-    return Pair::newJavaPair(env, Primitive::newJavaInt(env, res), byteArray);
+    return res;
 }
 
-jobject JNICALL
-nativeRecvMsg2(JNIEnv *env,
-               jobject ju,
-               jint len,
-               jobject msgCtrl) {
-    SRTSOCKET u = Socket::getNative(env, ju);
-    SRT_MSGCTRL *msgctrl = MsgCtrl::getNative(env, msgCtrl);
-    jbyteArray byteArray;
-    auto *buf = (char *) malloc(sizeof(char) * len);
-
-    int res = srt_recvmsg2(u, buf, len, msgctrl);
-
-    if (res > 0) {
-        byteArray = env->NewByteArray(res);
-        env->SetByteArrayRegion(byteArray, 0, res, (jbyte *) buf);
-    } else {
-        byteArray = env->NewByteArray(0);
-    }
+jint JNICALL
+nativeRecvMsg2B(JNIEnv *env,
+                jclass clazz,
+                jint u,
+                jobject byteBuffer,
+                jint offset,
+                jint len,
+                jobject msgCtrlBuffer) {
+    SRT_MSGCTRL *msgctrl = MsgCtrl::getNative(env, msgCtrlBuffer);
+    char *buf = (char *) env->GetDirectBufferAddress(byteBuffer);
 
-    if (buf != nullptr) {
-        free(buf);
-    }
-    if (msgctrl != nullptr) {
-        free(msgctrl);
-    }
+    int res = srt_recvmsg2(u, &buf[offset], len, msgctrl);
 
-    return Pair::newJavaPair(env, Primitive::newJavaInt(env, res), byteArray);
+    return res;
 }
 
-jobject JNICALL
+jint JNICALL
 nativeRecvMsg2A(JNIEnv *env,
-                jobject ju,
+                jclass clazz,
+                jint u,
                 jbyteArray byteArray,
                 jint offset,
                 jint len,
-                jobject msgCtrl) {
-    SRTSOCKET u = Socket::getNative(env, ju);
-    SRT_MSGCTRL *msgctrl = MsgCtrl::getNative(env, msgCtrl);
+                jobject msgCtrlBuffer) {
+    SRT_MSGCTRL *msgctrl = MsgCtrl::getNative(env, msgCtrlBuffer);
     int bufferLength = env->GetArrayLength(byteArray);
     int res = -1;
     if (bufferLength >= (offset + len)) {
-        char *buf = reinterpret_cast<char *>(env->GetByteArrayElements(byteArray, nullptr));
-        res = srt_recvmsg2(u, &buf[offset], (int) len, msgctrl);
-        env->ReleaseByteArrayElements(byteArray, reinterpret_cast<jbyte *>(buf), 0); // 0 - free buf
+        // Only copy back what has been received
+        auto *buf = (char *) malloc(sizeof(char) * len);
+        res = srt_recvmsg2(u, buf, (int) len, msgctrl);
+        if (res > 0) {
+            env->SetByteArrayRegion(byteArray, offset, res, (jbyte *) buf);
+        }
+        free(buf);
+    }
+
+    return res;
+}
+
+/**
+ * Private epoll that tells if a socket has a message ready without blocking nor changing its
+ * options. One per thread: the epoll is created on first use and released on thread exit.
+ */
+class ReadinessPoller {
+public:
+    ~ReadinessPoller() {
+        if (eid != -1) {
+            srt_epoll_release(eid);
+        }
+    }
+
+    /**
+     * @return true if u is polled
+     */
+    bool add(SRTSOCKET u) {
+        if (eid == -1) {
+            eid = srt_epoll_create();
+            if (eid == -1) {
+                return false;
+            }
+        }
+        int events = SRT_EPOLL_IN;
+        return srt_epoll_add_usock(eid, u, &events) == 0;
+    }
+
+    void remove(SRTSOCKET u) {
+        srt_epoll_remove_usock(eid, u);
     }
 
-    if (msgctrl != nullptr) {
-        free(msgctrl);
+    /**
+     * @return true if the polled socket has a message ready
+     */
+    bool isReadable() {
+        SRT_EPOLL_EVENT event;
+        return srt_epoll_uwait(eid, &event, 1, 0) > 0;
     }
 
-    return Pair::newJavaPair(env, Primitive::newJavaInt(env, res), byteArray);
+private:
+    int eid = -1;
+};
+
+jint JNICALL
+nativeRecvBatch(JNIEnv *env,
+                jclass clazz,
+                jint u,
+                jobject byteBuffer,
+                jint offset,
+                jint len,
+                jintArray lengths,
+                jlongArray srcTimes,
+                jintArray pktSeqs,
+                jint max) {
+    if (max <= 0) {
+        return 0;
+    }
+    char *buf = (char *) env->GetDirectBufferAddress(byteBuffer);
+
+    // Reused across calls of the same thread. Java arrays are not pinned as receiving might block.
+    static thread_local std::vector<jint> length;
+    static thread_local std::vector<jlong> srcTime;
+    static thread_local std::vector<jint> pktSeq;
+    if (length.size() < (size_t) max) {
+        length.resize(max);
+        srcTime.resize(max);
+        pktSeq.resize(max);
+    }
+
+    // Next messages are only read if there is room for a full packet.
+    int payloadSize = 0;
+    int optlen = sizeof(payloadSize);
+    srt_getsockflag(u, SRTO_PAYLOADSIZE, &payloadSize, &optlen);
+    int minLen = std::max(payloadSize, 1);
+
+    SRT_MSGCTRL msgctrl = srt_msgctrl_default;
+    int res = srt_recvmsg2(u, &buf[offset], len, &msgctrl);
+    if (res <= 0) {
+        if ((res < 0) && (srt_getlasterror(nullptr) == SRT_EASYNCRCV)) {
+            return 0;
+        }
+        return res;
+    }
+
+    // Only the first message might block. On a blocking socket, the others are only read if they
+    // are ready: toggling SRTO_RCVSYN would race with other threads using the socket.
+    bool rcvSyn = false;
+    optlen = sizeof(rcvSyn);
+    srt_getsockflag(u, SRTO_RCVSYN, &rcvSyn, &optlen);
+    static thread_local ReadinessPoller poller;
+    bool isPolled = rcvSyn && (max > 1) && poller.add(u);
+
+    int nRecv = 0;
+    while (true) {
+        length[nRecv] = res;
+        srcTime[nRecv] = msgctrl.srctime;
+        pktSeq[nRecv] = msgctrl.pktseq;
+        nRecv++;
+        offset += res;
+        len -= res;
+        if ((nRecv == max) || (len < minLen)) {
+            break;
+        }
+        if (rcvSyn && (!isPolled || !poller.isReadable())) {
+            break;
+        }
+        msgctrl = srt_msgctrl_default;
+        res = srt_recvmsg2(u, &buf[offset], len, &msgctrl);
+        if (res <= 0) {
+            break;
+        }
+    }
+
+    if (isPolled) {
+        poller.remove(u);
+    }
+
+    env->SetIntArrayRegion(lengths, 0, nRecv, length.data());
+    env->SetLongArrayRegion(srcTimes, 0, nRecv, srcTime.data());
+    env->SetIntArrayRegion(pktSeqs, 0, nRecv, pktSeq.data());
+
+    return nRecv;
 }
 
 jlong JNICALL
 nativeSendFile(JNIEnv *env,
-               jobject ju,
+               jclass clazz,
+               jint u,
                jstring filePath,
                jlong fileOffset,
                jlong size,
                jint block) {
-    SRTSOCKET u = Socket::getNative(env, ju);
     const char *path = env->GetStringUTFChars(filePath, nullptr);
     auto offset = (int64_t) fileOffset;
     int64_t res = srt_sendfile(u, path, &offset, (int64_t) size, block);
@@ -606,12 +940,12 @@ nativeSendFile(JNIEnv *env,
 
 jlong JNICALL
 nativeRecvFile(JNIEnv *env,
-               jobject ju,
+               jclass clazz,
+               jint u,
                jstring filePath,
                jlong fileOffset,
                jlong size,
                jint block) {
-    SRTSOCKET u = Socket::getNative(env, ju);
     const char *path = env->GetStringUTFChars(filePath, nullptr);
     auto offset = (int64_t) fileOffset;
     int64_t res = srt_recvfile(u, path, &offset, (int64_t) size, block);
@@ -650,8 +984,7 @@ nativeClearLastError(JNIEnv *env, jobject obj) {
 
 // Reject reason
 jint JNICALL
-nativeGetRejectReason(JNIEnv *env, jobject ju) {
-    SRTSOCKET u = Socket::getNative(env, ju);
+nativeGetRejectReason(JNIEnv *env, jclass clazz, jint u) {
     return srt_getrejectreason(u);
 }
 
@@ -664,8 +997,7 @@ obj) {
 }
 
 jint JNICALL
-nativeSetRejectReason(JNIEnv *env, jobject ju, jint rejectReason) {
-    SRTSOCKET u = Socket::getNative(env, ju);
+nativeSetRejectReason(JNIEnv *env, jclass clazz, jint u, jint rejectReason) {
     return srt_setrejectreason(u, rejectReason);
 }
 
@@ -691,6 +1023,107 @@ nativebistats(JNIEnv *env, jobject ju, jboolean clear, jboolean instantaneous) {
     return Stats::getJava(env, tracebstats);
 }
 
+jint JNICALL
+nativeBiStatsA(JNIEnv *env, jclass clazz, jint u, jboolean clear, jboolean instantaneous,
+               jlongArray longArray, jint offset) {
+    if ((offset < 0) || (env->GetArrayLength(longArray) < (offset + Stats::LAYOUT_SIZE))) {
+        return -1;
+    }
+
+    SRT_TRACEBSTATS tracebstats;
+    int res = srt_bistats(u, &tracebstats, clear, instantaneous);
+    if (res == 0) {
+        jlong values[Stats::LAYOUT_SIZE];
+        Stats::write(tracebstats, values);
+        env->SetLongArrayRegion(longArray, offset, Stats::LAYOUT_SIZE, values);
+    }
+
+    return res;
+}
+
+jint JNICALL
+nativeBiStatsLB(JNIEnv *env, jclass clazz, jint u, jboolean clear, jboolean instantaneous,
+                jobject longBuffer, jint offset) {
+    auto *buf = (jlong *) env->GetDirectBufferAddress(longBuffer);
+    // Capacity is in elements of the buffer
+    if ((buf == nullptr) || (offset < 0) ||
+        (env->GetDirectBufferCapacity(longBuffer) < (jlong) offset + Stats::LAYOUT_SIZE)) {
+        return -1;
+    }
+
+    SRT_TRACEBSTATS tracebstats;
+    int res = srt_bistats(u, &tracebstats, clear, instantaneous);
+    if (res == 0) {
+        Stats::write(tracebstats, &buf[offset]);
+    }
+
+    return res;
+}
+
+jint JNICALL
+nativeBiStatsDB(JNIEnv *env, jclass clazz, jint u, jboolean clear, jboolean instantaneous,
+                jobject doubleBuffer, jint offset) {
+    auto *buf = (jdouble *) env->GetDirectBufferAddress(doubleBuffer);
+    // Capacity is in elements of the buffer
+    if ((buf == nullptr) || (offset < 0) ||
+        (env->GetDirectBufferCapacity(doubleBuffer) < (jlong) offset + Stats::LAYOUT_SIZE)) {
+        return -1;
+    }
+
+    SRT_TRACEBSTATS tracebstats;
+    int res = srt_bistats(u, &tracebstats, clear, instantaneous);
+    if (res == 0) {
+        Stats::write(tracebstats, &buf[offset]);
+    }
+
+    return res;
+}
+
+jint JNICALL
+nativeStatsColumnsCollect(JNIEnv *env, jclass clazz, jintArray sockets, jint nSockets,
+                          jboolean clear, jboolean instantaneous, jlongArray columns,
+                          jint stride, jbooleanArray valids) {
+    if ((nSockets > stride) || (env->GetArrayLength(sockets) < nSockets) ||
+        (env->GetArrayLength(columns) < (Stats::LAYOUT_SIZE * stride)) ||
+        (env->GetArrayLength(valids) < nSockets)) {
+        return -1;
+    }
+
+    // Reused across calls of the same thread: statistics are retrieved before the Java arrays are
+    // pinned, as srt_bistats takes SRT locks.
+    static thread_local std::vector<SRTSOCKET> u;
+    static thread_local std::vector<SRT_TRACEBSTATS> tracebstats;
+    static thread_local std::vector<jboolean> valid;
+    if (u.size() < (size_t) nSockets) {
+        u.resize(nSockets);
+        tracebstats.resize(nSockets);
+        valid.resize(nSockets);
+    }
+    env->GetIntArrayRegion(sockets, 0, nSockets, u.data());
+
+    int nValid = 0;
+    for (int i = 0; i < nSockets; i++) {
+        valid[i] = srt_bistats(u[i], &tracebstats[i], clear, instantaneous) == 0;
+        if (valid[i]) {
+            nValid++;
+        }
+    }
+
+    auto *buf = (jlong *) env->GetPrimitiveArrayCritical(columns, nullptr);
+    if (buf == nullptr) {
+        return -1;
+    }
+    for (int i = 0; i < nSockets; i++) {
+        if (valid[i]) {
+            Stats::write(tracebstats[i], &buf[i], stride);
+        }
+    }
+    env->ReleasePrimitiveArrayCritical(columns, buf, 0);
+    env->SetBooleanArrayRegion(valids, 0, nSockets, valid.data());
+
+    return nValid;
+}
+
 // Asynchronous operations (epoll)
 jboolean JNICALL
 nativeEpollIsValid(JNIEnv *env, jobject epoll) {
@@ -760,11 +1193,13 @@ nativeEpollWait(JNIEnv *env, jobject epoll, jlong timeOut, jint rnum, jint wnum)
         for (int i = 0; i < rnum; i++) {
             jobject jSocket = Socket::getJava(env, readfds[i]);
             List::add(env, jReadfds, jSocket);
+            env->DeleteLocalRef(jSocket);
         }
 
         for (int i = 0; i < wnum; i++) {
             jobject jSocket = Socket::getJava(env, writefds[i]);
             List::add(env, jWritefds, jSocket);
+            env->DeleteLocalRef(jSocket);
         }
     }
 
@@ -793,6 +1228,7 @@ nativeEpollUWait(JNIEnv *env, jobject epoll, jlong timeOut, jint fdsSize) {
         for (int i = 0; i < res; i++) {
             jobject jEpollEvent = EpollEvent::getJava(env, epoll_events[i]);
             List::add(env, jEpollEvents, jEpollEvent);
+            env->DeleteLocalRef(jEpollEvent);
         }
     }
 
@@ -804,21 +1240,62 @@ nativeEpollUWait(JNIEnv *env, jobject epoll, jlong timeOut, jint fdsSize) {
 }
 
 jint JNICALL
-nativeEpollClearUSock(JNIEnv *env, jobject epoll) {
-    int eid = Epoll::getNative(env, epoll);
+nativeEpollUWaitB(JNIEnv *env, jclass clazz, jint eid, jlong timeOut, jobject intBuffer,
+                  jint offset, jint fdsSize) {
+    // SRT_EPOLL_EVENT is a (fd, events) pair of ints: let SRT write into the buffer directly.
+    static_assert(sizeof(SRT_EPOLL_EVENT) == 2 * sizeof(jint), "Unexpected SRT_EPOLL_EVENT layout");
+    auto *buf = (jint *) env->GetDirectBufferAddress(intBuffer);
+    // Capacity is in elements of the buffer
+    if ((buf == nullptr) || (offset < 0) || (fdsSize < 0) ||
+        (env->GetDirectBufferCapacity(intBuffer) < (jlong) offset + 2 * (jlong) fdsSize)) {
+        return -1;
+    }
 
-    return srt_epoll_clear_usocks(eid);
+    int res = srt_epoll_uwait(eid, reinterpret_cast<SRT_EPOLL_EVENT *>(&buf[offset]), fdsSize,
+                              timeOut);
+
+    return res < fdsSize ? res : fdsSize;
 }
 
+jint JNICALL
+nativeEpollUWaitA(JNIEnv *env, jclass clazz, jint eid, jlong timeOut, jintArray intArray,
+                  jint offset, jint fdsSize) {
+    if ((offset < 0) || (fdsSize < 0) ||
+        (env->GetArrayLength(intArray) < (jlong) offset + 2 * (jlong) fdsSize)) {
+        return -1;
+    }
 
-jobject JNICALL
-nativeEpollSet(JNIEnv *env, jobject epoll, jobject epollFlagList) {
-    int eid = Epoll::getNative(env, epoll);
-    int32_t flags = EpollFlags::getNative(env, epollFlagList);
+    // Reused across calls of the same thread as the wait must not hold the Java array
+    static thread_local std::vector<SRT_EPOLL_EVENT> epoll_events;
+    if (epoll_events.size() < (size_t) fdsSize) {
+        epoll_events.resize(fdsSize);
+    }
 
-    flags = srt_epoll_set(eid, flags);
-    if (flags == -1) {
-        return nullptr;
+    int res = srt_epoll_uwait(eid, epoll_events.data(), fdsSize, timeOut);
+    if (res > 0) {
+        res = res < fdsSize ? res : fdsSize;
+        env->SetIntArrayRegion(intArray, offset, 2 * res, (jint *) epoll_events.data());
+    }
+
+    return res;
+}
+
+jint JNICALL
+nativeEpollClearUSock(JNIEnv *env, jobject epoll) {
+    int eid = Epoll::getNative(env, epoll);
+
+    return srt_epoll_clear_usocks(eid);
+}
+
+
+jobject JNICALL
+nativeEpollSet(JNIEnv *env, jobject epoll, jobject epollFlagList) {
+    int eid = Epoll::getNative(env, epoll);
+    int32_t flags = EpollFlags::getNative(env, epollFlagList);
+
+    flags = srt_epoll_set(eid, flags);
+    if (flags == -1) {
+        return nullptr;
     }
     return EpollFlags::getJava(env, flags);
 }
@@ -845,6 +1322,431 @@ nativeEpollRelease(JNIEnv *env, jobject epoll) {
 }
 
 
+// Epoll reactor
+jlong JNICALL
+nativeEpollReactorCreate(JNIEnv *env, jobject reactor, jobject events, jint maxEvents,
+                         jint timeoutInMs) {
+    auto *epollReactor = new EpollReactor(env, reactor, events, maxEvents, timeoutInMs);
+    if (!epollReactor->isValid()) {
+        delete epollReactor;
+        return 0;
+    }
+
+    return (jlong) epollReactor;
+}
+
+jint JNICALL
+nativeEpollReactorAdd(JNIEnv *env, jclass clazz, jlong ptr, jint u, jint events) {
+    return reinterpret_cast<EpollReactor *>(ptr)->add(u, events);
+}
+
+jint JNICALL
+nativeEpollReactorUpdate(JNIEnv *env, jclass clazz, jlong ptr, jint u, jint events) {
+    return reinterpret_cast<EpollReactor *>(ptr)->update(u, events);
+}
+
+jint JNICALL
+nativeEpollReactorRemove(JNIEnv *env, jclass clazz, jlong ptr, jint u) {
+    return reinterpret_cast<EpollReactor *>(ptr)->remove(u);
+}
+
+void JNICALL
+nativeEpollReactorRelease(JNIEnv *env, jclass clazz, jlong ptr) {
+    reinterpret_cast<EpollReactor *>(ptr)->release();
+}
+
+// Statistics sampler
+jlong JNICALL
+nativeStatsSamplerCreate(JNIEnv *env, jobject sampler, jint intervalInMs, jint historySize) {
+    auto *statsSampler = new StatsSampler(env, sampler, intervalInMs, historySize);
+    if (!statsSampler->isValid()) {
+        delete statsSampler;
+        return 0;
+    }
+
+    return (jlong) statsSampler;
+}
+
+void JNICALL
+nativeStatsSamplerSubscribe(JNIEnv *env, jclass clazz, jlong ptr, jint u) {
+    if (ptr == 0) {
+        return;
+    }
+    reinterpret_cast<StatsSampler *>(ptr)->subscribe(u);
+}
+
+void JNICALL
+nativeStatsSamplerUnsubscribe(JNIEnv *env, jclass clazz, jlong ptr, jint u) {
+    if (ptr == 0) {
+        return;
+    }
+    reinterpret_cast<StatsSampler *>(ptr)->unsubscribe(u);
+}
+
+jint JNICALL
+nativeStatsSamplerAddThreshold(JNIEnv *env, jclass clazz, jlong ptr, jint id, jint field,
+                               jboolean isAbove, jdouble value) {
+    if (ptr == 0) {
+        return -1;
+    }
+    return reinterpret_cast<StatsSampler *>(ptr)->addThreshold(id, field, isAbove, value);
+}
+
+void JNICALL
+nativeStatsSamplerRemoveThreshold(JNIEnv *env, jclass clazz, jlong ptr, jint id) {
+    if (ptr == 0) {
+        return;
+    }
+    reinterpret_cast<StatsSampler *>(ptr)->removeThreshold(id);
+}
+
+jint JNICALL
+nativeStatsSamplerRead(JNIEnv *env, jclass clazz, jlong ptr, jint u, jlong windowInMs,
+                       jlongArray samples, jint maxSamples) {
+    if ((ptr == 0) || (maxSamples < 0) ||
+        (env->GetArrayLength(samples) < (jlong) maxSamples * StatsSampler::SAMPLE_SIZE)) {
+        return -1;
+    }
+
+    // Reused across calls of the same thread: the sampler lock is not held while copying to Java
+    static thread_local std::vector<jlong> buffer;
+    if (buffer.size() < (size_t) maxSamples * StatsSampler::SAMPLE_SIZE) {
+        buffer.resize((size_t) maxSamples * StatsSampler::SAMPLE_SIZE);
+    }
+
+    int res = reinterpret_cast<StatsSampler *>(ptr)->read(u, windowInMs, buffer.data(),
+                                                          maxSamples);
+    if (res > 0) {
+        env->SetLongArrayRegion(samples, 0, res * StatsSampler::SAMPLE_SIZE, buffer.data());
+    }
+
+    return res;
+}
+
+void JNICALL
+nativeStatsSamplerRelease(JNIEnv *env, jclass clazz, jlong ptr) {
+    if (ptr == 0) {
+        return;
+    }
+    reinterpret_cast<StatsSampler *>(ptr)->release();
+}
+
+// Bitrate controller
+jlong JNICALL
+nativeBitrateControllerCreate(JNIEnv *env, jobject controller, jint u, jdoubleArray config,
+                              jint intervalInMs, jint maxBwOverheadPercent) {
+    if (env->GetArrayLength(config) != BitrateEstimator::Config::SIZE) {
+        return 0;
+    }
+    jdouble values[BitrateEstimator::Config::SIZE];
+    env->GetDoubleArrayRegion(config, 0, BitrateEstimator::Config::SIZE, values);
+
+    auto *bitrateController = new BitrateController(env, controller, u,
+                                                    BitrateEstimator::Config::fromArray(values),
+                                                    intervalInMs, maxBwOverheadPercent);
+    if (!bitrateController->isValid()) {
+        delete bitrateController;
+        return 0;
+    }
+
+    return (jlong) bitrateController;
+}
+
+void JNICALL
+nativeBitrateControllerRelease(JNIEnv *env, jclass clazz, jlong ptr) {
+    reinterpret_cast<BitrateController *>(ptr)->release();
+}
+
+jint JNICALL
+nativeBitrateControllerSimulate(JNIEnv *env, jclass clazz, jdoubleArray config,
+                                jlongArray samples, jint nSamples, jlongArray bitrates) {
+    if ((env->GetArrayLength(config) != BitrateEstimator::Config::SIZE) ||
+        (env->GetArrayLength(samples) < (nSamples * StatsSampler::SAMPLE_SIZE)) ||
+        (env->GetArrayLength(bitrates) < nSamples)) {
+        return -1;
+    }
+    jdouble values[BitrateEstimator::Config::SIZE];
+    env->GetDoubleArrayRegion(config, 0, BitrateEstimator::Config::SIZE, values);
+
+    BitrateEstimator estimator(BitrateEstimator::Config::fromArray(values));
+    std::vector<jlong> sample(StatsSampler::SAMPLE_SIZE);
+    std::vector<jlong> bitrate(nSamples);
+    for (int i = 0; i < nSamples; i++) {
+        env->GetLongArrayRegion(samples, i * StatsSampler::SAMPLE_SIZE, StatsSampler::SAMPLE_SIZE,
+                                sample.data());
+        bitrate[i] = estimator.update(sample.data());
+    }
+    env->SetLongArrayRegion(bitrates, 0, nSamples, bitrate.data());
+
+    return nSamples;
+}
+
+// Bridge
+jlong JNICALL
+nativeBridgeCreate(JNIEnv *env, jobject bridge, jint u, jint direction, jobject inetSocketAddress,
+                   jint chunkSize, jboolean pace) {
+    int size = 0;
+    const struct sockaddr_storage *ss = InetSocketAddress::getNative(env, inetSocketAddress, &size);
+
+    auto *nativeBridge = new Bridge(env, bridge, u, (Bridge::Direction) direction, ss, size,
+                                    chunkSize, pace);
+
+    if (ss) {
+        free((void *) ss);
+    }
+
+    if (!nativeBridge->isValid()) {
+        delete nativeBridge;
+        return 0;
+    }
+
+    return (jlong) nativeBridge;
+}
+
+jint JNICALL
+nativeBridgeGetLocalPort(JNIEnv *env, jclass clazz, jlong ptr) {
+    if (ptr == 0) {
+        return -1;
+    }
+    return reinterpret_cast<Bridge *>(ptr)->getLocalPort();
+}
+
+void JNICALL
+nativeBridgeGetCounters(JNIEnv *env, jclass clazz, jlong ptr, jlongArray counters) {
+    if ((ptr == 0) || (env->GetArrayLength(counters) < Bridge::COUNTER_COUNT)) {
+        return;
+    }
+    jlong values[Bridge::COUNTER_COUNT];
+    reinterpret_cast<Bridge *>(ptr)->getCounters(values);
+    env->SetLongArrayRegion(counters, 0, Bridge::COUNTER_COUNT, values);
+}
+
+void JNICALL
+nativeBridgeRelease(JNIEnv *env, jclass clazz, jlong ptr) {
+    reinterpret_cast<Bridge *>(ptr)->release();
+}
+
+// Relay
+jlong JNICALL
+nativeRelayCreate(JNIEnv *env, jobject relay, jint input, jint maxPayloadSize) {
+    auto *nativeRelay = new Relay(env, relay, input, maxPayloadSize);
+    if (!nativeRelay->isValid()) {
+        delete nativeRelay;
+        return 0;
+    }
+
+    return (jlong) nativeRelay;
+}
+
+jboolean JNICALL
+nativeRelayAddOutput(JNIEnv *env, jclass clazz, jlong ptr, jint u) {
+    if (ptr == 0) {
+        return JNI_FALSE;
+    }
+    return reinterpret_cast<Relay *>(ptr)->getOutputs().add(u);
+}
+
+jboolean JNICALL
+nativeRelayRemoveOutput(JNIEnv *env, jclass clazz, jlong ptr, jint u) {
+    if (ptr == 0) {
+        return JNI_FALSE;
+    }
+    return reinterpret_cast<Relay *>(ptr)->getOutputs().remove(u);
+}
+
+void JNICALL
+nativeRelayGetCounters(JNIEnv *env, jclass clazz, jlong ptr, jlongArray counters) {
+    if ((ptr == 0) || (env->GetArrayLength(counters) < Relay::COUNTER_COUNT)) {
+        return;
+    }
+    jlong values[Relay::COUNTER_COUNT];
+    reinterpret_cast<Relay *>(ptr)->getCounters(values);
+    env->SetLongArrayRegion(counters, 0, Relay::COUNTER_COUNT, values);
+}
+
+jboolean JNICALL
+nativeRelayGetOutputCounters(JNIEnv *env, jclass clazz, jlong ptr, jint u, jlongArray counters) {
+    if ((ptr == 0) || (env->GetArrayLength(counters) < FanOutGroup::COUNTER_COUNT)) {
+        return JNI_FALSE;
+    }
+    jlong values[FanOutGroup::COUNTER_COUNT];
+    if (!reinterpret_cast<Relay *>(ptr)->getOutputs().getCounters(u, values)) {
+        return JNI_FALSE;
+    }
+    env->SetLongArrayRegion(counters, 0, FanOutGroup::COUNTER_COUNT, values);
+    return JNI_TRUE;
+}
+
+void JNICALL
+nativeRelayRelease(JNIEnv *env, jclass clazz, jlong ptr) {
+    reinterpret_cast<Relay *>(ptr)->release();
+}
+
+// SendRing
+jlong JNICALL
+nativeSendRingCreate(JNIEnv *env, jobject sendRing, jint u, jobject buffer, jint capacity,
+                     jint slotSize) {
+    auto *ring = new SendRing(env, buffer, u, capacity, slotSize);
+    if (!ring->isValid()) {
+        delete ring;
+        return 0;
+    }
+
+    return (jlong) ring;
+}
+
+void JNICALL
+nativeSendRingWake(JNIEnv *env, jclass clazz, jlong ptr) {
+    if (ptr == 0) {
+        return;
+    }
+    reinterpret_cast<SendRing *>(ptr)->wake();
+}
+
+void JNICALL
+nativeSendRingGetCounters(JNIEnv *env, jclass clazz, jlong ptr, jlongArray counters) {
+    if ((ptr == 0) || (env->GetArrayLength(counters) < SendRing::COUNTER_COUNT)) {
+        return;
+    }
+    jlong values[SendRing::COUNTER_COUNT];
+    reinterpret_cast<SendRing *>(ptr)->getCounters(values);
+    env->SetLongArrayRegion(counters, 0, SendRing::COUNTER_COUNT, values);
+}
+
+void JNICALL
+nativeSendRingRelease(JNIEnv *env, jclass clazz, jlong ptr) {
+    delete reinterpret_cast<SendRing *>(ptr);
+}
+
+// FanOutGroup
+jlong JNICALL
+nativeFanOutGroupCreate(JNIEnv *env, jclass clazz) {
+    return (jlong) new FanOutGroup();
+}
+
+jboolean JNICALL
+nativeFanOutGroupAdd(JNIEnv *env, jclass clazz, jlong ptr, jint u) {
+    if (ptr == 0) {
+        return JNI_FALSE;
+    }
+    return reinterpret_cast<FanOutGroup *>(ptr)->add(u);
+}
+
+jboolean JNICALL
+nativeFanOutGroupRemove(JNIEnv *env, jclass clazz, jlong ptr, jint u) {
+    if (ptr == 0) {
+        return JNI_FALSE;
+    }
+    return reinterpret_cast<FanOutGroup *>(ptr)->remove(u);
+}
+
+static jint fanOutGroupSend(JNIEnv *env, jobject group, jlong ptr, const char *data, jint len,
+                            jobject msgCtrlBuffer) {
+    if (ptr == 0) {
+        return SRT_ERROR;
+    }
+    static thread_local std::vector<FanOutGroup::Eviction> evictions;
+    evictions.clear();
+
+    int res = reinterpret_cast<FanOutGroup *>(ptr)->send(data, len,
+                                                         MsgCtrl::getNative(env, msgCtrlBuffer),
+                                                         evictions);
+
+    // Out of the group lock: the Java side may add or remove members
+    jmethodID onEvictedMethod = ModelsSingleton::getInstance(env)->fanOutGroupOnEvictedMethod;
+    for (const auto &eviction: evictions) {
+        jobject errorType = EnumsSingleton::getInstance(env)->errorType->getJavaValue(
+                env, (SRT_ERRNO) eviction.error);
+        env->CallVoidMethod(group, onEvictedMethod, eviction.u, errorType);
+        env->DeleteLocalRef(errorType);
+        if (env->ExceptionCheck()) {
+            return SRT_ERROR;
+        }
+    }
+
+    return res;
+}
+
+jint JNICALL
+nativeFanOutGroupSendB(JNIEnv *env,
+                       jobject group,
+                       jlong ptr,
+                       jobject byteBuffer,
+                       jint offset,
+                       jint len,
+                       jobject msgCtrlBuffer) {
+    char *buf = (char *) env->GetDirectBufferAddress(byteBuffer);
+    if (buf == nullptr) {
+        return SRT_ERROR;
+    }
+
+    return fanOutGroupSend(env, group, ptr, &buf[offset], len, msgCtrlBuffer);
+}
+
+jint JNICALL
+nativeFanOutGroupSendA(JNIEnv *env,
+                       jobject group,
+                       jlong ptr,
+                       jbyteArray byteArray,
+                       jint offset,
+                       jint len,
+                       jobject msgCtrlBuffer) {
+    // Copied once for all members. Not pinned as sending might block.
+    static thread_local std::vector<jbyte> buf;
+    if (buf.size() < (size_t) len) {
+        buf.resize(len);
+    }
+    env->GetByteArrayRegion(byteArray, offset, len, buf.data());
+
+    return fanOutGroupSend(env, group, ptr, (const char *) buf.data(), len, msgCtrlBuffer);
+}
+
+jboolean JNICALL
+nativeFanOutGroupGetCounters(JNIEnv *env, jclass clazz, jlong ptr, jint u, jlongArray counters) {
+    if ((ptr == 0) || (env->GetArrayLength(counters) < FanOutGroup::COUNTER_COUNT)) {
+        return JNI_FALSE;
+    }
+    jlong values[FanOutGroup::COUNTER_COUNT];
+    if (!reinterpret_cast<FanOutGroup *>(ptr)->getCounters(u, values)) {
+        return JNI_FALSE;
+    }
+    env->SetLongArrayRegion(counters, 0, FanOutGroup::COUNTER_COUNT, values);
+    return JNI_TRUE;
+}
+
+void JNICALL
+nativeFanOutGroupRelease(JNIEnv *env, jclass clazz, jlong ptr) {
+    delete reinterpret_cast<FanOutGroup *>(ptr);
+}
+
+// RecvRing
+jlong JNICALL
+nativeRecvRingCreate(JNIEnv *env, jobject recvRing, jint u, jobject buffer, jint capacity,
+                     jint slotSize) {
+    auto *ring = new RecvRing(env, recvRing, buffer, u, capacity, slotSize);
+    if (!ring->isValid()) {
+        delete ring;
+        return 0;
+    }
+
+    return (jlong) ring;
+}
+
+void JNICALL
+nativeRecvRingGetCounters(JNIEnv *env, jclass clazz, jlong ptr, jlongArray counters) {
+    if ((ptr == 0) || (env->GetArrayLength(counters) < RecvRing::COUNTER_COUNT)) {
+        return;
+    }
+    jlong values[RecvRing::COUNTER_COUNT];
+    reinterpret_cast<RecvRing *>(ptr)->getCounters(values);
+    env->SetLongArrayRegion(counters, 0, RecvRing::COUNTER_COUNT, values);
+}
+
+void JNICALL
+nativeRecvRingRelease(JNIEnv *env, jclass clazz, jlong ptr) {
+    reinterpret_cast<RecvRing *>(ptr)->release();
+}
+
 // Logging control
 void JNICALL
 nativeSetLogLevel(JNIEnv *env, jobject obj, jint level) {
@@ -859,10 +1761,7 @@ nativeNow(JNIEnv *env, jobject obj) {
 }
 
 jlong JNICALL
-nativeGetConnectionTime(JNIEnv *env,
-                        jobject ju) {
-    SRTSOCKET u = Socket::getNative(env, ju);
-
+nativeGetConnectionTime(JNIEnv *env, jclass clazz, jint u) {
     return (jlong) srt_connection_time(u);
 }
 
@@ -876,37 +1775,51 @@ static JNINativeMethod srtMethods[] = {
 };
 
 static JNINativeMethod socketMethods[] = {
-        {"nativeIsValid",           "()Z",                                                           (void *) &nativeIsValid},
+        {"nativeIsValid",           "(I)Z",                                                          (void *) &nativeIsValid},
         {"nativeCreateSocket",      "(Ljava/net/StandardProtocolFamily;II)I",                        (void *) &nativeCreateSocketFamily},
         {"nativeCreateSocket",      "()I",                                                           (void *) &nativeCreateSocket},
         {"nativeBind",              "(L" INETSOCKETADDRESS_CLASS ";)I",                              (void *) &nativeBind},
         {"nativeGetSockState",      "()L" SOCKSTATUS_CLASS ";",                                      (void *) &nativeGetSockState},
-        {"nativeClose",             "()I",                                                           (void *) &nativeClose},
+        {"nativeClose",             "(I)I",                                                          (void *) &nativeClose},
+        {"nativeRegister",          "(IL" SRTSOCKET_CLASS ";)V",                                     (void *) &nativeRegister},
         {"nativeListen",            "(I)I",                                                          (void *) &nativeListen},
+        {"nativeSetAdmissionPolicy", "(I[I[Ljava/lang/String;[Ljava/lang/String;[III[DI)I",          (void *) &nativeSetAdmissionPolicy},
         {"nativeAccept",            "()L" PAIR_CLASS ";",                                            (void *) &nativeAccept},
         {"nativeConnect",           "(L" INETSOCKETADDRESS_CLASS ";)I",                              (void *) &nativeConnect},
         {"nativeRendezVous",        "(L" INETSOCKETADDRESS_CLASS ";L" INETSOCKETADDRESS_CLASS ";)I", (void *) &nativeRendezVous},
         {"nativeGetPeerName",       "()L" INETSOCKETADDRESS_CLASS ";",                               (void *) &nativeGetPeerName},
         {"nativeGetSockName",       "()L" INETSOCKETADDRESS_CLASS ";",                               (void *) &nativeGetSockName},
         {"nativeGetSockFlag",       "(L" SOCKOPT_CLASS ";)Ljava/lang/Object;",                       (void *) &nativeGetSockOpt},
-        {"nativeSetSockFlag",       "(L" SOCKOPT_CLASS ";Ljava/lang/Object;)I",                      (void *) &nativeSetSockOpt},
-        {"nativeSend",              "(Ljava/nio/ByteBuffer;II)I",                                    (void *) &nativeSend2},
-        {"nativeSend",              "([BII)I",                                                       (void *) &nativeSend},
-        {"nativeSend",              "(Ljava/nio/ByteBuffer;IIIZ)I",                                  (void *) &nativeSendMsg2},
-        {"nativeSend",              "([BIIIZ)I",                                                     (void *) &nativeSendMsg},
-        {"nativeSend",              "(Ljava/nio/ByteBuffer;IIL" MSGCTRL_CLASS ";)I",                 (void *) &nativeSendMsgCtrl2},
-        {"nativeSend",              "([BIIL" MSGCTRL_CLASS ";)I",                                    (void *) &nativeSendMsgCtrl},
-        {"nativeRecv",              "(I)L" PAIR_CLASS ";",                                           (void *) &nativeRecv},
-        {"nativeRecv",              "([BII)L" PAIR_CLASS ";",                                        (void *) &nativeRecvA},
-        {"nativeRecv",              "(IL" MSGCTRL_CLASS ";)L" PAIR_CLASS ";",                        (void *) &nativeRecvMsg2},
-        {"nativeRecv",              "([BIIL" MSGCTRL_CLASS ";)L" PAIR_CLASS ";",                     (void *) &nativeRecvMsg2A},
-        {"nativeSendFile",          "(Ljava/lang/String;JJI)J",                                      (void *) &nativeSendFile},
-        {"nativeRecvFile",          "(Ljava/lang/String;JJI)J",                                      (void *) &nativeRecvFile},
-        {"nativeGetRejectReason",   "()I",                                                           (void *) &nativeGetRejectReason},
-        {"nativeSetRejectReason",   "(I)I",                                                          (void *) &nativeSetRejectReason},
+        {"nativeSetSockOpt",        "(III)I",                                                        (void *) &nativeSetSockOptInt},
+        {"nativeSetSockOpt",        "(IIJ)I",                                                        (void *) &nativeSetSockOptLong},
+        {"nativeSetSockOpt",        "(IIZ)I",                                                        (void *) &nativeSetSockOptBool},
+        {"nativeSetSockOpt",        "(IILjava/lang/String;)I",                                       (void *) &nativeSetSockOptString},
+        {"nativeApplyOptions",      "(I[I[I[J[Ljava/lang/String;)I",                                 (void *) &nativeApplyOptions},
+        {"nativeSnapshotOptions",   "(I[I[J)I",                                                      (void *) &nativeSnapshotOptions},
+        {"nativeSetSndWatermarks",  "(IIJJI)I",                                                      (void *) &nativeSetSendBufferWatermarks},
+        {"nativeGetSndBufferLevel", "(II)J",                                                         (void *) &nativeGetSendBufferLevel},
+        {"nativeSend",              "(ILjava/nio/ByteBuffer;II)I",                                   (void *) &nativeSend2},
+        {"nativeSend",              "(I[BII)I",                                                      (void *) &nativeSend},
+        {"nativeSend",              "(ILjava/nio/ByteBuffer;IIIZ)I",                                 (void *) &nativeSendMsg2},
+        {"nativeSend",              "(I[BIIIZ)I",                                                    (void *) &nativeSendMsg},
+        {"nativeSend",              "(ILjava/nio/ByteBuffer;IILjava/nio/ByteBuffer;)I",              (void *) &nativeSendMsgCtrl2},
+        {"nativeSend",              "(I[BIILjava/nio/ByteBuffer;)I",                                 (void *) &nativeSendMsgCtrl},
+        {"nativeSendBatch",         "(ILjava/nio/ByteBuffer;[I[I[JIIZ[I)I",                          (void *) &nativeSendBatch},
+        {"nativeRecv",              "(ILjava/nio/ByteBuffer;II)I",                                   (void *) &nativeRecvB},
+        {"nativeRecv",              "(I[BII)I",                                                      (void *) &nativeRecvA},
+        {"nativeRecv",              "(ILjava/nio/ByteBuffer;IILjava/nio/ByteBuffer;)I",              (void *) &nativeRecvMsg2B},
+        {"nativeRecv",              "(I[BIILjava/nio/ByteBuffer;)I",                                 (void *) &nativeRecvMsg2A},
+        {"nativeSendFile",          "(ILjava/lang/String;JJI)J",                                     (void *) &nativeSendFile},
+        {"nativeRecvBatch",         "(ILjava/nio/ByteBuffer;II[I[J[II)I",                            (void *) &nativeRecvBatch},
+        {"nativeRecvFile",          "(ILjava/lang/String;JJI)J",                                     (void *) &nativeRecvFile},
+        {"nativeGetRejectReason",   "(I)I",                                                          (void *) &nativeGetRejectReason},
+        {"nativeSetRejectReason",   "(II)I",                                                         (void *) &nativeSetRejectReason},
         {"bstats",                  "(Z)L" STATS_CLASS ";",                                          (void *) &nativebstats},
         {"bistats",                 "(ZZ)L" STATS_CLASS ";",                                         (void *) &nativebistats},
-        {"nativeGetConnectionTime", "()J",                                                           (void *) &nativeGetConnectionTime}
+        {"nativeBiStats",           "(IZZ[JI)I",                                                     (void *) &nativeBiStatsA},
+        {"nativeBiStats",           "(IZZLjava/nio/LongBuffer;I)I",                                  (void *) &nativeBiStatsLB},
+        {"nativeBiStats",           "(IZZLjava/nio/DoubleBuffer;I)I",                                (void *) &nativeBiStatsDB},
+        {"nativeGetConnectionTime", "(I)J",                                                          (void *) &nativeGetConnectionTime}
 };
 
 static JNINativeMethod rejectReasonMethods[] = {
@@ -935,12 +1848,81 @@ static JNINativeMethod epollMethods[] = {
         {"nativeRemoveUSock", "(L" SRTSOCKET_CLASS ";)I",                 (void *) &nativeEpollRemoveUSock},
         {"nativeWait",        "(JII)L" PAIR_CLASS ";",                    (void *) &nativeEpollWait},
         {"nativeUWait",       "(JI)L" PAIR_CLASS ";",                     (void *) &nativeEpollUWait},
+        {"nativeUWait",       "(IJLjava/nio/IntBuffer;II)I",              (void *) &nativeEpollUWaitB},
+        {"nativeUWait",       "(IJ[III)I",                                (void *) &nativeEpollUWaitA},
         {"nativeClearUSock",  "()I",                                      (void *) &nativeEpollClearUSock},
         {"nativeSetFlags",    "(L" LIST_CLASS ";)L" LIST_CLASS ";",       (void *) &nativeEpollSet},
         {"nativeGetFlags",    "()L" LIST_CLASS ";",                       (void *) &nativeEpollGet},
         {"nativeRelease",     "()I",                                      (void *) &nativeEpollRelease}
 };
 
+static JNINativeMethod epollReactorMethods[] = {
+        {"nativeCreate",  "(Ljava/nio/IntBuffer;II)J", (void *) &nativeEpollReactorCreate},
+        {"nativeAdd",     "(JII)I",                    (void *) &nativeEpollReactorAdd},
+        {"nativeUpdate",  "(JII)I",                    (void *) &nativeEpollReactorUpdate},
+        {"nativeRemove",  "(JI)I",                     (void *) &nativeEpollReactorRemove},
+        {"nativeRelease", "(J)V",                      (void *) &nativeEpollReactorRelease}
+};
+
+static JNINativeMethod bitrateControllerMethods[] = {
+        {"nativeCreate",   "(I[DII)J",   (void *) &nativeBitrateControllerCreate},
+        {"nativeRelease",  "(J)V",       (void *) &nativeBitrateControllerRelease},
+        {"nativeSimulate", "([D[JI[J)I", (void *) &nativeBitrateControllerSimulate}
+};
+
+static JNINativeMethod bridgeMethods[] = {
+        {"nativeCreate",       "(IILjava/net/InetSocketAddress;IZ)J", (void *) &nativeBridgeCreate},
+        {"nativeGetLocalPort", "(J)I",                                (void *) &nativeBridgeGetLocalPort},
+        {"nativeGetCounters",  "(J[J)V",                              (void *) &nativeBridgeGetCounters},
+        {"nativeRelease",      "(J)V",                                (void *) &nativeBridgeRelease}
+};
+
+static JNINativeMethod fanOutGroupMethods[] = {
+        {"nativeCreate",      "()J",                                              (void *) &nativeFanOutGroupCreate},
+        {"nativeAdd",         "(JI)Z",                                            (void *) &nativeFanOutGroupAdd},
+        {"nativeRemove",      "(JI)Z",                                            (void *) &nativeFanOutGroupRemove},
+        {"nativeSend",        "(JLjava/nio/ByteBuffer;IILjava/nio/ByteBuffer;)I", (void *) &nativeFanOutGroupSendB},
+        {"nativeSend",        "(J[BIILjava/nio/ByteBuffer;)I",                    (void *) &nativeFanOutGroupSendA},
+        {"nativeGetCounters", "(JI[J)Z",                                          (void *) &nativeFanOutGroupGetCounters},
+        {"nativeRelease",     "(J)V",                                             (void *) &nativeFanOutGroupRelease}
+};
+
+static JNINativeMethod recvRingMethods[] = {
+        {"nativeCreate",      "(ILjava/nio/ByteBuffer;II)J", (void *) &nativeRecvRingCreate},
+        {"nativeGetCounters", "(J[J)V",                      (void *) &nativeRecvRingGetCounters},
+        {"nativeRelease",     "(J)V",                        (void *) &nativeRecvRingRelease}
+};
+
+static JNINativeMethod relayMethods[] = {
+        {"nativeCreate",            "(II)J",   (void *) &nativeRelayCreate},
+        {"nativeAddOutput",         "(JI)Z",   (void *) &nativeRelayAddOutput},
+        {"nativeRemoveOutput",      "(JI)Z",   (void *) &nativeRelayRemoveOutput},
+        {"nativeGetCounters",       "(J[J)V",  (void *) &nativeRelayGetCounters},
+        {"nativeGetOutputCounters", "(JI[J)Z", (void *) &nativeRelayGetOutputCounters},
+        {"nativeRelease",           "(J)V",    (void *) &nativeRelayRelease}
+};
+
+static JNINativeMethod sendRingMethods[] = {
+        {"nativeCreate",      "(ILjava/nio/ByteBuffer;II)J", (void *) &nativeSendRingCreate},
+        {"nativeWake",        "(J)V",                        (void *) &nativeSendRingWake},
+        {"nativeGetCounters", "(J[J)V",                      (void *) &nativeSendRingGetCounters},
+        {"nativeRelease",     "(J)V",                        (void *) &nativeSendRingRelease}
+};
+
+static JNINativeMethod statsSamplerMethods[] = {
+        {"nativeCreate",          "(II)J",     (void *) &nativeStatsSamplerCreate},
+        {"nativeSubscribe",       "(JI)V",     (void *) &nativeStatsSamplerSubscribe},
+        {"nativeUnsubscribe",     "(JI)V",     (void *) &nativeStatsSamplerUnsubscribe},
+        {"nativeAddThreshold",    "(JIIZD)I",  (void *) &nativeStatsSamplerAddThreshold},
+        {"nativeRemoveThreshold", "(JI)V",     (void *) &nativeStatsSamplerRemoveThreshold},
+        {"nativeRead",            "(JIJ[JI)I", (void *) &nativeStatsSamplerRead},
+        {"nativeRelease",         "(J)V",      (void *) &nativeStatsSamplerRelease}
+};
+
+static JNINativeMethod statsColumnsMethods[] = {
+        {"nativeCollect", "([IIZZ[JI[Z)I", (void *) &nativeStatsColumnsCollect}
+};
+
 static int registerNativeForClassName(JNIEnv *env, const char *className,
                                       JNINativeMethod *methods, int methodsSize) {
     jclass clazz = env->FindClass(className);
@@ -1013,8 +1995,73 @@ jint JNI_OnLoad(JavaVM *vm, void * /*reserved*/) {
         return -1;
     }
 
-    // Force to load enums when we get the real JNI environment (does not work in callback)
+    if ((registerNativeForClassName(env, EPOLLREACTOR_CLASS, epollReactorMethods,
+                                    sizeof(epollReactorMethods) / sizeof(epollReactorMethods[0])) !=
+         JNI_TRUE)) {
+        LOGE("EpollReactor RegisterNatives failed");
+        return -1;
+    }
+
+    if ((registerNativeForClassName(env, STATSCOLUMNS_CLASS, statsColumnsMethods,
+                                    sizeof(statsColumnsMethods) / sizeof(statsColumnsMethods[0])) !=
+         JNI_TRUE)) {
+        LOGE("StatsColumns RegisterNatives failed");
+        return -1;
+    }
+
+    if ((registerNativeForClassName(env, STATSSAMPLER_CLASS, statsSamplerMethods,
+                                    sizeof(statsSamplerMethods) / sizeof(statsSamplerMethods[0])) !=
+         JNI_TRUE)) {
+        LOGE("StatsSampler RegisterNatives failed");
+        return -1;
+    }
+
+    if ((registerNativeForClassName(env, BITRATECONTROLLER_CLASS, bitrateControllerMethods,
+                                    sizeof(bitrateControllerMethods) /
+                                    sizeof(bitrateControllerMethods[0])) != JNI_TRUE)) {
+        LOGE("BitrateController RegisterNatives failed");
+        return -1;
+    }
+
+    if ((registerNativeForClassName(env, BRIDGE_CLASS, bridgeMethods,
+                                    sizeof(bridgeMethods) / sizeof(bridgeMethods[0])) != JNI_TRUE)) {
+        LOGE("Bridge RegisterNatives failed");
+        return -1;
+    }
+
+    if ((registerNativeForClassName(env, RELAY_CLASS, relayMethods,
+                                    sizeof(relayMethods) / sizeof(relayMethods[0])) != JNI_TRUE)) {
+        LOGE("Relay RegisterNatives failed");
+        return -1;
+    }
+
+    if ((registerNativeForClassName(env, SENDRING_CLASS, sendRingMethods,
+                                    sizeof(sendRingMethods) / sizeof(sendRingMethods[0])) !=
+         JNI_TRUE)) {
+        LOGE("SendRing RegisterNatives failed");
+        return -1;
+    }
+
+    if ((registerNativeForClassName(env, FANOUTGROUP_CLASS, fanOutGroupMethods,
+                                    sizeof(fanOutGroupMethods) / sizeof(fanOutGroupMethods[0])) !=
+         JNI_TRUE)) {
+        LOGE("FanOutGroup RegisterNatives failed");
+        return -1;
+    }
+
+    if ((registerNativeForClassName(env, RECVRING_CLASS, recvRingMethods,
+                                    sizeof(recvRingMethods) / sizeof(recvRingMethods[0])) !=
+         JNI_TRUE)) {
+        LOGE("RecvRing RegisterNatives failed");
+        return -1;
+    }
+
+    // Force to load enums and models when we get the real JNI environment (does not work in callback)
     EnumsSingleton::getInstance(env);
+    if (!ModelsSingleton::getInstance(env)->isLoaded()) {
+        LOGE("Failed to load Java classes");
+        return -1;
+    }
 
     return JNI_VERSION_1_6;
 }
\ No newline at end of file
@@ -5,24 +5,34 @@ import io.github.thibaultbee.srtdroid.core.models.MsgCtrl
 /**
  * To be use as [MsgCtrl.boundary]
  */
-enum class Boundary {
+enum class Boundary(val value: Int) {
     /**
      * Middle packet of a message
      */
-    SUBSEQUENT,
+    SUBSEQUENT(0),
 
     /**
      * Last packet of a message
      */
-    LAST,
+    LAST(1),
 
     /**
      * First packet of a message
      */
-    FIRST,
+    FIRST(2),
 
     /**
      * Solo message packet
      */
-    SOLO
+    SOLO(3);
+
+    companion object {
+        /**
+         * Converts a native `boundary` of `SRT_MSGCTRL` to a [Boundary].
+         *
+         * @param value the native value
+         * @return the [Boundary], [SUBSEQUENT] if [value] is unknown
+         */
+        fun fromValue(value: Int) = entries.firstOrNull { it.value == value } ?: SUBSEQUENT
+    }
 }
\ No newline at end of file
@@ -22,29 +22,47 @@ import io.github.thibaultbee.srtdroid.core.models.Epoll
  *
  * **See Also:** [srt_epoll_add_usock](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_epoll_add_usock)
  */
-enum class EpollOpt {
+enum class EpollOpt(val value: Int) {
     /**
      * Reports readiness for reading or incoming connection on a listener socket
      */
-    IN,
+    IN(0x1),
 
     /**
      * Report readiness for writing or a successful connection
      */
-    OUT,
+    OUT(0x4),
 
     /**
      * Report errors on the socket
      */
-    ERR,
+    ERR(0x8),
 
     /**
      * An important event has happened that requires attention
      */
-    UPDATE,
+    UPDATE(0x10),
 
     /**
      * The event will be edge-triggered
      */
-    ET
+    ET(Int.MIN_VALUE); // 1 shl 31
+
+    companion object {
+        /**
+         * Converts a list of [EpollOpt] to a native `SRT_EPOLL_OPT` mask.
+         *
+         * @param opts the list of [EpollOpt]
+         * @return the native mask
+         */
+        fun toMask(opts: List<EpollOpt>) = opts.fold(0) { mask, opt -> mask or opt.value }
+
+        /**
+         * Converts a native `SRT_EPOLL_OPT` mask to a list of [EpollOpt].
+         *
+         * @param mask the native mask
+         * @return the list of [EpollOpt]
+         */
+        fun fromMask(mask: Int) = entries.filter { (mask and it.value) != 0 }
+    }
 }
\ No newline at end of file
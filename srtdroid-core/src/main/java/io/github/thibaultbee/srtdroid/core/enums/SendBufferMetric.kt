@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.enums
+
+import io.github.thibaultbee.srtdroid.core.models.SrtSocket
+
+/**
+ * Units of the send buffer occupancy, see [SrtSocket.sendBufferLevel]
+ *
+ * **See Also:** [srt_getsndbuffer](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_getsndbuffer)
+ */
+enum class SendBufferMetric {
+    /**
+     * Time span of the buffered packets, in milliseconds
+     */
+    MS,
+
+    /**
+     * Number of buffered packets
+     */
+    PACKETS,
+
+    /**
+     * Number of buffered bytes
+     */
+    BYTES
+}
@@ -20,286 +20,288 @@ import io.github.thibaultbee.srtdroid.core.models.SrtSocket
 /**
  * Parameter or returned value of [SrtSocket.setSockFlag] and [SrtSocket.getSockFlag].
  *
+ * [value] is the native `SRT_SOCKOPT` value.
+ *
  * **See Also:** [API Socket Options](https://github.com/Haivision/srt/blob/master/docs/API/API-socket-options.md)
  */
-enum class SockOpt {
+enum class SockOpt(val value: Int) {
     /**
      * The Maximum Transfer Unit
      */
-    MSS,
+    MSS(0),
 
     /**
      * If sending is blocking
      */
-    SNDSYN,
+    SNDSYN(1),
 
     /**
      * If receiving is blocking
      */
-    RCVSYN,
+    RCVSYN(2),
 
     /**
      * Initial Sequence Number (valid only after srt_connect or srt_accept-ed sockets)
      */
-    ISN,
+    ISN(3),
 
     /**
      * Flight flag size (window size)
      */
-    FC,
+    FC(4),
 
     /**
      * Maximum buffer in sending queue
      */
-    SNDBUF,
+    SNDBUF(5),
 
     /**
      * UDT receiving buffer size
      */
-    RCVBUF,
+    RCVBUF(6),
 
     /**
      * Waiting for unsent data when closing
      */
-    LINGER,
+    LINGER(7),
 
     /**
      * UDP sending buffer size
      */
-    UDP_SNDBUF,
+    UDP_SNDBUF(8),
 
     /**
      * UDP receiving buffer size
      */
-    UDP_RCVBUF,
+    UDP_RCVBUF(9),
 
     /**
      * Rendezvous connection mode
      */
-    RENDEZVOUS,
+    RENDEZVOUS(12),
 
     /**
      * [SrtSocket.send] timeout
      */
-    SNDTIMEO,
+    SNDTIMEO(13),
 
     /**
      * [SrtSocket.recv] timeout
      */
-    RCVTIMEO,
+    RCVTIMEO(14),
 
     /**
      * Reuse an existing port or create a new one
      */
-    REUSEADDR,
+    REUSEADDR(15),
 
     /**
      * Maximum bandwidth (bytes per second) that the connection can use
      */
-    MAXBW,
+    MAXBW(16),
 
     /**
      * Current socket state, see UDTSTATUS, read only
      */
-    STATE,
+    STATE(17),
 
     /**
      * Current available events associated with the socket
      */
-    EVENT,
+    EVENT(18),
 
     /**
      * Size of data in the sending buffer
      */
-    SNDDATA,
+    SNDDATA(19),
 
     /**
      * Size of data available for recv
      */
-    RCVDATA,
+    RCVDATA(20),
 
     /**
      * Sender mode (independent of conn mode), for encryption, tsbpd handshake.
      */
-    SENDER,
+    SENDER(21),
 
     /**
      * Enable/Disable TsbPd. Enable -> Tx set origin timestamp, Rx deliver packet at origin time + delay
      */
-    TSBPDMODE,
+    TSBPDMODE(22),
 
     /**
      * NOT RECOMMENDED. SET: to both RCVLATENCY and PEERLATENCY. GET: same as RCVLATENCY.
      */
-    LATENCY,
+    LATENCY(23),
 
     /**
      * Estimated input stream rate.
      */
-    INPUTBW,
+    INPUTBW(24),
 
     /**
      * Minimum estimate of input stream rate.
      */
-    MININPUTBW,
+    MININPUTBW(38),
 
     /**
      * MaxBW ceiling based on % over input stream rate. Applies when UDT_MAXBW=0 (auto).
      */
-    OHEADBW,
+    OHEADBW(25),
 
     /**
      * Crypto PBKDF2 Passphrase size (0,10..64) 0:disable crypto
      */
-    PASSPHRASE,
+    PASSPHRASE(26),
 
     /**
      * Crypto key len in bytes {16,24,32} Default: 16 (128-bit)
      */
-    PBKEYLEN,
+    PBKEYLEN(27),
 
     /**
      * Key Material exchange status (UDT_SRTKmState)
      */
-    KMSTATE,
+    KMSTATE(28),
 
     /**
      * IP Time To Live (passthru for system sockopt IPPROTO_IP/IP_TTL)
      */
-    IPTTL,
+    IPTTL(29),
 
     /**
      * IP Type of Service (passthru for system sockopt IPPROTO_IP/IP_TOS)
      */
-    IPTOS,
+    IPTOS(30),
 
     /**
      * Enable receiver pkt drop
      */
-    TLPKTDROP,
+    TLPKTDROP(31),
 
     /**
      * Extra delay towards latency for sender TLPKTDROP decision (-1 to off)
      */
-    SNDDROPDELAY,
+    SNDDROPDELAY(32),
 
     /**
      * Enable receiver to send periodic NAK reports
      */
-    NAKREPORT,
+    NAKREPORT(33),
 
     /**
      * Local SRT Version
      */
-    VERSION,
+    VERSION(34),
 
     /**
      * Peer SRT Version (from SRT Handshake)
      */
-    PEERVERSION,
+    PEERVERSION(35),
 
     /**
      * Connect timeout in msec. Caller default: 3000, rendezvous (x 10)
      */
-    CONNTIMEO,
+    CONNTIMEO(36),
 
     /**
      * Enable or disable drift tracer
      */
-    DRIFTTRACER,
+    DRIFTTRACER(37),
 
     /**
      * (GET) the current state of the encryption at the peer side
      */
-    SNDKMSTATE,
+    SNDKMSTATE(40),
 
     /**
      * (GET) the current state of the encryption at the agent side
      */
-    RCVKMSTATE,
+    RCVKMSTATE(41),
 
     /**
      * Maximum possible packet reorder tolerance (number of packets to receive after loss to send lossreport)
      */
-    LOSSMAXTTL,
+    LOSSMAXTTL(42),
 
     /**
      * TsbPd receiver delay (mSec) to absorb burst of missed packet retransmission
      */
-    RCVLATENCY,
+    RCVLATENCY(43),
 
     /**
      * Minimum value of the TsbPd receiver delay (mSec) for the opposite side (peer)
      */
-    PEERLATENCY,
+    PEERLATENCY(44),
 
     /**
      * Minimum SRT version needed for the peer (peers with less version will get connection reject)
      */
-    MINVERSION,
+    MINVERSION(45),
 
     /**
      * A string set to a socket and passed to the listener's accepted socket
      */
-    STREAMID,
+    STREAMID(46),
 
     /**
      * Congestion controller type selection
      */
-    CONGESTION,
+    CONGESTION(47),
 
     /**
      * In File mode, use message API (portions of data with boundaries)
      */
-    MESSAGEAPI,
+    MESSAGEAPI(48),
 
     /**
      * Maximum payload size sent in one UDP packet (0 if unlimited)
      */
-    PAYLOADSIZE,
+    PAYLOADSIZE(49),
 
     /**
      * Transmission type (set of options required for given transmission type)
      */
-    TRANSTYPE,
+    TRANSTYPE(50),
 
     /**
      * After sending how many packets the encryption key should be flipped to the new key
      */
-    KMREFRESHRATE,
+    KMREFRESHRATE(51),
 
     /**
      * How many packets before key flip the new key is annnounced and after key flip the old one decommissioned
      */
-    KMPREANNOUNCE,
+    KMPREANNOUNCE(52),
 
     /**
      * Connection to be rejected or quickly broken when one side encryption set or bad password
      */
-    ENFORCEDENCRYPTION,
+    ENFORCEDENCRYPTION(53),
 
     /**
      * IPV6_V6ONLY mode
      */
-    IPV6ONLY,
+    IPV6ONLY(54),
 
     /**
      * Peer-idle timeout (max time of silence heard from peer) in ms
      */
-    PEERIDLETIMEO,
+    PEERIDLETIMEO(55),
 
     /**
      *  Forward the [BINDTODEVICE] option on socket (pass packets only from that device)
      */
-    BINDTODEVICE,
+    BINDTODEVICE(56),
 
     /**
      * Add and configure a packet filter
      */
-    PACKETFILTER,
+    PACKETFILTER(60),
 
     /**
      *  An option to select packet retransmission algorithm
      */
-    RETRANSMITALGO
+    RETRANSMITALGO(61)
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 package io.github.thibaultbee.srtdroid.core.interfaces
 
 import io.github.thibaultbee.srtdroid.core.enums.SockOpt
+import io.github.thibaultbee.srtdroid.core.models.SockOptions
 
 /**
  * A convenient interface to get and set socket options
@@ -8,4 +9,13 @@ import io.github.thibaultbee.srtdroid.core.enums.SockOpt
 interface ConfigurableSrtSocket {
     fun getSockFlag(opt: SockOpt): Any
     fun setSockFlag(opt: SockOpt, value: Any)
+
+    /**
+     * Sets a list of socket options, in order.
+     *
+     * @param options the [SockOptions] to set
+     */
+    fun applyOptions(options: SockOptions) {
+        options.options.forEach { (opt, value) -> setSockFlag(opt, value) }
+    }
 }
\ No newline at end of file
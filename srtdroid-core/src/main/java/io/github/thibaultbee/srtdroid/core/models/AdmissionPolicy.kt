@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import io.github.thibaultbee.srtdroid.core.enums.RejectReasonCode
+import io.github.thibaultbee.srtdroid.core.models.rejectreason.InternalRejectReason
+import io.github.thibaultbee.srtdroid.core.models.rejectreason.PredefinedRejectReason
+import io.github.thibaultbee.srtdroid.core.models.rejectreason.RejectReason
+import io.github.thibaultbee.srtdroid.core.models.rejectreason.UserDefinedRejectReason
+
+/**
+ * Admission policy of a listener [SrtSocket].
+ *
+ * It is evaluated natively for each incoming connection, before [SrtSocket.ServerListener.onListen].
+ * Rejected connections never reach the JVM: only accepted connections are passed to
+ * [SrtSocket.ServerListener.onListen].
+ *
+ * Rate limits are applied first, then [rules] are matched in order: the first matching [Rule]
+ * decides. If no rule matches, [defaultAction] applies.
+ *
+ * **See Also:** [SRT Access Control](https://github.com/Haivision/srt/blob/master/docs/features/access-control.md)
+ *
+ * @param rules the ordered list of [Rule]
+ * @param defaultAction the [Action] when no rule matches
+ * Reject reasons must be [PredefinedRejectReason] or [UserDefinedRejectReason]: SRT does not
+ * let an application set an [InternalRejectReason].
+ *
+ * @param rejectReason the reject reason of denied connections
+ * @param globalRateLimit maximum rate of incoming connections. Null for no limit.
+ * @param perAddressRateLimit maximum rate of incoming connections per peer IP address. Null for no limit.
+ * @param rateLimitRejectReason the reject reason of connections over a rate limit
+ */
+data class AdmissionPolicy(
+    val rules: List<Rule> = emptyList(),
+    val defaultAction: Action = Action.ALLOW,
+    val rejectReason: RejectReason = PredefinedRejectReason(FORBIDDEN),
+    val globalRateLimit: RateLimit? = null,
+    val perAddressRateLimit: RateLimit? = null,
+    val rateLimitRejectReason: RejectReason = PredefinedRejectReason(OVERLOAD)
+) {
+    init {
+        requireSettable(rejectReason, "rejectReason")
+        requireSettable(rateLimitRejectReason, "rateLimitRejectReason")
+        rules.forEach { rule -> rule.rejectReason?.let { requireSettable(it, "Rule.rejectReason") } }
+    }
+
+    companion object {
+        /**
+         * `SRT_REJX_FORBIDDEN` - 1000
+         */
+        private const val FORBIDDEN = 403
+
+        /**
+         * `SRT_REJX_OVERLOAD` - 1000
+         */
+        private const val OVERLOAD = 402
+
+        private fun requireSettable(rejectReason: RejectReason, name: String) {
+            require(rejectReason.nativeCode >= RejectReasonCode.PREDEFINED_OFFSET) {
+                "$name must be a PredefinedRejectReason or a UserDefinedRejectReason"
+            }
+        }
+    }
+
+    /**
+     * Decision of a [Rule].
+     */
+    enum class Action {
+        /**
+         * Passes the connection to [SrtSocket.ServerListener.onListen]
+         */
+        ALLOW,
+
+        /**
+         * Rejects the connection
+         */
+        DENY
+    }
+
+    /**
+     * A stream ID rule.
+     *
+     * A stream ID in the access control syntax (`#!::r=live/cam,m=publish,u=alice`) is parsed into
+     * keys. Any other stream ID is considered as a resource name (key `r`).
+     *
+     * @param action the [Action] when the rule matches
+     * @param pattern the expected value. If it ends with `*`, it matches any value that starts with the same prefix.
+     * @param key the access control key to match (`r`, `m`, `u`, `h`, `s` or `t`). Null to match the whole stream ID.
+     * @param rejectReason the reject reason when a [Action.DENY] rule matches. Null for [AdmissionPolicy.rejectReason].
+     */
+    data class Rule(
+        val action: Action,
+        val pattern: String,
+        val key: String? = null,
+        val rejectReason: RejectReason? = null
+    )
+
+    /**
+     * A token bucket rate limit.
+     *
+     * @param connectionsPerSecond the sustained rate of accepted connections
+     * @param burst the maximum number of connections accepted at once
+     */
+    data class RateLimit(val connectionsPerSecond: Double, val burst: Int) {
+        init {
+            require(connectionsPerSecond > 0) { "connectionsPerSecond must be positive" }
+            require(burst >= 1) { "burst must be at least 1" }
+        }
+    }
+}
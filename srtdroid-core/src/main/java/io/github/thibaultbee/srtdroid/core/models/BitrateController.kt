@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import android.util.Log
+import io.github.thibaultbee.srtdroid.core.Srt
+import io.github.thibaultbee.srtdroid.core.enums.SockOpt
+import java.io.Closeable
+import java.security.InvalidParameterException
+
+/**
+ * A native adaptive bitrate controller attached to a sender socket.
+ *
+ * A native thread samples the statistics of [socket] every [intervalInMs] (see [StatsSampler] for
+ * the sample fields), feeds them to the estimator described by [config] and calls [listener] when
+ * the target bitrate changes. Congestion is detected from losses and retransmissions, RTT increase,
+ * send buffer duration and send buffer exhaustion.
+ * Once it has been called, you must release Srt context with [Srt.cleanUp] when application leaves.
+ *
+ * @param socket the sender socket
+ * @param config the estimator configuration
+ * @param intervalInMs sampling interval in milliseconds
+ * @param maxBwOverheadPercent if positive, [SockOpt.MAXBW] is set to the target bitrate plus this percentage on each change. Otherwise, [SockOpt.MAXBW] is left untouched.
+ * @param listener the listener called on the controller thread
+ */
+class BitrateController(
+    val socket: SrtSocket,
+    val config: Config = Config(),
+    val intervalInMs: Int = DEFAULT_INTERVAL_IN_MS,
+    val maxBwOverheadPercent: Int = 0,
+    private val listener: Listener
+) : Closeable {
+    companion object {
+        private const val TAG = "BitrateController"
+
+        private const val DEFAULT_INTERVAL_IN_MS = 50
+
+        @JvmStatic
+        private external fun nativeRelease(ptr: Long)
+
+        @JvmStatic
+        private external fun nativeSimulate(
+            config: DoubleArray,
+            samples: LongArray,
+            nSamples: Int,
+            bitrates: LongArray
+        ): Int
+
+        /**
+         * Runs the estimator on recorded samples, without socket and without clock.
+         * The same samples always give the same bitrates.
+         *
+         * @param config the estimator configuration
+         * @param samples the samples in the [StatsSampler] layout, for example from [StatsSampler.History.values]
+         * @param nSamples the number of samples in [samples]
+         * @return the target bitrate after each sample, in bits per second
+         */
+        fun simulate(
+            config: Config,
+            samples: LongArray,
+            nSamples: Int = samples.size / StatsSampler.SAMPLE_SIZE
+        ): LongArray {
+            val bitrates = LongArray(nSamples)
+            require(nativeSimulate(config.toArray(), samples, nSamples, bitrates) >= 0) {
+                "samples must contain $nSamples samples"
+            }
+            return bitrates
+        }
+
+        init {
+            Srt.startUp()
+        }
+    }
+
+    /**
+     * Estimator modes.
+     */
+    enum class Mode {
+        /**
+         * Additive increase, multiplicative decrease on congestion
+         */
+        AIMD,
+
+        /**
+         * Same as [AIMD], bounded by [Config.bandwidthHeadroom] of [Stats.mbpsBandwidth]
+         */
+        BANDWIDTH
+    }
+
+    /**
+     * Estimator configuration. Bitrates are in bits per second.
+     *
+     * @param mode the estimator [Mode]
+     * @param minBitrate the minimum target bitrate
+     * @param maxBitrate the maximum target bitrate
+     * @param initialBitrate the target bitrate before the first sample
+     * @param additiveIncrease added to the target bitrate on each sample without congestion
+     * @param decreaseFactor multiplies the target bitrate on each sample with congestion
+     * @param maxLossPercent congestion when lost or retransmitted packets are above this percentage of sent packets
+     * @param maxRttIncreasePercent congestion when RTT is above the minimum RTT by more than this percentage
+     * @param maxSndBufMs congestion when the send buffer holds more than this duration in milliseconds
+     * @param bandwidthHeadroom fraction of the estimated bandwidth usable in [Mode.BANDWIDTH]
+     */
+    data class Config(
+        val mode: Mode = Mode.AIMD,
+        val minBitrate: Long = 300_000,
+        val maxBitrate: Long = 10_000_000,
+        val initialBitrate: Long = 2_000_000,
+        val additiveIncrease: Long = 50_000,
+        val decreaseFactor: Double = 0.75,
+        val maxLossPercent: Double = 2.0,
+        val maxRttIncreasePercent: Double = 50.0,
+        val maxSndBufMs: Int = 500,
+        val bandwidthHeadroom: Double = 0.8
+    ) {
+        init {
+            require(minBitrate in 1..maxBitrate) { "Invalid bitrate range" }
+            require(decreaseFactor > 0 && decreaseFactor < 1) { "decreaseFactor must be in ]0, 1[" }
+        }
+
+        /**
+         * Same order as native BitrateEstimator::Config.
+         */
+        internal fun toArray() = doubleArrayOf(
+            mode.ordinal.toDouble(),
+            minBitrate.toDouble(),
+            maxBitrate.toDouble(),
+            initialBitrate.toDouble(),
+            additiveIncrease.toDouble(),
+            decreaseFactor,
+            maxLossPercent,
+            maxRttIncreasePercent,
+            maxSndBufMs.toDouble(),
+            bandwidthHeadroom
+        )
+    }
+
+    /**
+     * Listener of target bitrate changes.
+     */
+    fun interface Listener {
+        /**
+         * Called on the controller thread when the target bitrate changes.
+         * It must not block as it delays the next samples.
+         *
+         * @param bitrate the new target bitrate in bits per second
+         */
+        fun onTargetBitrate(bitrate: Long)
+    }
+
+    private external fun nativeCreate(
+        srtsocket: Int,
+        config: DoubleArray,
+        intervalInMs: Int,
+        maxBwOverheadPercent: Int
+    ): Long
+
+    @Volatile
+    private var ptr = nativeCreate(socket.srtsocket, config.toArray(), intervalInMs, maxBwOverheadPercent)
+
+    init {
+        if (ptr == 0L) {
+            throw InvalidParameterException("Failed to create bitrate controller")
+        }
+    }
+
+    /**
+     * Tests if the [BitrateController] is running.
+     *
+     * @return true if [BitrateController] is running, otherwise false
+     */
+    val isValid: Boolean
+        get() = ptr != 0L
+
+    /**
+     * Called by the controller thread.
+     */
+    @Suppress("unused")
+    private fun onTargetBitrate(bitrate: Long) {
+        try {
+            listener.onTargetBitrate(bitrate)
+        } catch (t: Throwable) {
+            Log.e(TAG, "Listener failed", t)
+        }
+    }
+
+    /**
+     * Stops the controller thread.
+     * The socket is not closed and [SockOpt.MAXBW] is left to its last value.
+     */
+    override fun close() {
+        val ptr = this.ptr
+        if (ptr != 0L) {
+            this.ptr = 0L
+            nativeRelease(ptr)
+        }
+    }
+}
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import android.util.Log
+import io.github.thibaultbee.srtdroid.core.Srt
+import java.io.Closeable
+import java.net.InetSocketAddress
+import java.security.InvalidParameterException
+
+/**
+ * A native bridge between an SRT socket and a plain UDP or TCP socket.
+ *
+ * A native thread waits for both sockets with the same SRT epoll (the system socket is added with
+ * [srt_epoll_add_ssock](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_epoll_add_ssock))
+ * and forwards data in one [direction]. Data never goes through the JVM. Use two bridges for
+ * SRT to UDP and UDP to SRT on the same stream.
+ *
+ * Messages are split in [chunkSize] pieces: UDP datagrams for [Direction.SRT_TO_UDP] and SRT
+ * messages for [Direction.UDP_TO_SRT]. TCP is a stream so [Direction.SRT_TO_TCP] writes messages
+ * as they are.
+ * The bridge must be the only reader of [socket].
+ * Once it has been called, you must release Srt context with [Srt.cleanUp] when application leaves.
+ *
+ * @param socket the SRT socket
+ * @param direction the forwarding direction
+ * @param address the UDP or TCP destination, or the local address to bind to for [Direction.UDP_TO_SRT]
+ * @param chunkSize the maximum size of a UDP datagram or of an SRT message sent by the bridge
+ * @param pace if true, messages sent to the system socket keep the spacing of their source times: the first message is sent on reception and the next ones wait until the time elapsed since it matches their [MsgCtrl.srcTime] difference. Use it when messages are received in bursts.
+ * @param listener the listener called on the bridge thread
+ */
+class Bridge(
+    val socket: SrtSocket,
+    val direction: Direction,
+    address: InetSocketAddress,
+    val chunkSize: Int = DEFAULT_CHUNK_SIZE,
+    val pace: Boolean = false,
+    private val listener: Listener? = null
+) : Closeable {
+    companion object {
+        private const val TAG = "Bridge"
+
+        /**
+         * 7 MPEG-TS packets
+         */
+        private const val DEFAULT_CHUNK_SIZE = 1316
+
+        private const val COUNTER_COUNT = 5
+
+        @JvmStatic
+        private external fun nativeGetLocalPort(ptr: Long): Int
+
+        @JvmStatic
+        private external fun nativeGetCounters(ptr: Long, counters: LongArray)
+
+        @JvmStatic
+        private external fun nativeRelease(ptr: Long)
+
+        init {
+            Srt.startUp()
+        }
+    }
+
+    /**
+     * Forwarding directions.
+     */
+    enum class Direction {
+        /**
+         * Messages received on the SRT socket are sent as UDP datagrams to the address
+         */
+        SRT_TO_UDP,
+
+        /**
+         * UDP datagrams received on the address are sent on the SRT socket. Messages carry the
+         * datagram arrival time as [MsgCtrl.srcTime].
+         */
+        UDP_TO_SRT,
+
+        /**
+         * Messages received on the SRT socket are written to a TCP connection to the address
+         */
+        SRT_TO_TCP
+    }
+
+    /**
+     * Bridge thread counters.
+     *
+     * @param receivedPackets the number of messages or datagrams received
+     * @param receivedBytes the number of bytes received
+     * @param sentPackets the number of messages or datagrams sent
+     * @param sentBytes the number of bytes sent
+     * @param droppedPackets the number of messages or datagrams that have not been sent
+     */
+    data class Counters(
+        val receivedPackets: Long,
+        val receivedBytes: Long,
+        val sentPackets: Long,
+        val sentBytes: Long,
+        val droppedPackets: Long
+    )
+
+    /**
+     * Listener of the bridge thread.
+     */
+    fun interface Listener {
+        /**
+         * Called on the bridge thread when it stops on an error.
+         *
+         * @param bridge the [Bridge]
+         * @param reason the error description
+         */
+        fun onClosed(bridge: Bridge, reason: String)
+    }
+
+    private external fun nativeCreate(
+        srtsocket: Int,
+        direction: Int,
+        address: InetSocketAddress,
+        chunkSize: Int,
+        pace: Boolean
+    ): Long
+
+    private val handle = NativeHandle(
+        nativeCreate(socket.srtsocket, direction.ordinal, address, chunkSize, pace),
+        TAG
+    ) { nativeRelease(it) }
+
+    init {
+        if (!handle.isOpen) {
+            throw InvalidParameterException("Failed to create bridge")
+        }
+    }
+
+    /**
+     * Tests if the [Bridge] is running.
+     *
+     * @return true if [Bridge] is running, otherwise false
+     */
+    val isValid: Boolean
+        get() = handle.isOpen
+
+    /**
+     * Local port of the UDP or TCP socket. Useful to get the port chosen by the system when
+     * [Direction.UDP_TO_SRT] address port is 0.
+     */
+    val localPort: Int
+        get() = handle.use { ptr -> nativeGetLocalPort(ptr) }
+
+    /**
+     * Gets the bridge thread counters.
+     *
+     * @return the [Counters]
+     */
+    fun counters(): Counters {
+        val counters = LongArray(COUNTER_COUNT)
+        handle.useOrElse(Unit) { ptr -> nativeGetCounters(ptr, counters) }
+        return Counters(
+            receivedPackets = counters[0],
+            receivedBytes = counters[1],
+            sentPackets = counters[2],
+            sentBytes = counters[3],
+            droppedPackets = counters[4]
+        )
+    }
+
+    /**
+     * Called by the bridge thread.
+     */
+    @Suppress("unused")
+    private fun onClosed(reason: String) {
+        try {
+            listener?.onClosed(this, reason)
+        } catch (t: Throwable) {
+            Log.e(TAG, "Listener failed", t)
+        }
+    }
+
+    /**
+     * Stops the bridge thread and closes the UDP or TCP socket. The SRT socket is not closed.
+     *
+     * It is safe to call it concurrently with the other methods, from [Listener] and several
+     * times.
+     */
+    override fun close() {
+        handle.close()
+    }
+}
@@ -19,7 +19,10 @@ import android.util.Pair
 import io.github.thibaultbee.srtdroid.core.Srt
 import io.github.thibaultbee.srtdroid.core.enums.EpollFlag
 import io.github.thibaultbee.srtdroid.core.enums.EpollOpt
+import java.nio.ByteOrder
+import java.nio.IntBuffer
 import java.security.InvalidParameterException
+import java.util.concurrent.ConcurrentHashMap
 
 /**
  * This class is currently the only method for using multiple sockets in one thread with having the
@@ -34,6 +37,24 @@ private constructor(private val eid: Int) {
         @JvmStatic
         private external fun nativeCreate(): Int
 
+        @JvmStatic
+        private external fun nativeUWait(
+            eid: Int,
+            timeOut: Long,
+            events: IntBuffer,
+            offset: Int,
+            expectedEpollEventSize: Int
+        ): Int
+
+        @JvmStatic
+        private external fun nativeUWait(
+            eid: Int,
+            timeOut: Long,
+            events: IntArray,
+            offset: Int,
+            expectedEpollEventSize: Int
+        ): Int
+
         init {
             Srt.startUp()
         }
@@ -44,6 +65,18 @@ private constructor(private val eid: Int) {
      */
     constructor() : this(nativeCreate())
 
+    /**
+     * SRT sockets added to the container, by socket id. SRT does not expose the content of an epoll
+     * container. Closed sockets are removed by SRT but stay here until [removeUSock] or [clearUSock].
+     */
+    private val subscribedSockets = ConcurrentHashMap<Int, SrtSocket>()
+
+    /**
+     * The SRT sockets added to the container.
+     */
+    val sockets: Collection<SrtSocket>
+        get() = subscribedSockets.values
+
     private external fun nativeIsValid(): Boolean
 
     /**
@@ -75,6 +108,7 @@ private constructor(private val eid: Int) {
         if (nativeAddUSock(socket, events) != 0) {
             throw InvalidParameterException(SrtError.lastErrorMessage)
         }
+        subscribedSockets[socket.srtsocket] = socket
     }
 
     private external fun nativeUpdateUSock(
@@ -114,6 +148,7 @@ private constructor(private val eid: Int) {
         if (nativeRemoveUSock(socket) != 0) {
             throw InvalidParameterException(SrtError.lastErrorMessage)
         }
+        subscribedSockets.remove(socket.srtsocket)
     }
 
     private external fun nativeWait(
@@ -176,6 +211,52 @@ private constructor(private val eid: Int) {
         return epollEvents
     }
 
+    /**
+     * Blocks a call until any readiness state occurs in the epoll container.
+     *
+     * Contrary to [uWait] returning a list of [EpollEvent], nothing is allocated: ready sockets are
+     * written as (socket, events) pairs of ints into [events], with events as a mask of
+     * [EpollOpt.value]. Use [EpollOpt.fromMask] to get a list of [EpollOpt].
+     *
+     * **See Also:** [srt_epoll_uwait](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_epoll_uwait)
+     *
+     * @param timeout Timeout specified in milliseconds. Set to -1, if you want to block indefinitely
+     * @param events the array where (socket, events) pairs are written to. At most `events.size / 2` pairs are written.
+     * @return the number of pairs written into [events]
+     * @throws InvalidParameterException if [Epoll] is not valid
+     */
+    fun uWait(timeout: Long, events: IntArray): Int {
+        val res = nativeUWait(eid, timeout, events, 0, events.size / 2)
+        if (res < 0) {
+            throw InvalidParameterException(SrtError.lastErrorMessage)
+        }
+        return res
+    }
+
+    /**
+     * Blocks a call until any readiness state occurs in the epoll container.
+     *
+     * Same as [uWait] with an [IntArray] but SRT writes directly into [events].
+     *
+     * **See Also:** [srt_epoll_uwait](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_epoll_uwait)
+     *
+     * @param timeout Timeout specified in milliseconds. Set to -1, if you want to block indefinitely
+     * @param events the [IntBuffer] where (socket, events) pairs are written to. It must be a view of a [java.nio.ByteBuffer.allocateDirect] in native order. Pairs are written from [IntBuffer.position] to [IntBuffer.limit]. On return, [IntBuffer.position] is moved after the written pairs.
+     * @return the number of pairs written into [events]
+     * @throws InvalidParameterException if [Epoll] is not valid
+     */
+    fun uWait(timeout: Long, events: IntBuffer): Int {
+        require(events.isDirect) { "events must be a direct IntBuffer" }
+        require(events.order() == ByteOrder.nativeOrder()) { "events must be in native order" }
+
+        val res = nativeUWait(eid, timeout, events, events.position(), events.remaining() / 2)
+        if (res < 0) {
+            throw InvalidParameterException(SrtError.lastErrorMessage)
+        }
+        events.position(events.position() + 2 * res)
+        return res
+    }
+
     private external fun nativeClearUSock(): Int
 
     /**
@@ -189,6 +270,7 @@ private constructor(private val eid: Int) {
         if (nativeClearUSock() != 0) {
             throw InvalidParameterException(SrtError.lastErrorMessage)
         }
+        subscribedSockets.clear()
     }
 
     private external fun nativeSetFlags(events: List<EpollFlag>): List<EpollFlag>?
@@ -241,6 +323,7 @@ private constructor(private val eid: Int) {
         if (nativeRelease() != 0) {
             throw InvalidParameterException(SrtError.lastErrorMessage)
         }
+        subscribedSockets.clear()
     }
 
     override fun equals(other: Any?): Boolean {
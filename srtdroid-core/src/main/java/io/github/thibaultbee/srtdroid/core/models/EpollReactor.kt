@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import android.util.Log
+import io.github.thibaultbee.srtdroid.core.Srt
+import io.github.thibaultbee.srtdroid.core.enums.EpollOpt
+import java.io.Closeable
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.nio.IntBuffer
+import java.security.InvalidParameterException
+import java.util.concurrent.ConcurrentHashMap
+
+/**
+ * A long-lived native thread that waits for events on all its registered sockets and reports them
+ * to their [Listener].
+ *
+ * Contrary to [Epoll], a single thread serves any number of sockets: there is no need to create an
+ * epoll container and to block a thread per operation.
+ * Once it has been called, you must release Srt context with [Srt.cleanUp] when application leaves.
+ *
+ * **See Also:** [srt_epoll_uwait](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_epoll_uwait)
+ *
+ * @param maxEvents maximum number of events reported per wake up
+ * @param timeoutInMs wait timeout in milliseconds. It bounds the time needed by [close].
+ */
+class EpollReactor(
+    maxEvents: Int = DEFAULT_MAX_EVENTS,
+    timeoutInMs: Int = DEFAULT_TIMEOUT_IN_MS
+) : Closeable {
+    companion object {
+        private const val TAG = "EpollReactor"
+
+        private const val DEFAULT_MAX_EVENTS = 64
+        private const val DEFAULT_TIMEOUT_IN_MS = 100
+
+        @JvmStatic
+        private external fun nativeAdd(ptr: Long, srtsocket: Int, events: Int): Int
+
+        @JvmStatic
+        private external fun nativeUpdate(ptr: Long, srtsocket: Int, events: Int): Int
+
+        @JvmStatic
+        private external fun nativeRemove(ptr: Long, srtsocket: Int): Int
+
+        @JvmStatic
+        private external fun nativeRelease(ptr: Long)
+
+        init {
+            Srt.startUp()
+        }
+    }
+
+    /**
+     * Listener of socket events.
+     */
+    fun interface Listener {
+        /**
+         * Called on the reactor thread when a registered socket is ready.
+         * It must not block as it delays events of all the other sockets.
+         *
+         * @param socket the ready socket
+         * @param events mask of [EpollOpt.value]. Use [EpollOpt.fromMask] to get a list of [EpollOpt].
+         */
+        fun onEvents(socket: SrtSocket, events: Int)
+    }
+
+    private class Registration(val socket: SrtSocket, val listener: Listener)
+
+    /**
+     * (socket, events) pairs written by the reactor thread before each [onEvents] call.
+     */
+    private val events: IntBuffer =
+        ByteBuffer.allocateDirect(2 * maxEvents * Int.SIZE_BYTES).order(ByteOrder.nativeOrder())
+            .asIntBuffer()
+
+    private val registrations = ConcurrentHashMap<Int, Registration>()
+
+    /**
+     * Reason of the reactor thread failure, null while it is running.
+     */
+    @Volatile
+    private var failureReason: String? = null
+
+    private external fun nativeCreate(events: IntBuffer, maxEvents: Int, timeoutInMs: Int): Long
+
+    private val handle =
+        NativeHandle(nativeCreate(events, maxEvents, timeoutInMs), TAG) { nativeRelease(it) }
+
+    init {
+        if (!handle.isOpen) {
+            throw InvalidParameterException("Failed to create epoll reactor")
+        }
+    }
+
+    /**
+     * Tests if the [EpollReactor] is running.
+     * It is false once closed or once the reactor thread has failed.
+     *
+     * @return true if [EpollReactor] is running, otherwise false
+     */
+    val isValid: Boolean
+        get() = handle.isOpen && (failureReason == null)
+
+    /**
+     * @throws IllegalStateException if the reactor has failed
+     */
+    private fun checkRunning() {
+        failureReason?.let { throw IllegalStateException("EpollReactor has failed: $it") }
+    }
+
+    /**
+     * Adds a socket to the reactor.
+     *
+     * Add [EpollOpt.ET] to [events] for an edge-triggered registration: [listener] is then only
+     * called when the readiness state changes.
+     *
+     * **See Also:** [srt_epoll_add_usock](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_epoll_add_usock)
+     *
+     * @param socket the SRT socket to add
+     * @param events list of selected [EpollOpt]
+     * @param listener the listener called on the reactor thread
+     * @throws InvalidParameterException if the socket can't be added
+     * @throws IllegalStateException if the reactor is closed or has failed
+     */
+    fun add(socket: SrtSocket, events: List<EpollOpt>, listener: Listener) = handle.use { ptr ->
+        checkRunning()
+        registrations[socket.srtsocket] = Registration(socket, listener)
+        if (nativeAdd(ptr, socket.srtsocket, EpollOpt.toMask(events)) != 0) {
+            registrations.remove(socket.srtsocket)
+            throw InvalidParameterException(SrtError.lastErrorMessage)
+        }
+        if (failureReason != null) {
+            // Failed meanwhile: the registration might have been missed by onFailed
+            registrations.remove(socket.srtsocket)
+            nativeRemove(ptr, socket.srtsocket)
+            checkRunning()
+        }
+    }
+
+    /**
+     * Updates the events of a socket already added to the reactor.
+     * An empty [events] stops the events of the socket until its next update, without removing
+     * its listener.
+     *
+     * **See Also:** [srt_epoll_update_usock](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_epoll_update_usock)
+     *
+     * @param socket the SRT socket to update
+     * @param events list of selected [EpollOpt]
+     * @throws InvalidParameterException if the socket can't be updated
+     * @throws IllegalStateException if the reactor is closed or has failed
+     */
+    fun update(socket: SrtSocket, events: List<EpollOpt>) = handle.use { ptr ->
+        checkRunning()
+        if (nativeUpdate(ptr, socket.srtsocket, EpollOpt.toMask(events)) != 0) {
+            throw InvalidParameterException(SrtError.lastErrorMessage)
+        }
+    }
+
+    /**
+     * Removes a socket from the reactor.
+     * Its listener won't be called anymore once this method returns, except if this method is
+     * called from another listener of the same wake up.
+     *
+     * **See Also:** [srt_epoll_remove_usock](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_epoll_remove_usock)
+     *
+     * @param socket the SRT socket to remove
+     * @throws InvalidParameterException if the socket can't be removed
+     * @throws IllegalStateException if the reactor is closed
+     */
+    fun remove(socket: SrtSocket) = handle.use { ptr ->
+        registrations.remove(socket.srtsocket)
+        if (nativeRemove(ptr, socket.srtsocket) != 0) {
+            throw InvalidParameterException(SrtError.lastErrorMessage)
+        }
+    }
+
+    /**
+     * Called by the reactor thread.
+     *
+     * @param count number of (socket, events) pairs in [events]
+     */
+    @Suppress("unused")
+    private fun onEvents(count: Int) {
+        for (i in 0 until count) {
+            val registration = registrations[events.get(2 * i)] ?: continue
+            try {
+                registration.listener.onEvents(registration.socket, events.get(2 * i + 1))
+            } catch (t: Throwable) {
+                Log.e(TAG, "Listener failed", t)
+            }
+        }
+    }
+
+    /**
+     * Called by the reactor thread when it stops on a wait error. Every registered listener gets
+     * [EpollOpt.ERR] so that none waits forever.
+     *
+     * @param reason the error description
+     */
+    @Suppress("unused")
+    private fun onFailed(reason: String) {
+        failureReason = reason
+        Log.e(TAG, "Reactor failed: $reason")
+        // Taken after failureReason is set: a concurrent add is either in it or fails. A listener
+        // might close the reactor, which clears registrations.
+        for (registration in registrations.values.toList()) {
+            try {
+                registration.listener.onEvents(registration.socket, EpollOpt.ERR.value)
+            } catch (t: Throwable) {
+                Log.e(TAG, "Listener failed", t)
+            }
+        }
+    }
+
+    /**
+     * Stops the reactor thread and releases its epoll container.
+     * It can be called from a [Listener].
+     * Registered sockets are not closed.
+     * It is safe to call it concurrently with the other methods and several times.
+     */
+    override fun close() {
+        registrations.clear()
+        handle.close()
+    }
+}
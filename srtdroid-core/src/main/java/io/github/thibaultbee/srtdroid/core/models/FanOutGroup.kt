@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import android.util.Log
+import io.github.thibaultbee.srtdroid.core.Srt
+import io.github.thibaultbee.srtdroid.core.enums.ErrorType
+import io.github.thibaultbee.srtdroid.core.enums.SockOpt
+import java.io.Closeable
+import java.nio.ByteBuffer
+import java.util.concurrent.ConcurrentHashMap
+
+/**
+ * A group of sockets that receive the same messages.
+ *
+ * [send] pushes a message to every member with
+ * [srt_sendmsg2](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_sendmsg2)
+ * in a single native call. A member that fails to send drops the message without disturbing the
+ * others. A member whose connection is broken is evicted and reported to [listener].
+ *
+ * Members should be non-blocking ([SockOpt.SNDSYN] set to false): a blocking member with a full
+ * send buffer delays every other member.
+ * Once it has been called, you must release Srt context with [Srt.cleanUp] when application leaves.
+ *
+ * @param listener the listener called on the sender thread when a member is evicted
+ */
+class FanOutGroup(private val listener: Listener? = null) : Closeable {
+    companion object {
+        private const val TAG = "FanOutGroup"
+
+        private const val COUNTER_COUNT = 3
+
+        @JvmStatic
+        private external fun nativeCreate(): Long
+
+        @JvmStatic
+        private external fun nativeAdd(ptr: Long, srtsocket: Int): Boolean
+
+        @JvmStatic
+        private external fun nativeRemove(ptr: Long, srtsocket: Int): Boolean
+
+        @JvmStatic
+        private external fun nativeGetCounters(
+            ptr: Long,
+            srtsocket: Int,
+            counters: LongArray
+        ): Boolean
+
+        @JvmStatic
+        private external fun nativeRelease(ptr: Long)
+
+        init {
+            Srt.startUp()
+        }
+    }
+
+    /**
+     * Member counters.
+     *
+     * @param sentPackets the number of messages sent to the member
+     * @param sentBytes the number of bytes sent to the member
+     * @param droppedPackets the number of messages the member has failed to send
+     */
+    data class Counters(
+        val sentPackets: Long,
+        val sentBytes: Long,
+        val droppedPackets: Long
+    )
+
+    /**
+     * Listener of member evictions.
+     */
+    fun interface Listener {
+        /**
+         * Called on the thread that called [send] when a member is evicted. The socket is not
+         * closed.
+         *
+         * @param socket the evicted member
+         * @param error the error that has evicted the member
+         */
+        fun onEvicted(socket: SrtSocket, error: ErrorType)
+    }
+
+    private external fun nativeSend(
+        ptr: Long,
+        msg: ByteBuffer,
+        offset: Int,
+        size: Int,
+        msgCtrl: ByteBuffer?
+    ): Int
+
+    private external fun nativeSend(
+        ptr: Long,
+        msg: ByteArray,
+        offset: Int,
+        size: Int,
+        msgCtrl: ByteBuffer?
+    ): Int
+
+    private val handle = NativeHandle(nativeCreate(), TAG) { nativeRelease(it) }
+
+    private val members = ConcurrentHashMap<Int, SrtSocket>()
+
+    /**
+     * Tests if the [FanOutGroup] is valid.
+     *
+     * @return true if [FanOutGroup] is valid, otherwise false
+     */
+    val isValid: Boolean
+        get() = handle.isOpen
+
+    /**
+     * The current members.
+     */
+    val sockets: List<SrtSocket>
+        get() = members.values.toList()
+
+    /**
+     * Adds a member.
+     *
+     * @param socket the socket to add
+     * @return false if [socket] is already a member
+     */
+    fun add(socket: SrtSocket): Boolean = handle.use { ptr ->
+        // Known before it can be evicted
+        members[socket.srtsocket] = socket
+        nativeAdd(ptr, socket.srtsocket)
+    }
+
+    /**
+     * Removes a member. The socket is not closed.
+     *
+     * @param socket the socket to remove
+     * @return false if [socket] is not a member
+     */
+    fun remove(socket: SrtSocket): Boolean = handle.use { ptr ->
+        members.remove(socket.srtsocket)
+        nativeRemove(ptr, socket.srtsocket)
+    }
+
+    /**
+     * Sends a message to every member.
+     *
+     * @param msg the [ByteBuffer] to send. It must be allocate with [ByteBuffer.allocateDirect]. It sends ByteBuffer from [ByteBuffer.position] to [ByteBuffer.limit].
+     * @param msgCtrl the [MsgCtrl] that contains extra parameter. Its message number is not updated.
+     * @return the number of members that have accepted the message
+     */
+    fun send(msg: ByteBuffer, msgCtrl: MsgCtrl? = null): Int {
+        require(msg.isDirect) { "msg must be a direct ByteBuffer" }
+
+        return handle.use { ptr ->
+            nativeSend(ptr, msg, msg.position(), msg.remaining(), msgCtrl?.toNative())
+        }
+    }
+
+    /**
+     * Sends a message to every member. The message is copied once for all members.
+     *
+     * @param msg the [ByteArray] to send
+     * @param offset the offset of the [msg]
+     * @param size the size of the [msg] to send
+     * @param msgCtrl the [MsgCtrl] that contains extra parameter. Its message number is not updated.
+     * @return the number of members that have accepted the message
+     */
+    fun send(
+        msg: ByteArray,
+        offset: Int = 0,
+        size: Int = msg.size,
+        msgCtrl: MsgCtrl? = null
+    ): Int {
+        require((offset >= 0) && (size >= 0) && (offset <= msg.size - size)) {
+            "Message is out of msg"
+        }
+
+        return handle.use { ptr -> nativeSend(ptr, msg, offset, size, msgCtrl?.toNative()) }
+    }
+
+    /**
+     * Gets the counters of a member.
+     *
+     * @param socket the member
+     * @return the [Counters] or null if [socket] is not a member
+     */
+    fun counters(socket: SrtSocket): Counters? {
+        val counters = LongArray(COUNTER_COUNT)
+        val isMember = handle.useOrElse(false) { ptr ->
+            nativeGetCounters(ptr, socket.srtsocket, counters)
+        }
+        if (!isMember) {
+            return null
+        }
+        return Counters(
+            sentPackets = counters[0],
+            sentBytes = counters[1],
+            droppedPackets = counters[2]
+        )
+    }
+
+    /**
+     * Called by [send] for each evicted member.
+     */
+    @Suppress("unused")
+    private fun onEvicted(srtsocket: Int, error: ErrorType) {
+        val socket = members.remove(srtsocket) ?: return
+        try {
+            listener?.onEvicted(socket, error)
+        } catch (t: Throwable) {
+            Log.e(TAG, "Listener failed", t)
+        }
+    }
+
+    /**
+     * Releases the group. Members are not closed.
+     *
+     * It is safe to call it concurrently with the other methods, from [Listener.onEvicted] and
+     * several times. A running [send] completes before the group is released.
+     */
+    override fun close() {
+        members.clear()
+        handle.close()
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+/**
+ * A reusable batch of messages, sent with [SrtSocket.sendBatch] or received with
+ * [SrtSocket.recvBatch] in a single native call.
+ *
+ * Message `i` is [lengths]`[i]` bytes at [offsets]`[i]` of the batch data buffer.
+ *
+ * @param capacity the maximum number of messages
+ */
+class MsgBatch(val capacity: Int) {
+    init {
+        require(capacity > 0) { "capacity must be positive" }
+    }
+
+    /**
+     * Offsets of the messages in the data buffer
+     */
+    val offsets = IntArray(capacity)
+
+    /**
+     * Lengths of the messages
+     */
+    val lengths = IntArray(capacity)
+
+    /**
+     * Source times of the messages in microseconds (see [MsgCtrl.srcTime]). 0 means now.
+     */
+    val srcTimes = LongArray(capacity)
+
+    /**
+     * Message numbers, written by [SrtSocket.sendBatch]
+     */
+    val msgNos = IntArray(capacity)
+
+    /**
+     * Packet sequence numbers, written by [SrtSocket.recvBatch]
+     */
+    val pktSeqs = IntArray(capacity)
+
+    /**
+     * Number of messages in the batch
+     */
+    var size = 0
+        set(value) {
+            require(value in 0..capacity) { "size must be in [0, $capacity]" }
+            field = value
+        }
+
+    /**
+     * Adds a message.
+     *
+     * @param offset the offset of the message in the data buffer
+     * @param length the length of the message
+     * @param srcTime the source time in microseconds. 0 means now.
+     * @return false if the batch is full
+     */
+    fun add(offset: Int, length: Int, srcTime: Long = 0): Boolean {
+        if (size == capacity) {
+            return false
+        }
+        offsets[size] = offset
+        lengths[size] = length
+        srcTimes[size] = srcTime
+        size++
+        return true
+    }
+
+    /**
+     * Removes all messages.
+     */
+    fun clear() {
+        size = 0
+    }
+
+    /**
+     * Sums the lengths of the first messages.
+     *
+     * @param count the number of messages, for example the value returned by [SrtSocket.sendBatch]
+     * @return the number of bytes of the [count] first messages
+     */
+    fun bytes(count: Int = size): Long {
+        var bytes = 0L
+        for (i in 0 until count) {
+            bytes += lengths[i]
+        }
+        return bytes
+    }
+}
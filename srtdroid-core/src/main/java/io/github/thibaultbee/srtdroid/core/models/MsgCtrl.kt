@@ -16,40 +16,91 @@
 package io.github.thibaultbee.srtdroid.core.models
 
 import io.github.thibaultbee.srtdroid.core.enums.Boundary
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
 
 /**
  * This class represents extra parameters for [SrtSocket.send] and [SrtSocket.recv]
  *
+ * It owns the native `SRT_MSGCTRL` that is passed to SRT, so it can be reused from one call to
+ * another without allocation. As a consequence, a [MsgCtrl] must not be used by concurrent calls.
+ *
  * **See Also:** [srt_msgctrl](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_msgctrl)
  */
 data class MsgCtrl(
     /**
      * Reserved for future use. Should be 0.
      */
-    val flags: Int = 0,
+    var flags: Int = 0,
     /**
      * The time (in ms) to wait for a successful delivery. -1 means no time limitation.
      */
-    val ttl: Int = -1, // SRT_MSGTTL_INF
+    var ttl: Int = -1, // SRT_MSGTTL_INF
     /**
      * Required to be received in the order of sending.
      */
-    val inOrder: Boolean = false,
+    var inOrder: Boolean = false,
     /**
      * Reserved for future use. Should be [Boundary.SUBSEQUENT].
+     * Receiver: updated by [SrtSocket.recv].
      */
-    val boundary: Boundary = Boundary.SUBSEQUENT,
+    var boundary: Boundary = Boundary.SUBSEQUENT,
     /**
      * Receiver: specifies the time when the packet was intended to be delivered to the receiving application (in microseconds since SRT clock epoch).
      * Sender: specifies the application-provided timestamp to be associated with the packet.
      */
-    val srcTime: Long = 0,
+    var srcTime: Long = 0,
     /**
      * Receiver only: reports the sequence number for the packet carrying out the message being returned.
+     * Updated by [SrtSocket.recv].
      */
-    val pktSeq: Int = -1, // SRT_SEQNO_NONE
+    var pktSeq: Int = -1, // SRT_SEQNO_NONE
     /**
      * Message number that can be sent by both sender and receiver.
+     * Receiver: updated by [SrtSocket.recv].
+     */
+    var no: Int = -1 // SRT_MSGNO_NONE
+) {
+    /**
+     * Native `SRT_MSGCTRL`. Layout is checked against srt.h in MsgCtrl.h.
+     */
+    private val buffer = ByteBuffer.allocateDirect(BUFFER_SIZE).order(ByteOrder.nativeOrder())
+
+    /**
+     * Writes fields to the native `SRT_MSGCTRL`.
+     *
+     * @return the native `SRT_MSGCTRL`
      */
-    val no: Int = -1 // SRT_MSGNO_NONE
-)
\ No newline at end of file
+    internal fun toNative(): ByteBuffer {
+        buffer.putInt(FLAGS_OFFSET, flags)
+        buffer.putInt(TTL_OFFSET, ttl)
+        buffer.putInt(INORDER_OFFSET, if (inOrder) 1 else 0)
+        buffer.putInt(BOUNDARY_OFFSET, boundary.value)
+        buffer.putLong(SRCTIME_OFFSET, srcTime)
+        buffer.putInt(PKTSEQ_OFFSET, pktSeq)
+        buffer.putInt(MSGNO_OFFSET, no)
+        return buffer
+    }
+
+    /**
+     * Reads the fields SRT sets on receive from the native `SRT_MSGCTRL`.
+     */
+    internal fun fromNative() {
+        boundary = Boundary.fromValue(buffer.getInt(BOUNDARY_OFFSET))
+        srcTime = buffer.getLong(SRCTIME_OFFSET)
+        pktSeq = buffer.getInt(PKTSEQ_OFFSET)
+        no = buffer.getInt(MSGNO_OFFSET)
+    }
+
+    private companion object {
+        // Must match MsgCtrl.h
+        private const val BUFFER_SIZE = 48
+        private const val FLAGS_OFFSET = 0
+        private const val TTL_OFFSET = 4
+        private const val INORDER_OFFSET = 8
+        private const val BOUNDARY_OFFSET = 12
+        private const val SRCTIME_OFFSET = 16
+        private const val PKTSEQ_OFFSET = 24
+        private const val MSGNO_OFFSET = 28
+    }
+}
\ No newline at end of file
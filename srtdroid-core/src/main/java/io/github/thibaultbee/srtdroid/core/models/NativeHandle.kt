@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import java.util.concurrent.atomic.AtomicBoolean
+import java.util.concurrent.atomic.AtomicInteger
+
+/**
+ * A native object pointer shared by the methods of its Java owner.
+ *
+ * Native calls run inside [use]: they hold a reference on the native object, so a concurrent or
+ * a nested [close] never releases it under them. The native object is released exactly once, by
+ * the last reference: [close] drops the owner reference.
+ *
+ * @param ptr the native object pointer. 0 if the native object could not be created.
+ * @param name name of the owner, for error messages
+ * @param release releases the native object
+ */
+internal class NativeHandle(
+    private val ptr: Long,
+    val name: String,
+    private val release: (Long) -> Unit
+) {
+    private val isClosed = AtomicBoolean(ptr == 0L)
+
+    /**
+     * The owner reference plus one per running [use]. 0 once the native object is released.
+     */
+    private val references = AtomicInteger(if (ptr != 0L) 1 else 0)
+
+    /**
+     * @return true if [close] has not been called
+     */
+    val isOpen: Boolean
+        get() = !isClosed.get()
+
+    /**
+     * Gets a reference on the native object.
+     *
+     * @return the native object pointer or 0 if it is closed. A pointer must be given back with
+     * [unref].
+     */
+    fun ref(): Long {
+        while (!isClosed.get()) {
+            val count = references.get()
+            if (count == 0) {
+                break
+            }
+            if (references.compareAndSet(count, count + 1)) {
+                return ptr
+            }
+        }
+        return 0L
+    }
+
+    /**
+     * Gives back a reference. The last one releases the native object.
+     */
+    fun unref() {
+        if (references.decrementAndGet() == 0) {
+            release(ptr)
+        }
+    }
+
+    /**
+     * Runs [block] with a reference on the native object.
+     *
+     * @throws IllegalStateException if it is closed
+     */
+    inline fun <T> use(block: (Long) -> T): T {
+        val ptr = ref()
+        check(ptr != 0L) { "$name is closed" }
+        try {
+            return block(ptr)
+        } finally {
+            unref()
+        }
+    }
+
+    /**
+     * Runs [block] with a reference on the native object.
+     *
+     * @return the result of [block] or [closedValue] if it is closed
+     */
+    inline fun <T> useOrElse(closedValue: T, block: (Long) -> T): T {
+        val ptr = ref()
+        if (ptr == 0L) {
+            return closedValue
+        }
+        try {
+            return block(ptr)
+        } finally {
+            unref()
+        }
+    }
+
+    /**
+     * Drops the owner reference. Only the first call has an effect.
+     * The native object is released now or when the last running [use] returns.
+     */
+    fun close() {
+        if (isClosed.compareAndSet(false, true)) {
+            unref()
+        }
+    }
+}
@@ -0,0 +1,333 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import android.util.Log
+import io.github.thibaultbee.srtdroid.core.Srt
+import java.io.Closeable
+import java.net.SocketException
+import java.net.SocketTimeoutException
+import java.nio.ByteBuffer
+import java.security.InvalidParameterException
+
+/**
+ * A native receive pipeline for a receiver socket.
+ *
+ * A native thread receives the messages of [socket] with
+ * [srt_recvmsg2](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_recvmsg2)
+ * into a lock-free ring that lives in a direct [ByteBuffer]. [poll] reads the ring without JNI
+ * call. The native thread only calls Java when the ring goes from empty to non-empty after a
+ * [poll] has found it empty, and when it stops on an error. When the ring is full, the native
+ * thread stops reading and messages stay in the SRT receive buffer.
+ *
+ * The ring must be the only reader of [socket]. [poll] and [take] must not be called
+ * concurrently, nor concurrently with [close]: the ring has a single consumer.
+ * Once it has been called, you must release Srt context with [Srt.cleanUp] when application leaves.
+ *
+ * @param socket the receiver socket
+ * @param capacity the number of messages the ring can hold. It must be a power of 2.
+ * @param maxPayloadSize the maximum size of a message
+ * @param listener the listener called on the native thread when messages are available
+ */
+class RecvRing(
+    val socket: SrtSocket,
+    val capacity: Int = DEFAULT_CAPACITY,
+    val maxPayloadSize: Int = DEFAULT_MAX_PAYLOAD_SIZE,
+    private val listener: Listener? = null
+) : Closeable {
+    companion object {
+        private const val TAG = "RecvRing"
+
+        private const val DEFAULT_CAPACITY = 1024
+
+        /**
+         * Maximum payload size of a live mode packet
+         */
+        private const val DEFAULT_MAX_PAYLOAD_SIZE = 1456
+
+        private const val COUNTER_COUNT = 3
+
+        @JvmStatic
+        private external fun nativeGetCounters(ptr: Long, counters: LongArray)
+
+        @JvmStatic
+        private external fun nativeRelease(ptr: Long)
+
+        init {
+            Srt.startUp()
+        }
+    }
+
+    /**
+     * Pump thread counters.
+     *
+     * @param receivedPackets the number of messages received
+     * @param receivedBytes the number of bytes received
+     * @param fullEvents the number of times the ring has been full
+     */
+    data class Counters(
+        val receivedPackets: Long,
+        val receivedBytes: Long,
+        val fullEvents: Long
+    )
+
+    /**
+     * Listener of message availability.
+     */
+    fun interface Listener {
+        /**
+         * Called on the native thread when messages are available after [poll] has found the ring
+         * empty, or when the native thread has stopped on an error.
+         * It must not block as it delays the reception.
+         *
+         * @param ring the [RecvRing]
+         */
+        fun onAvailable(ring: RecvRing)
+    }
+
+    private val ring = SpscRing(capacity, maxPayloadSize)
+
+    /**
+     * Consumer index. Only the consumer writes the ring tail.
+     */
+    private var tail = 0
+
+    private val lock = Object()
+
+    @Volatile
+    private var closeReason: String? = null
+
+    private external fun nativeCreate(
+        srtsocket: Int,
+        buffer: ByteBuffer,
+        capacity: Int,
+        slotSize: Int
+    ): Long
+
+    private val handle = NativeHandle(
+        nativeCreate(socket.srtsocket, ring.buffer, capacity, ring.slotSize),
+        TAG
+    ) { nativeRelease(it) }
+
+    init {
+        if (!handle.isOpen) {
+            throw InvalidParameterException("Failed to create receive ring")
+        }
+    }
+
+    /**
+     * Tests if the [RecvRing] is running.
+     *
+     * @return true if [RecvRing] is running, otherwise false
+     */
+    val isValid: Boolean
+        get() = handle.isOpen
+
+    /**
+     * Number of messages in the ring, waiting to be read.
+     */
+    val size: Int
+        get() = ring.head - tail
+
+    /**
+     * Reads a message from the ring, without waiting.
+     *
+     * @param buffer the [ByteBuffer] where the message is written to. On return, [ByteBuffer.position] is moved after the message.
+     * @param msgCtrl if not null, its [MsgCtrl.srcTime], [MsgCtrl.pktSeq] and [MsgCtrl.no] are updated
+     * @return the size of the message, 0 if the ring is empty
+     * @throws SocketException if the ring is empty and the native thread has stopped on an error
+     * @throws IllegalArgumentException if [buffer] is too small for the message. The message is not consumed.
+     */
+    fun poll(buffer: ByteBuffer, msgCtrl: MsgCtrl? = null): Int {
+        if (!isAvailable()) {
+            return 0
+        }
+
+        val offset = ring.slotOffset(tail)
+        val length = ring.buffer.getInt(offset + SpscRing.SLOT_LENGTH_OFFSET)
+        require(buffer.remaining() >= length) { "buffer must have $length bytes remaining" }
+        if (msgCtrl != null) {
+            msgCtrl.srcTime = ring.buffer.getLong(offset + SpscRing.SLOT_SRCTIME_OFFSET)
+            msgCtrl.pktSeq = ring.buffer.getInt(offset + SpscRing.SLOT_PKTSEQ_OFFSET)
+            msgCtrl.no = ring.buffer.getInt(offset + SpscRing.SLOT_MSGNO_OFFSET)
+        }
+        copy(offset, length, buffer)
+        release(1)
+        return length
+    }
+
+    /**
+     * Reads messages from the ring, without waiting. Messages are written back to back in
+     * [buffer] until [batch] is full or [buffer] has no room for the next message.
+     *
+     * On return, [MsgBatch.offsets] are the offsets of the messages from the start of [buffer].
+     *
+     * @param buffer the [ByteBuffer] where the messages are written to. On return, [ByteBuffer.position] is moved after the messages.
+     * @param batch where the messages are described. Its previous content is replaced.
+     * @return the number of messages, 0 if the ring is empty
+     * @throws SocketException if the ring is empty and the native thread has stopped on an error
+     */
+    fun poll(buffer: ByteBuffer, batch: MsgBatch): Int {
+        batch.clear()
+        if (!isAvailable()) {
+            return 0
+        }
+
+        val head = ring.head
+        var count = 0
+        while ((count < batch.capacity) && (tail + count != head)) {
+            val offset = ring.slotOffset(tail + count)
+            val length = ring.buffer.getInt(offset + SpscRing.SLOT_LENGTH_OFFSET)
+            if (buffer.remaining() < length) {
+                break
+            }
+            batch.offsets[count] = buffer.position()
+            batch.lengths[count] = length
+            batch.srcTimes[count] = ring.buffer.getLong(offset + SpscRing.SLOT_SRCTIME_OFFSET)
+            batch.pktSeqs[count] = ring.buffer.getInt(offset + SpscRing.SLOT_PKTSEQ_OFFSET)
+            batch.msgNos[count] = ring.buffer.getInt(offset + SpscRing.SLOT_MSGNO_OFFSET)
+            copy(offset, length, buffer)
+            count++
+        }
+        batch.size = count
+        release(count)
+        return count
+    }
+
+    /**
+     * Reads a message from the ring, waiting for one if the ring is empty.
+     *
+     * @param buffer the [ByteBuffer] where the message is written to. On return, [ByteBuffer.position] is moved after the message.
+     * @param msgCtrl if not null, its [MsgCtrl.srcTime], [MsgCtrl.pktSeq] and [MsgCtrl.no] are updated
+     * @param timeoutInMs the maximum time to wait. -1 means no time limitation.
+     * @return the size of the message
+     * @throws SocketException if the ring is empty and the native thread has stopped on an error
+     * @throws SocketTimeoutException if no message has been received before [timeoutInMs]
+     */
+    fun take(buffer: ByteBuffer, msgCtrl: MsgCtrl? = null, timeoutInMs: Long = -1): Int {
+        val deadline = System.currentTimeMillis() + timeoutInMs
+        while (true) {
+            val length = poll(buffer, msgCtrl)
+            if (length > 0) {
+                return length
+            }
+
+            synchronized(lock) {
+                // The native thread publishes before it notifies under this lock
+                if ((ring.head == tail) && (closeReason == null)) {
+                    if (timeoutInMs < 0) {
+                        lock.wait()
+                    } else {
+                        val remaining = deadline - System.currentTimeMillis()
+                        if (remaining <= 0) {
+                            throw SocketTimeoutException("No message after $timeoutInMs ms")
+                        }
+                        lock.wait(remaining)
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Gets the pump thread counters.
+     *
+     * @return the [Counters]. All counters are 0 once closed.
+     */
+    fun counters(): Counters {
+        val counters = LongArray(COUNTER_COUNT)
+        handle.useOrElse(Unit) { ptr -> nativeGetCounters(ptr, counters) }
+        return Counters(
+            receivedPackets = counters[0],
+            receivedBytes = counters[1],
+            fullEvents = counters[2]
+        )
+    }
+
+    /**
+     * @return true if a message is available. Otherwise, the native thread is asked to call
+     * [onAvailable] on the next message.
+     */
+    private fun isAvailable(): Boolean {
+        check(isValid) { "Receive ring is closed" }
+        if (ring.head == tail) {
+            ring.isWaiting = true
+            // Waiting state must be visible before the head is read again
+            ring.fullFence()
+            if (ring.head == tail) {
+                // The native thread publishes all its messages before it sets the reason
+                val reason = closeReason
+                if ((reason != null) && (ring.head == tail)) {
+                    throw SocketException(reason)
+                }
+                return false
+            }
+            ring.isWaiting = false
+        }
+        // Slots must be read after the head
+        ring.fullFence()
+        return true
+    }
+
+    private fun copy(offset: Int, length: Int, buffer: ByteBuffer) {
+        val payloadOffset = offset + SpscRing.SLOT_PAYLOAD_OFFSET
+        ring.payloads.limit(payloadOffset + length)
+        ring.payloads.position(payloadOffset)
+        buffer.put(ring.payloads)
+        ring.payloads.limit(ring.payloads.capacity())
+    }
+
+    private fun release(count: Int) {
+        // Slots must be read before they are released to the native thread
+        ring.fullFence()
+        tail += count
+        ring.tail = tail
+    }
+
+    /**
+     * Called by the pump thread.
+     */
+    @Suppress("unused")
+    private fun onAvailable() {
+        synchronized(lock) {
+            lock.notifyAll()
+        }
+        try {
+            listener?.onAvailable(this)
+        } catch (t: Throwable) {
+            Log.e(TAG, "Listener failed", t)
+        }
+    }
+
+    /**
+     * Called by the pump thread when it stops on an error.
+     */
+    @Suppress("unused")
+    private fun onClosed(reason: String) {
+        closeReason = reason
+        onAvailable()
+    }
+
+    /**
+     * Stops the pump thread. Messages in the ring are discarded.
+     * The socket is not closed.
+     *
+     * It is safe to call it concurrently with [counters] and several times.
+     */
+    override fun close() {
+        handle.close()
+    }
+}
@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import android.util.Log
+import io.github.thibaultbee.srtdroid.core.Srt
+import io.github.thibaultbee.srtdroid.core.enums.ErrorType
+import io.github.thibaultbee.srtdroid.core.enums.SockOpt
+import java.io.Closeable
+import java.security.InvalidParameterException
+import java.util.concurrent.ConcurrentHashMap
+
+/**
+ * A native SRT to SRT relay.
+ *
+ * A native thread receives the messages of [input] with
+ * [srt_recvmsg2](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_recvmsg2)
+ * and sends them to every output with
+ * [srt_sendmsg2](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_sendmsg2).
+ * Messages keep their source time, so the input timing is carried to the outputs. Data never
+ * goes through the JVM.
+ *
+ * Outputs behave as a [FanOutGroup]: they should be non-blocking ([SockOpt.SNDSYN] set to false),
+ * a failure only drops a message and a broken output is evicted.
+ * The relay must be the only reader of [input].
+ * Once it has been called, you must release Srt context with [Srt.cleanUp] when application leaves.
+ *
+ * @param input the socket to receive from
+ * @param outputs the initial outputs
+ * @param maxPayloadSize the maximum size of a message
+ * @param listener the listener called on the relay thread
+ */
+class Relay(
+    val input: SrtSocket,
+    outputs: List<SrtSocket> = emptyList(),
+    val maxPayloadSize: Int = DEFAULT_MAX_PAYLOAD_SIZE,
+    private val listener: Listener? = null
+) : Closeable {
+    companion object {
+        private const val TAG = "Relay"
+
+        /**
+         * Maximum payload size of a live mode packet
+         */
+        private const val DEFAULT_MAX_PAYLOAD_SIZE = 1456
+
+        private const val COUNTER_COUNT = 6
+
+        @JvmStatic
+        private external fun nativeAddOutput(ptr: Long, srtsocket: Int): Boolean
+
+        @JvmStatic
+        private external fun nativeRemoveOutput(ptr: Long, srtsocket: Int): Boolean
+
+        @JvmStatic
+        private external fun nativeGetCounters(ptr: Long, counters: LongArray)
+
+        @JvmStatic
+        private external fun nativeGetOutputCounters(
+            ptr: Long,
+            srtsocket: Int,
+            counters: LongArray
+        ): Boolean
+
+        @JvmStatic
+        private external fun nativeRelease(ptr: Long)
+
+        init {
+            Srt.startUp()
+        }
+    }
+
+    /**
+     * Relay counters.
+     *
+     * @param receivedPackets the number of messages received from the input
+     * @param receivedBytes the number of bytes received from the input
+     * @param sentPackets the number of messages accepted by the outputs, summed over outputs
+     * @param droppedPackets the number of messages the outputs have failed to send, summed over outputs
+     * @param meanLatencyInUs the mean time added by the relay between the reception and the end of the sends, in microseconds
+     * @param maxLatencyInUs the maximum time added by the relay, in microseconds
+     */
+    data class Counters(
+        val receivedPackets: Long,
+        val receivedBytes: Long,
+        val sentPackets: Long,
+        val droppedPackets: Long,
+        val meanLatencyInUs: Long,
+        val maxLatencyInUs: Long
+    )
+
+    /**
+     * Listener of relay events.
+     */
+    interface Listener {
+        /**
+         * Called on the relay thread when an output is evicted. The socket is not closed.
+         *
+         * @param socket the evicted output
+         * @param error the error that has evicted the output
+         */
+        fun onOutputEvicted(socket: SrtSocket, error: ErrorType) {}
+
+        /**
+         * Called on the relay thread when the input fails. The relay has stopped forwarding.
+         *
+         * @param error the input error
+         */
+        fun onInputClosed(error: ErrorType) {}
+    }
+
+    private external fun nativeCreate(input: Int, maxPayloadSize: Int): Long
+
+    private val outputSockets = ConcurrentHashMap<Int, SrtSocket>()
+
+    private val handle =
+        NativeHandle(nativeCreate(input.srtsocket, maxPayloadSize), TAG) { nativeRelease(it) }
+
+    init {
+        if (!handle.isOpen) {
+            throw InvalidParameterException("Failed to create relay")
+        }
+        outputs.forEach { addOutput(it) }
+    }
+
+    /**
+     * Tests if the [Relay] is running.
+     *
+     * @return true if [Relay] is running, otherwise false
+     */
+    val isValid: Boolean
+        get() = handle.isOpen
+
+    /**
+     * The current outputs.
+     */
+    val sockets: List<SrtSocket>
+        get() = outputSockets.values.toList()
+
+    /**
+     * Adds an output.
+     *
+     * @param socket the socket to add
+     * @return false if [socket] is already an output
+     */
+    fun addOutput(socket: SrtSocket): Boolean = handle.use { ptr ->
+        // Known before it can be evicted
+        outputSockets[socket.srtsocket] = socket
+        nativeAddOutput(ptr, socket.srtsocket)
+    }
+
+    /**
+     * Removes an output. The socket is not closed.
+     *
+     * @param socket the socket to remove
+     * @return false if [socket] is not an output
+     */
+    fun removeOutput(socket: SrtSocket): Boolean = handle.use { ptr ->
+        outputSockets.remove(socket.srtsocket)
+        nativeRemoveOutput(ptr, socket.srtsocket)
+    }
+
+    /**
+     * Gets the relay counters.
+     *
+     * @return the [Counters]. All counters are 0 once closed.
+     */
+    fun counters(): Counters {
+        val counters = LongArray(COUNTER_COUNT)
+        handle.useOrElse(Unit) { ptr -> nativeGetCounters(ptr, counters) }
+        return Counters(
+            receivedPackets = counters[0],
+            receivedBytes = counters[1],
+            sentPackets = counters[2],
+            droppedPackets = counters[3],
+            meanLatencyInUs = if (counters[0] > 0) counters[4] / counters[0] else 0,
+            maxLatencyInUs = counters[5]
+        )
+    }
+
+    /**
+     * Gets the counters of an output.
+     *
+     * @param socket the output
+     * @return the [FanOutGroup.Counters] or null if [socket] is not an output
+     */
+    fun counters(socket: SrtSocket): FanOutGroup.Counters? {
+        val counters = LongArray(COUNTER_COUNT)
+        val isOutput = handle.useOrElse(false) { ptr ->
+            nativeGetOutputCounters(ptr, socket.srtsocket, counters)
+        }
+        if (!isOutput) {
+            return null
+        }
+        return FanOutGroup.Counters(
+            sentPackets = counters[0],
+            sentBytes = counters[1],
+            droppedPackets = counters[2]
+        )
+    }
+
+    /**
+     * Called by the relay thread.
+     */
+    @Suppress("unused")
+    private fun onOutputEvicted(srtsocket: Int, error: ErrorType) {
+        val socket = outputSockets.remove(srtsocket) ?: return
+        try {
+            listener?.onOutputEvicted(socket, error)
+        } catch (t: Throwable) {
+            Log.e(TAG, "Listener failed", t)
+        }
+    }
+
+    /**
+     * Called by the relay thread.
+     */
+    @Suppress("unused")
+    private fun onInputClosed(error: ErrorType) {
+        try {
+            listener?.onInputClosed(error)
+        } catch (t: Throwable) {
+            Log.e(TAG, "Listener failed", t)
+        }
+    }
+
+    /**
+     * Stops the relay thread. Input and outputs are not closed.
+     *
+     * It is safe to call it concurrently with the other methods, from [Listener] and several
+     * times.
+     */
+    override fun close() {
+        outputSockets.clear()
+        handle.close()
+    }
+}
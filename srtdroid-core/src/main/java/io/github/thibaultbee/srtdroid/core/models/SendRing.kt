@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import io.github.thibaultbee.srtdroid.core.Srt
+import java.io.Closeable
+import java.nio.ByteBuffer
+import java.security.InvalidParameterException
+
+/**
+ * A native send pipeline for a sender socket.
+ *
+ * Messages are copied to a lock-free ring that lives in a direct [ByteBuffer]. A native thread
+ * drains the ring with [srt_sendmsg2](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_sendmsg2),
+ * so the producer never blocks in SRT and does not cross JNI for each message. JNI is only used to
+ * wake up the drain thread when it waits for messages.
+ *
+ * [offer] must not be called concurrently: the ring has a single producer.
+ * Once it has been called, you must release Srt context with [Srt.cleanUp] when application leaves.
+ *
+ * @param socket the sender socket
+ * @param capacity the number of messages the ring can hold. It must be a power of 2.
+ * @param maxPayloadSize the maximum size of a message
+ */
+class SendRing(
+    val socket: SrtSocket,
+    val capacity: Int = DEFAULT_CAPACITY,
+    val maxPayloadSize: Int = DEFAULT_MAX_PAYLOAD_SIZE
+) : Closeable {
+    companion object {
+        private const val TAG = "SendRing"
+
+        private const val DEFAULT_CAPACITY = 1024
+
+        /**
+         * Maximum payload size of a live mode packet
+         */
+        private const val DEFAULT_MAX_PAYLOAD_SIZE = 1456
+
+        private const val COUNTER_COUNT = 5
+
+        @JvmStatic
+        private external fun nativeWake(ptr: Long)
+
+        @JvmStatic
+        private external fun nativeGetCounters(ptr: Long, counters: LongArray)
+
+        @JvmStatic
+        private external fun nativeRelease(ptr: Long)
+
+        init {
+            Srt.startUp()
+        }
+    }
+
+    /**
+     * Drain thread counters.
+     *
+     * @param sentPackets the number of messages sent
+     * @param sentBytes the number of bytes sent
+     * @param sendFailures the number of messages [srt_sendmsg2](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_sendmsg2) has failed to send. They are dropped.
+     * @param meanDrainLatencyInUs the mean time between [offer] and the end of the send, in microseconds
+     * @param maxDrainLatencyInUs the maximum time between [offer] and the end of the send, in microseconds
+     */
+    data class Counters(
+        val sentPackets: Long,
+        val sentBytes: Long,
+        val sendFailures: Long,
+        val meanDrainLatencyInUs: Long,
+        val maxDrainLatencyInUs: Long
+    )
+
+    private val ring = SpscRing(capacity, maxPayloadSize)
+
+    /**
+     * Producer index. Only the producer writes the ring head.
+     */
+    private var head = 0
+
+    private external fun nativeCreate(
+        srtsocket: Int,
+        buffer: ByteBuffer,
+        capacity: Int,
+        slotSize: Int
+    ): Long
+
+    private val handle = NativeHandle(
+        nativeCreate(socket.srtsocket, ring.buffer, capacity, ring.slotSize),
+        TAG
+    ) { nativeRelease(it) }
+
+    init {
+        if (!handle.isOpen) {
+            throw InvalidParameterException("Failed to create send ring")
+        }
+    }
+
+    /**
+     * Tests if the [SendRing] is running.
+     *
+     * @return true if [SendRing] is running, otherwise false
+     */
+    val isValid: Boolean
+        get() = handle.isOpen
+
+    /**
+     * Number of messages in the ring, waiting to be sent.
+     */
+    val size: Int
+        get() = head - ring.tail
+
+    /**
+     * Number of messages [offer] has dropped because the ring was full.
+     */
+    @Volatile
+    var droppedPackets = 0L
+        private set
+
+    /**
+     * Copies a message to the ring.
+     *
+     * @param msg the [ByteBuffer] to send, from [ByteBuffer.position] to [ByteBuffer.limit]. On success, [ByteBuffer.position] is moved to [ByteBuffer.limit].
+     * @param srcTime the source time in microseconds (see [MsgCtrl.srcTime]). 0 means the time of the call.
+     * @param ttl the time (in ms) to wait for a successful delivery. -1 means no time limitation.
+     * @return true if the message has been queued, false if the ring is full
+     */
+    fun offer(msg: ByteBuffer, srcTime: Long = 0, ttl: Int = -1): Boolean {
+        val length = msg.remaining()
+        val offset = reserve(length) ?: return false
+
+        ring.payloads.position(offset + SpscRing.SLOT_PAYLOAD_OFFSET)
+        ring.payloads.put(msg)
+        publish(offset, length, srcTime, ttl)
+        return true
+    }
+
+    /**
+     * Copies a message to the ring.
+     *
+     * @param msg the [ByteArray] to send
+     * @param offset the offset of the [msg]
+     * @param size the size of the [msg] to send
+     * @param srcTime the source time in microseconds (see [MsgCtrl.srcTime]). 0 means the time of the call.
+     * @param ttl the time (in ms) to wait for a successful delivery. -1 means no time limitation.
+     * @return true if the message has been queued, false if the ring is full
+     */
+    fun offer(
+        msg: ByteArray,
+        offset: Int = 0,
+        size: Int = msg.size,
+        srcTime: Long = 0,
+        ttl: Int = -1
+    ): Boolean {
+        val slotOffset = reserve(size) ?: return false
+
+        ring.payloads.position(slotOffset + SpscRing.SLOT_PAYLOAD_OFFSET)
+        ring.payloads.put(msg, offset, size)
+        publish(slotOffset, size, srcTime, ttl)
+        return true
+    }
+
+    /**
+     * @return the offset of the next slot or null if the ring is full
+     */
+    private fun reserve(length: Int): Int? {
+        check(isValid) { "Send ring is closed" }
+        require(length in 1..maxPayloadSize) { "Message size must be in [1, $maxPayloadSize]" }
+        if (head - ring.tail >= capacity) {
+            droppedPackets++
+            return null
+        }
+        return ring.slotOffset(head)
+    }
+
+    private fun publish(offset: Int, length: Int, srcTime: Long, ttl: Int) {
+        val buffer = ring.buffer
+        buffer.putInt(offset + SpscRing.SLOT_LENGTH_OFFSET, length)
+        buffer.putInt(offset + SpscRing.SLOT_TTL_OFFSET, ttl)
+        buffer.putLong(offset + SpscRing.SLOT_SRCTIME_OFFSET, srcTime)
+        buffer.putLong(offset + SpscRing.SLOT_TIME_OFFSET, SpscRing.now())
+
+        // Slot must be visible before the head
+        ring.fullFence()
+        head++
+        ring.head = head
+        // Head must be visible before the drain thread state is read
+        ring.fullFence()
+        if (ring.isWaiting) {
+            handle.useOrElse(Unit) { ptr -> nativeWake(ptr) }
+        }
+    }
+
+    /**
+     * Gets the drain thread counters.
+     *
+     * @return the [Counters]. All counters are 0 once closed.
+     */
+    fun counters(): Counters {
+        val counters = LongArray(COUNTER_COUNT)
+        handle.useOrElse(Unit) { ptr -> nativeGetCounters(ptr, counters) }
+        return Counters(
+            sentPackets = counters[0],
+            sentBytes = counters[1],
+            sendFailures = counters[2],
+            meanDrainLatencyInUs = if (counters[0] > 0) counters[3] / counters[0] else 0,
+            maxDrainLatencyInUs = counters[4]
+        )
+    }
+
+    /**
+     * Stops the drain thread. Messages that have not been sent yet are discarded.
+     * The socket is not closed.
+     *
+     * It is safe to call it concurrently with [counters] and several times.
+     */
+    override fun close() {
+        handle.close()
+    }
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import io.github.thibaultbee.srtdroid.core.enums.KMState
+import io.github.thibaultbee.srtdroid.core.enums.SockOpt
+import io.github.thibaultbee.srtdroid.core.enums.Transtype
+
+/**
+ * A reusable snapshot of socket options, filled by [SrtSocket.snapshotOptions] in a single native
+ * call.
+ *
+ * Values are stored as [Long]: booleans are 0 or 1 and [Transtype] or [KMState] are their ordinal.
+ * String options can't be part of a snapshot: use [SrtSocket.getSockFlag].
+ *
+ * @param options the [SockOpt] to read. By default, every option.
+ */
+class SockOptSnapshot(val options: List<SockOpt> = SockOpt.entries) {
+    internal val sockOpts = IntArray(options.size) { options[it].value }
+
+    /**
+     * Values of [options], in the same order. [NO_VALUE] if the option could not be read.
+     */
+    val values = LongArray(options.size)
+
+    /**
+     * Gets the value of an option of the last snapshot.
+     *
+     * @param opt the [SockOpt]
+     * @return the value or null if [opt] is not part of the snapshot or could not be read
+     */
+    operator fun get(opt: SockOpt): Long? {
+        val index = options.indexOf(opt)
+        if ((index < 0) || (values[index] == NO_VALUE)) {
+            return null
+        }
+        return values[index]
+    }
+
+    companion object {
+        /**
+         * Value of an option that could not be read
+         */
+        const val NO_VALUE = Long.MIN_VALUE
+    }
+}
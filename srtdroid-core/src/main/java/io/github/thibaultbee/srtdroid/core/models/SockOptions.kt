@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import io.github.thibaultbee.srtdroid.core.enums.KMState
+import io.github.thibaultbee.srtdroid.core.enums.SockOpt
+import io.github.thibaultbee.srtdroid.core.enums.Transtype
+import io.github.thibaultbee.srtdroid.core.interfaces.ConfigurableSrtSocket
+
+/**
+ * An ordered list of socket options packed to be applied in a single native call with
+ * [ConfigurableSrtSocket.applyOptions].
+ *
+ * It is immutable and can be applied to any number of sockets.
+ *
+ * @param options the ordered list of [SockOpt] and their value. Value types are the same as [SrtSocket.setSockFlag].
+ */
+class SockOptions(val options: List<Pair<SockOpt, Any>>) {
+    internal val sockOpts = IntArray(options.size) { options[it].first.value }
+    internal val types = IntArray(options.size)
+    internal val values = LongArray(options.size)
+    internal val strings = arrayOfNulls<String>(options.size)
+
+    init {
+        options.forEachIndexed { i, (opt, value) ->
+            when (value) {
+                is Int -> values[i] = value.toLong()
+                is Long -> {
+                    types[i] = TYPE_LONG
+                    values[i] = value
+                }
+
+                is Boolean -> {
+                    types[i] = TYPE_BOOL
+                    values[i] = if (value) 1 else 0
+                }
+
+                is String -> {
+                    require(isStringValueValid(value)) { "Value of $opt is too long" }
+                    types[i] = TYPE_STRING
+                    strings[i] = value
+                }
+
+                // SRT_TRANSTYPE and SRT_KM_STATE values are the enum ordinals
+                is Transtype -> values[i] = value.ordinal.toLong()
+                is KMState -> values[i] = value.ordinal.toLong()
+                else -> throw IllegalArgumentException("Unsupported value type ${value.javaClass.name} for $opt")
+            }
+        }
+    }
+
+    /**
+     * Builder of [SockOptions].
+     */
+    class Builder {
+        private val options = mutableListOf<Pair<SockOpt, Any>>()
+
+        /**
+         * Adds an option. Options are applied in the order they are added.
+         *
+         * @param opt the [SockOpt] to set
+         * @param value the [SockOpt] value to set
+         */
+        fun set(opt: SockOpt, value: Any) = apply { options.add(Pair(opt, value)) }
+
+        fun build() = SockOptions(options.toList())
+    }
+
+    companion object {
+        // Same values as native OptVal::Type
+        private const val TYPE_LONG = 1
+        private const val TYPE_BOOL = 2
+        private const val TYPE_STRING = 3
+
+        /**
+         * Size of the native string option buffer, terminating null included. Larger than any SRT
+         * string option (passphrase: 80, stream ID: 512).
+         */
+        private const val STRING_VALUE_BUFFER_SIZE = 1024
+
+        /**
+         * @return true if [value] fits in the native string option buffer
+         */
+        internal fun isStringValueValid(value: String): Boolean {
+            // Native code copies the modified UTF-8 encoding of the string
+            var size = 0
+            for (c in value) {
+                size += when {
+                    (c.code in 1..0x7F) -> 1
+                    (c.code <= 0x7FF) -> 2
+                    else -> 3
+                }
+            }
+            return size < STRING_VALUE_BUFFER_SIZE
+        }
+    }
+}
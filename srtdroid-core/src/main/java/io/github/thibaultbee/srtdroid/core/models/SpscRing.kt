@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * A single-producer single-consumer ring of fixed size slots in a direct [ByteBuffer], shared with
+ * a native thread. Must be kept in sync with native SpscRing.h.
+ *
+ * Indexes are free running counters: a slot index is the counter modulo [capacity].
+ *
+ * @param capacity the number of slots. It must be a power of 2.
+ * @param maxPayloadSize the maximum size of a message in a slot
+ */
+internal class SpscRing(val capacity: Int, val maxPayloadSize: Int) {
+    companion object {
+        const val HEAD_OFFSET = 0
+        const val TAIL_OFFSET = 64
+        const val WAITING_OFFSET = 128
+        const val HEADER_SIZE = 192
+
+        const val SLOT_LENGTH_OFFSET = 0
+        const val SLOT_TTL_OFFSET = 4
+        const val SLOT_PKTSEQ_OFFSET = 8
+        const val SLOT_MSGNO_OFFSET = 12
+        const val SLOT_SRCTIME_OFFSET = 16
+        const val SLOT_TIME_OFFSET = 24
+        const val SLOT_PAYLOAD_OFFSET = 32
+
+        /**
+         * Current time in microseconds on the monotonic clock, as native [Time.now].
+         */
+        fun now() = System.nanoTime() / 1000
+    }
+
+    init {
+        require((capacity > 0) && ((capacity and (capacity - 1)) == 0)) { "capacity must be a power of 2" }
+        require(maxPayloadSize > 0) { "maxPayloadSize must be positive" }
+    }
+
+    /**
+     * Size of a slot, header included. Slots are 8 bytes aligned.
+     */
+    val slotSize = SLOT_PAYLOAD_OFFSET + (maxPayloadSize + 7) / 8 * 8
+
+    val buffer: ByteBuffer =
+        ByteBuffer.allocateDirect(HEADER_SIZE + capacity * slotSize).order(ByteOrder.nativeOrder())
+
+    /**
+     * A view on [buffer] to copy payloads without allocation.
+     */
+    val payloads: ByteBuffer = buffer.duplicate()
+
+    @Volatile
+    private var fence = 0
+
+    /**
+     * Full memory barrier between accesses to [buffer]: a volatile write followed by a volatile
+     * read. Java has no fence for direct buffer accesses before API 33.
+     */
+    fun fullFence(): Int {
+        fence = 0
+        return fence
+    }
+
+    var head: Int
+        get() = buffer.getInt(HEAD_OFFSET)
+        set(value) {
+            buffer.putInt(HEAD_OFFSET, value)
+        }
+
+    var tail: Int
+        get() = buffer.getInt(TAIL_OFFSET)
+        set(value) {
+            buffer.putInt(TAIL_OFFSET, value)
+        }
+
+    var isWaiting: Boolean
+        get() = buffer.getInt(WAITING_OFFSET) != 0
+        set(value) {
+            buffer.putInt(WAITING_OFFSET, if (value) 1 else 0)
+        }
+
+    /**
+     * @return the offset of the slot of an index in [buffer]
+     */
+    fun slotOffset(index: Int) = HEADER_SIZE + (index and (capacity - 1)) * slotSize
+}
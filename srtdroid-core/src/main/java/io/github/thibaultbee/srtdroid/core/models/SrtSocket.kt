@@ -18,9 +18,12 @@ package io.github.thibaultbee.srtdroid.core.models
 import android.util.Pair
 import io.github.thibaultbee.srtdroid.core.Srt
 import io.github.thibaultbee.srtdroid.core.enums.ErrorType
+import io.github.thibaultbee.srtdroid.core.enums.KMState
 import io.github.thibaultbee.srtdroid.core.enums.RejectReasonCode
+import io.github.thibaultbee.srtdroid.core.enums.SendBufferMetric
 import io.github.thibaultbee.srtdroid.core.enums.SockOpt
 import io.github.thibaultbee.srtdroid.core.enums.SockStatus
+import io.github.thibaultbee.srtdroid.core.enums.Transtype
 import io.github.thibaultbee.srtdroid.core.interfaces.ConfigurableSrtSocket
 import io.github.thibaultbee.srtdroid.core.models.rejectreason.InternalRejectReason
 import io.github.thibaultbee.srtdroid.core.models.rejectreason.PredefinedRejectReason
@@ -39,6 +42,9 @@ import java.net.SocketException
 import java.net.SocketTimeoutException
 import java.net.StandardProtocolFamily
 import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.nio.DoubleBuffer
+import java.nio.LongBuffer
 
 /**
  * This class represents a SRT socket.
@@ -46,7 +52,7 @@ import java.nio.ByteBuffer
  * Once it has been called, you must release Srt context with [Srt.cleanUp] when application leaves.
  */
 class SrtSocket
-private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeable {
+private constructor(internal val srtsocket: Int) : ConfigurableSrtSocket, Closeable {
     companion object {
         @JvmStatic
         private external fun nativeCreateSocket(): Int
@@ -58,6 +64,235 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
             protocol: Int
         ): Int
 
+        /*
+         * Static natives that take the SRT socket id: native code doesn't have to read it back from
+         * the SrtSocket object on every call.
+         */
+        @JvmStatic
+        private external fun nativeIsValid(srtsocket: Int): Boolean
+
+        @JvmStatic
+        private external fun nativeClose(srtsocket: Int): Int
+
+        /**
+         * Registers a [SrtSocket] created from Java so native code returns it instead of a new
+         * [SrtSocket] (in accept, epoll or callbacks).
+         */
+        @JvmStatic
+        private external fun nativeRegister(srtsocket: Int, socket: SrtSocket)
+
+        @JvmStatic
+        private external fun nativeSetSockOpt(srtsocket: Int, opt: Int, value: Int): Int
+
+        @JvmStatic
+        private external fun nativeSetSockOpt(srtsocket: Int, opt: Int, value: Long): Int
+
+        @JvmStatic
+        private external fun nativeSetSockOpt(srtsocket: Int, opt: Int, value: Boolean): Int
+
+        @JvmStatic
+        private external fun nativeSetSockOpt(srtsocket: Int, opt: Int, value: String): Int
+
+        @JvmStatic
+        private external fun nativeApplyOptions(
+            srtsocket: Int,
+            opts: IntArray,
+            types: IntArray,
+            values: LongArray,
+            strings: Array<String?>
+        ): Int
+
+        @JvmStatic
+        private external fun nativeSnapshotOptions(
+            srtsocket: Int,
+            opts: IntArray,
+            values: LongArray
+        ): Int
+
+        @JvmStatic
+        private external fun nativeSetSndWatermarks(
+            srtsocket: Int,
+            metric: Int,
+            low: Long,
+            high: Long,
+            intervalInMs: Int
+        ): Int
+
+        @JvmStatic
+        private external fun nativeGetSndBufferLevel(srtsocket: Int, metric: Int): Long
+
+        @JvmStatic
+        private external fun nativeBiStats(
+            srtsocket: Int,
+            clear: Boolean,
+            instantaneous: Boolean,
+            values: LongArray,
+            offset: Int
+        ): Int
+
+        @JvmStatic
+        private external fun nativeBiStats(
+            srtsocket: Int,
+            clear: Boolean,
+            instantaneous: Boolean,
+            values: LongBuffer,
+            offset: Int
+        ): Int
+
+        @JvmStatic
+        private external fun nativeBiStats(
+            srtsocket: Int,
+            clear: Boolean,
+            instantaneous: Boolean,
+            values: DoubleBuffer,
+            offset: Int
+        ): Int
+
+        @JvmStatic
+        private external fun nativeSend(srtsocket: Int, msg: ByteArray, offset: Int, size: Int): Int
+
+        @JvmStatic
+        private external fun nativeSendBatch(
+            srtsocket: Int,
+            data: ByteBuffer,
+            offsets: IntArray,
+            lengths: IntArray,
+            srcTimes: LongArray,
+            count: Int,
+            ttl: Int,
+            inOrder: Boolean,
+            msgNos: IntArray
+        ): Int
+
+        @JvmStatic
+        private external fun nativeSend(srtsocket: Int, msg: ByteBuffer, offset: Int, size: Int): Int
+
+        @JvmStatic
+        private external fun nativeSend(
+            srtsocket: Int,
+            msg: ByteBuffer,
+            offset: Int,
+            size: Int,
+            ttl: Int,
+            inOrder: Boolean
+        ): Int
+
+        @JvmStatic
+        private external fun nativeSend(
+            srtsocket: Int,
+            msg: ByteArray,
+            offset: Int,
+            size: Int,
+            ttl: Int,
+            inOrder: Boolean
+        ): Int
+
+        @JvmStatic
+        private external fun nativeSend(
+            srtsocket: Int,
+            msg: ByteBuffer,
+            offset: Int,
+            size: Int,
+            msgCtrl: ByteBuffer
+        ): Int
+
+        @JvmStatic
+        private external fun nativeSend(
+            srtsocket: Int,
+            msg: ByteArray,
+            offset: Int,
+            size: Int,
+            msgCtrl: ByteBuffer
+        ): Int
+
+        @JvmStatic
+        private external fun nativeRecv(
+            srtsocket: Int,
+            buffer: ByteBuffer,
+            offset: Int,
+            byteCount: Int
+        ): Int
+
+        @JvmStatic
+        private external fun nativeRecv(
+            srtsocket: Int,
+            buffer: ByteArray,
+            offset: Int,
+            byteCount: Int
+        ): Int
+
+        @JvmStatic
+        private external fun nativeRecv(
+            srtsocket: Int,
+            buffer: ByteBuffer,
+            offset: Int,
+            byteCount: Int,
+            msgCtrl: ByteBuffer
+        ): Int
+
+        @JvmStatic
+        private external fun nativeRecv(
+            srtsocket: Int,
+            buffer: ByteArray,
+            offset: Int,
+            byteCount: Int,
+            msgCtrl: ByteBuffer
+        ): Int
+
+        @JvmStatic
+        private external fun nativeRecvBatch(
+            srtsocket: Int,
+            buffer: ByteBuffer,
+            offset: Int,
+            byteCount: Int,
+            lengths: IntArray,
+            srcTimes: LongArray,
+            pktSeqs: IntArray,
+            max: Int
+        ): Int
+
+        @JvmStatic
+        private external fun nativeSendFile(
+            srtsocket: Int,
+            path: String,
+            offset: Long,
+            size: Long,
+            block: Int
+        ): Long
+
+        @JvmStatic
+        private external fun nativeRecvFile(
+            srtsocket: Int,
+            path: String,
+            offset: Long,
+            size: Long,
+            block: Int
+        ): Long
+
+        @JvmStatic
+        private external fun nativeGetRejectReason(srtsocket: Int): Int
+
+        @JvmStatic
+        private external fun nativeSetRejectReason(srtsocket: Int, rejectReason: Int): Int
+
+        @JvmStatic
+        private external fun nativeGetConnectionTime(srtsocket: Int): Long
+
+        @JvmStatic
+        private external fun nativeSetAdmissionPolicy(
+            srtsocket: Int,
+            actions: IntArray,
+            keys: Array<String>,
+            patterns: Array<String>,
+            rejectReasons: IntArray,
+            defaultAction: Int,
+            defaultRejectReason: Int,
+            rateLimits: DoubleArray,
+            rateLimitRejectReason: Int
+        ): Int
+
+        private const val DEFAULT_SEND_BUFFER_WATERMARK_INTERVAL_IN_MS = 10
+
         init {
             Srt.startUp()
         }
@@ -73,6 +308,11 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
      */
     var serverListener: ServerListener? = null
 
+    /**
+     * Send buffer listener. See [setSendBufferWatermarks].
+     */
+    var sendBufferListener: SendBufferListener? = null
+
     /**
      * Deprecated version of [SrtSocket] constructor. Argument is ignored.
      * Also, it crashes on old Android version (where [StandardProtocolFamily] does not exist).
@@ -88,7 +328,9 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
             0,
             0
         )
-    )
+    ) {
+        nativeRegister(srtsocket, this)
+    }
 
     /**
      * Creates an SRT socket.
@@ -97,9 +339,9 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
      *
      * **See Also:** [srt_create_socket](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_create_socket)
      */
-    constructor() : this(nativeCreateSocket())
-
-    private external fun nativeIsValid(): Boolean
+    constructor() : this(nativeCreateSocket()) {
+        nativeRegister(srtsocket, this)
+    }
 
     /**
      * Check if the SRT socket is a valid SRT socket.
@@ -107,7 +349,7 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
      * @return true if the SRT socket is valid, otherwise false
      */
     val isValid: Boolean
-        get() = nativeIsValid()
+        get() = nativeIsValid(srtsocket)
 
     private external fun nativeBind(address: InetSocketAddress): Int
 
@@ -161,8 +403,6 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
     val sockState: SockStatus
         get() = nativeGetSockState()
 
-    private external fun nativeClose(): Int
-
     /**
      * Closes the socket or group and frees all used resources.
      *
@@ -171,7 +411,7 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
      * @throws SocketException if close failed
      */
     override fun close() {
-        if (nativeClose() != 0) {
+        if (nativeClose(srtsocket) != 0) {
             throw SocketException(SrtError.lastErrorMessage)
         }
     }
@@ -209,6 +449,48 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
         }
     }
 
+    /**
+     * Admission policy of incoming connections on a listener socket.
+     *
+     * The policy is evaluated natively before [ServerListener.onListen] so rejected connections
+     * never reach the JVM. Set it before or after [listen]. Set null to accept every connection.
+     *
+     * @see [AdmissionPolicy]
+     */
+    var admissionPolicy: AdmissionPolicy? = null
+        /**
+         * Sets the admission policy.
+         *
+         * @param value the [AdmissionPolicy] or null
+         * @throws SocketException if the policy can't be set
+         */
+        set(value) {
+            val policy = value ?: AdmissionPolicy()
+            val rules = policy.rules
+            val globalRateLimit = policy.globalRateLimit
+            val perAddressRateLimit = policy.perAddressRateLimit
+            if (nativeSetAdmissionPolicy(
+                    srtsocket,
+                    IntArray(rules.size) { rules[it].action.ordinal },
+                    Array(rules.size) { rules[it].key ?: "" },
+                    Array(rules.size) { rules[it].pattern },
+                    IntArray(rules.size) { rules[it].rejectReason?.nativeCode ?: 0 },
+                    policy.defaultAction.ordinal,
+                    policy.rejectReason.nativeCode,
+                    doubleArrayOf(
+                        globalRateLimit?.connectionsPerSecond ?: 0.0,
+                        globalRateLimit?.burst?.toDouble() ?: 0.0,
+                        perAddressRateLimit?.connectionsPerSecond ?: 0.0,
+                        perAddressRateLimit?.burst?.toDouble() ?: 0.0
+                    ),
+                    policy.rateLimitRejectReason.nativeCode
+                ) != 0
+            ) {
+                throw SocketException(SrtError.lastErrorMessage)
+            }
+            field = value
+        }
+
     private external fun nativeAccept(): Pair<SrtSocket, InetSocketAddress?>
 
     /**
@@ -426,8 +708,6 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
             ?: throw IOException(SrtError.lastErrorMessage)
     }
 
-    private external fun nativeSetSockFlag(opt: SockOpt, value: Any): Int
-
     /**
      * Sets the value of the given socket option.
      *
@@ -439,16 +719,63 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
      * @see [getSockFlag]
      */
     override fun setSockFlag(opt: SockOpt, value: Any) {
-        if (nativeSetSockFlag(opt, value) != 0) {
+        val res = when (value) {
+            is Int -> nativeSetSockOpt(srtsocket, opt.value, value)
+            is Long -> nativeSetSockOpt(srtsocket, opt.value, value)
+            is Boolean -> nativeSetSockOpt(srtsocket, opt.value, value)
+            is String -> {
+                if (!SockOptions.isStringValueValid(value)) {
+                    throw IOException("Value of $opt is too long")
+                }
+                nativeSetSockOpt(srtsocket, opt.value, value)
+            }
+            // SRT_TRANSTYPE and SRT_KM_STATE values are the enum ordinals
+            is Transtype -> nativeSetSockOpt(srtsocket, opt.value, value.ordinal)
+            is KMState -> nativeSetSockOpt(srtsocket, opt.value, value.ordinal)
+            else -> throw IOException("Unsupported value type ${value.javaClass.name} for $opt")
+        }
+        if (res != 0) {
             throw IOException(SrtError.lastErrorMessage)
         }
     }
 
+    /**
+     * Sets a list of socket options, in order, in a single native call.
+     *
+     * **See Also:** [srt_setsockflag](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_setsockflag)
+     *
+     * @param options the [SockOptions] to set
+     * @throws IOException if an option can't be set. Options before the failed one are set.
+     * @see [setSockFlag]
+     */
+    override fun applyOptions(options: SockOptions) {
+        val failedIndex = nativeApplyOptions(
+            srtsocket,
+            options.sockOpts,
+            options.types,
+            options.values,
+            options.strings
+        )
+        if (failedIndex >= 0) {
+            throw IOException("Failed to set ${options.options[failedIndex].first}: ${SrtError.lastErrorMessage}")
+        }
+    }
+
+    /**
+     * Reads the options of [snapshot] in a single native call.
+     *
+     * **See Also:** [srt_getsockflag](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_getsockflag)
+     *
+     * @param snapshot the [SockOptSnapshot] to fill. It can be reused for every snapshot.
+     * @return the number of options that have been read
+     * @see [getSockFlag]
+     */
+    fun snapshotOptions(snapshot: SockOptSnapshot = SockOptSnapshot()): Int {
+        return nativeSnapshotOptions(srtsocket, snapshot.sockOpts, snapshot.values)
+    }
+
     // Transmission
     // Send
-    private external fun nativeSend(msg: ByteArray, offset: Int, size: Int): Int
-    private external fun nativeSend(msg: ByteBuffer, offset: Int, size: Int): Int
-
     /**
      * Sends a message to a remote party.
      *
@@ -463,7 +790,7 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
     fun send(msg: ByteBuffer): Int {
         require(msg.isDirect) { "msg must be a direct ByteBuffer" }
 
-        val byteSent = nativeSend(msg, msg.position(), msg.remaining())
+        val byteSent = nativeSend(srtsocket, msg, msg.position(), msg.remaining())
         when {
             byteSent < 0 -> {
                 throw SocketException(SrtError.lastErrorMessage)
@@ -491,7 +818,7 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
      * @see [recv]
      */
     fun send(msg: ByteArray, offset: Int, size: Int): Int {
-        val byteSent = nativeSend(msg, offset, size)
+        val byteSent = nativeSend(srtsocket, msg, offset, size)
         when {
             byteSent < 0 -> {
                 throw SocketException(SrtError.lastErrorMessage)
@@ -531,22 +858,6 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
      */
     fun send(msg: String) = send(msg.toByteArray())
 
-    private external fun nativeSend(
-        msg: ByteBuffer,
-        offset: Int,
-        size: Int,
-        ttl: Int = -1,
-        inOrder: Boolean = false
-    ): Int
-
-    private external fun nativeSend(
-        msg: ByteArray,
-        offset: Int,
-        size: Int,
-        ttl: Int = -1,
-        inOrder: Boolean = false
-    ): Int
-
     /**
      * Sends a message to a remote party.
      *
@@ -567,7 +878,7 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
     ): Int {
         require(msg.isDirect) { "msg must be a direct ByteBuffer" }
 
-        val byteSent = nativeSend(msg, msg.position(), msg.remaining(), ttl, inOrder)
+        val byteSent = nativeSend(srtsocket, msg, msg.position(), msg.remaining(), ttl, inOrder)
         when {
             byteSent < 0 -> {
                 throw SocketException(SrtError.lastErrorMessage)
@@ -603,7 +914,7 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
         ttl: Int = -1,
         inOrder: Boolean = false
     ): Int {
-        val byteSent = nativeSend(msg, offset, size, ttl, inOrder)
+        val byteSent = nativeSend(srtsocket, msg, offset, size, ttl, inOrder)
         when {
             byteSent < 0 -> {
                 throw SocketException(SrtError.lastErrorMessage)
@@ -649,20 +960,6 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
     fun send(msg: String, ttl: Int = -1, inOrder: Boolean = false) =
         send(msg.toByteArray(), ttl, inOrder)
 
-    private external fun nativeSend(
-        msg: ByteBuffer,
-        offset: Int,
-        size: Int,
-        msgCtrl: MsgCtrl
-    ): Int
-
-    private external fun nativeSend(
-        msg: ByteArray,
-        offset: Int,
-        size: Int,
-        msgCtrl: MsgCtrl
-    ): Int
-
     /**
      * Sends a message to a remote party.
      *
@@ -678,7 +975,8 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
     fun send(msg: ByteBuffer, msgCtrl: MsgCtrl): Int {
         require(msg.isDirect) { "msg must be a direct ByteBuffer" }
 
-        val byteSent = nativeSend(msg, msg.position(), msg.remaining(), msgCtrl)
+        val byteSent =
+            nativeSend(srtsocket, msg, msg.position(), msg.remaining(), msgCtrl.toNative())
         when {
             byteSent < 0 -> {
                 throw SocketException(SrtError.lastErrorMessage)
@@ -712,7 +1010,7 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
         size: Int,
         msgCtrl: MsgCtrl
     ): Int {
-        val byteSent = nativeSend(msg, offset, size, msgCtrl)
+        val byteSent = nativeSend(srtsocket, msg, offset, size, msgCtrl.toNative())
         when {
             byteSent < 0 -> {
                 throw SocketException(SrtError.lastErrorMessage)
@@ -756,6 +1054,89 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
     fun send(msg: String, msgCtrl: MsgCtrl) =
         send(msg.toByteArray(), msgCtrl)
 
+    /**
+     * Sends many messages to a remote party in a single native call.
+     *
+     * Messages are sent in order until one can't be sent. In non-blocking mode, it returns the
+     * number of messages accepted before the send buffer was full, 0 if it was already full.
+     *
+     * **See Also:** [srt_sendmsg2](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_sendmsg2)
+     *
+     * @param data the [ByteBuffer] that contains the messages. It must be allocate with [ByteBuffer.allocateDirect]. Offsets are from the start of the buffer, regardless of [ByteBuffer.position].
+     * @param offsets the offsets of the messages in [data]
+     * @param lengths the lengths of the messages
+     * @param srcTimes the source times of the messages in microseconds. 0 means now.
+     * @param count the number of messages to send
+     * @param msgNos where the message numbers of the sent messages are written to
+     * @param ttl the time (in ms) to wait for a successful delivery. -1 means no time limitation.
+     * @param inOrder Required to be received in the order of sending.
+     * @return the number of messages sent. Use [MsgBatch.bytes] or sum [lengths] to get the number of bytes sent.
+     * @throws SocketException if the first message failed for another reason than a full send buffer
+     * @see [send]
+     */
+    fun sendBatch(
+        data: ByteBuffer,
+        offsets: IntArray,
+        lengths: IntArray,
+        srcTimes: LongArray,
+        count: Int,
+        msgNos: IntArray,
+        ttl: Int = -1,
+        inOrder: Boolean = false
+    ): Int {
+        require(data.isDirect) { "data must be a direct ByteBuffer" }
+        require(
+            (count <= offsets.size) && (count <= lengths.size) && (count <= srcTimes.size) && (count <= msgNos.size)
+        ) { "Arrays must contain at least $count elements" }
+        val capacity = data.capacity()
+        for (i in 0 until count) {
+            require((offsets[i] >= 0) && (lengths[i] >= 0) && (offsets[i] <= capacity - lengths[i])) {
+                "Message $i is out of data"
+            }
+        }
+        if (count == 0) {
+            return 0
+        }
+
+        val res = nativeSendBatch(
+            srtsocket, data, offsets, lengths, srcTimes, count, ttl, inOrder, msgNos
+        )
+        if (res < 0) {
+            throw SocketException(SrtError.lastErrorMessage)
+        }
+        return res
+    }
+
+    /**
+     * Sends a [MsgBatch] to a remote party in a single native call. Message numbers are written
+     * to [MsgBatch.msgNos].
+     *
+     * **See Also:** [srt_sendmsg2](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_sendmsg2)
+     *
+     * @param data the [ByteBuffer] that contains the messages. It must be allocate with [ByteBuffer.allocateDirect].
+     * @param batch the messages to send
+     * @param ttl the time (in ms) to wait for a successful delivery. -1 means no time limitation.
+     * @param inOrder Required to be received in the order of sending.
+     * @return the number of messages sent, 0 if the send buffer is full in non-blocking mode
+     * @throws SocketException if the first message failed for another reason than a full send buffer
+     * @see [sendBatch]
+     */
+    fun sendBatch(
+        data: ByteBuffer,
+        batch: MsgBatch,
+        ttl: Int = -1,
+        inOrder: Boolean = false
+    ) = sendBatch(
+        data,
+        batch.offsets,
+        batch.lengths,
+        batch.srcTimes,
+        batch.size,
+        batch.msgNos,
+        ttl,
+        inOrder
+    )
+
     /**
      * Returns an output stream for this socket.
      *
@@ -819,8 +1200,6 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
     }
 
     // Recv
-    private external fun nativeRecv(size: Int): Pair<Int, ByteArray>
-
     /**
      * Received a message from a remote device
      *
@@ -832,8 +1211,8 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
      * @throws SocketTimeoutException if a timeout has been triggered
      */
     fun recv(size: Int): ByteArray {
-        val pair = nativeRecv(size)
-        val byteReceived = pair.first
+        val buffer = ByteArray(size)
+        val byteReceived = nativeRecv(srtsocket, buffer, 0, size)
         when {
             byteReceived < 0 -> {
                 throw SocketException(SrtError.lastErrorMessage)
@@ -843,16 +1222,10 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
                 throw SocketTimeoutException(ErrorType.ESCLOSED.toString())
             }
 
-            else -> return pair.second.sliceArray(0 until byteReceived)
+            else -> return buffer.copyOf(byteReceived)
         }
     }
 
-    private external fun nativeRecv(
-        buffer: ByteArray,
-        offset: Int,
-        byteCount: Int
-    ): Pair<Int, ByteArray>
-
     /**
      * Received a message from a remote device
      *
@@ -870,8 +1243,7 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
         offset: Int = 0,
         byteCount: Int = buffer.size
     ): Int {
-        val pair = nativeRecv(buffer, offset, byteCount)
-        val byteReceived = pair.first
+        val byteReceived = nativeRecv(srtsocket, buffer, offset, byteCount)
         when {
             byteReceived < 0 -> {
                 throw SocketException(SrtError.lastErrorMessage)
@@ -881,14 +1253,39 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
                 throw SocketTimeoutException(ErrorType.ESCLOSED.toString())
             }
 
-            else -> return pair.first
+            else -> return byteReceived
         }
     }
 
-    private external fun nativeRecv(
-        size: Int,
-        msgCtrl: MsgCtrl
-    ): Pair<Int, ByteArray>
+    /**
+     * Received a message from a remote device
+     *
+     * **See Also:** [srt_recv](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_recv)
+     *
+     * @param buffer the [ByteBuffer] where received data are written to. It must be allocate with [ByteBuffer.allocateDirect]. Data are written from [ByteBuffer.position] to [ByteBuffer.limit]. On return, [ByteBuffer.position] is moved after the received data.
+     * @return the number of bytes received.
+     * @throws SocketException if it has failed to send message
+     * @throws SocketTimeoutException if a timeout has been triggered
+     */
+    fun recv(buffer: ByteBuffer): Int {
+        require(buffer.isDirect) { "buffer must be a direct ByteBuffer" }
+
+        val byteReceived = nativeRecv(srtsocket, buffer, buffer.position(), buffer.remaining())
+        when {
+            byteReceived < 0 -> {
+                throw SocketException(SrtError.lastErrorMessage)
+            }
+
+            byteReceived == 0 -> {
+                throw SocketTimeoutException(ErrorType.ESCLOSED.toString())
+            }
+
+            else -> {
+                buffer.position(buffer.position() + byteReceived)
+                return byteReceived
+            }
+        }
+    }
 
     /**
      * Received a message from a remote device
@@ -902,8 +1299,8 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
      * @throws SocketTimeoutException if a timeout has been triggered
      */
     fun recv(size: Int, msgCtrl: MsgCtrl): ByteArray {
-        val pair = nativeRecv(size, msgCtrl)
-        val byteReceived = pair.first
+        val buffer = ByteArray(size)
+        val byteReceived = nativeRecv(srtsocket, buffer, 0, size, msgCtrl.toNative())
         when {
             byteReceived < 0 -> {
                 throw SocketException(SrtError.lastErrorMessage)
@@ -913,17 +1310,13 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
                 throw SocketTimeoutException(ErrorType.ESCLOSED.toString())
             }
 
-            else -> return pair.second
+            else -> {
+                msgCtrl.fromNative()
+                return buffer.copyOf(byteReceived)
+            }
         }
     }
 
-    private external fun nativeRecv(
-        buffer: ByteArray,
-        offset: Int,
-        byteCount: Int,
-        msgCtrl: MsgCtrl
-    ): Pair<Int, ByteArray>
-
     /**
      * Received a message from a remote device
      *
@@ -943,8 +1336,45 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
         byteCount: Int = buffer.size,
         msgCtrl: MsgCtrl
     ): Int {
-        val pair = nativeRecv(buffer, offset, byteCount, msgCtrl)
-        val byteReceived = pair.first
+        val byteReceived = nativeRecv(srtsocket, buffer, offset, byteCount, msgCtrl.toNative())
+        when {
+            byteReceived < 0 -> {
+                throw SocketException(SrtError.lastErrorMessage)
+            }
+
+            byteReceived == 0 -> {
+                throw SocketTimeoutException(ErrorType.ESCLOSED.toString())
+            }
+
+            else -> {
+                msgCtrl.fromNative()
+                return byteReceived
+            }
+        }
+    }
+
+    /**
+     * Received a message from a remote device
+     *
+     * **See Also:** [srt_recvmsg2](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_recvmsg2)
+     *
+     * @param buffer the [ByteBuffer] where received data are written to. It must be allocate with [ByteBuffer.allocateDirect]. Data are written from [ByteBuffer.position] to [ByteBuffer.limit]. On return, [ByteBuffer.position] is moved after the received data.
+     * @param msgCtrl the [MsgCtrl] that contains extra parameter
+     * @return the number of bytes received.
+     * @throws SocketException if it has failed to send message
+     * @throws SocketTimeoutException if a timeout has been triggered
+     */
+    fun recv(buffer: ByteBuffer, msgCtrl: MsgCtrl): Int {
+        require(buffer.isDirect) { "buffer must be a direct ByteBuffer" }
+
+        val byteReceived =
+            nativeRecv(
+                srtsocket,
+                buffer,
+                buffer.position(),
+                buffer.remaining(),
+                msgCtrl.toNative()
+            )
         when {
             byteReceived < 0 -> {
                 throw SocketException(SrtError.lastErrorMessage)
@@ -954,8 +1384,88 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
                 throw SocketTimeoutException(ErrorType.ESCLOSED.toString())
             }
 
-            else -> return pair.first
+            else -> {
+                buffer.position(buffer.position() + byteReceived)
+                msgCtrl.fromNative()
+                return byteReceived
+            }
+        }
+    }
+
+    /**
+     * Receives many messages from a remote device in a single native call.
+     *
+     * Messages are written back to back in [buffer]. The first message is waited for according to
+     * [SockOpt.RCVSYN]. Following messages are read until none is available, [max] messages have
+     * been received or [buffer] has no room left for a full packet ([SockOpt.PAYLOADSIZE]).
+     *
+     * **See Also:** [srt_recvmsg2](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_recvmsg2)
+     *
+     * @param buffer the [ByteBuffer] where received data are written to. It must be allocate with [ByteBuffer.allocateDirect]. Data are written from [ByteBuffer.position] to [ByteBuffer.limit]. On return, [ByteBuffer.position] is moved after the received data.
+     * @param lengths where the lengths of the received messages are written to
+     * @param srcTimes where the source times of the received messages are written to
+     * @param pktSeqs where the packet sequence numbers of the received messages are written to
+     * @param max the maximum number of messages to receive
+     * @return the number of messages received. 0 if no message is available.
+     * @throws SocketException if it has failed to receive message
+     * @see [recv]
+     */
+    fun recvBatch(
+        buffer: ByteBuffer,
+        lengths: IntArray,
+        srcTimes: LongArray,
+        pktSeqs: IntArray,
+        max: Int = lengths.size
+    ): Int {
+        require(buffer.isDirect) { "buffer must be a direct ByteBuffer" }
+        require(max > 0) { "max must be positive" }
+        require((max <= lengths.size) && (max <= srcTimes.size) && (max <= pktSeqs.size)) {
+            "Arrays must contain at least $max elements"
+        }
+
+        val res = nativeRecvBatch(
+            srtsocket,
+            buffer,
+            buffer.position(),
+            buffer.remaining(),
+            lengths,
+            srcTimes,
+            pktSeqs,
+            max
+        )
+        if (res < 0) {
+            throw SocketException(SrtError.lastErrorMessage)
+        }
+        for (i in 0 until res) {
+            buffer.position(buffer.position() + lengths[i])
+        }
+        return res
+    }
+
+    /**
+     * Receives many messages from a remote device in a single native call into a [MsgBatch].
+     *
+     * On return, [MsgBatch.offsets] are the offsets of the messages from the start of [buffer] so
+     * the same [buffer] and [batch] can be forwarded with [sendBatch].
+     *
+     * **See Also:** [srt_recvmsg2](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_recvmsg2)
+     *
+     * @param buffer the [ByteBuffer] where received data are written to. It must be allocate with [ByteBuffer.allocateDirect].
+     * @param batch where the received messages are described. Its previous content is replaced.
+     * @return the number of messages received. 0 if no message is available.
+     * @throws SocketException if it has failed to receive message
+     * @see [recvBatch]
+     */
+    fun recvBatch(buffer: ByteBuffer, batch: MsgBatch): Int {
+        var offset = buffer.position()
+        batch.clear()
+        val res = recvBatch(buffer, batch.lengths, batch.srcTimes, batch.pktSeqs, batch.capacity)
+        for (i in 0 until res) {
+            batch.offsets[i] = offset
+            offset += batch.lengths[i]
         }
+        batch.size = res
+        return res
     }
 
     /**
@@ -1021,13 +1531,6 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
     }
 
     // File
-    private external fun nativeSendFile(
-        path: String,
-        offset: Long,
-        size: Long,
-        block: Int = 364000
-    ): Long
-
     /**
      * Sends a specified file.
      *
@@ -1043,7 +1546,7 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
      * @see [recvFile]
      */
     fun sendFile(path: String, offset: Long = 0, size: Long, block: Int = 364000): Long {
-        val byteSent = nativeSendFile(path, offset, size, block)
+        val byteSent = nativeSendFile(srtsocket, path, offset, size, block)
         when {
             byteSent < 0 -> {
                 throw SocketException(SrtError.lastErrorMessage)
@@ -1089,13 +1592,6 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
     fun sendFile(file: File, block: Int = 364000) =
         sendFile(file.path, 0, file.length(), block)
 
-    private external fun nativeRecvFile(
-        path: String,
-        offset: Long,
-        size: Long,
-        block: Int = 7280000
-    ): Long
-
     /**
      * Receives a file. File will be located at [path].
      *
@@ -1111,7 +1607,7 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
      * @see [sendFile]
      */
     fun recvFile(path: String, offset: Long = 0, size: Long, block: Int = 7280000): Long {
-        val byteReceived = nativeRecvFile(path, offset, size, block)
+        val byteReceived = nativeRecvFile(srtsocket, path, offset, size, block)
         when {
             byteReceived < 0 -> {
                 throw SocketException(SrtError.lastErrorMessage)
@@ -1143,9 +1639,6 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
         recvFile(file.path, offset, size, block)
 
     // Reject reason
-    private external fun nativeGetRejectReason(): Int
-    private external fun nativeSetRejectReason(rejectReason: Int): Int
-
     /**
      * Set/get detailed reason for a failed connection attempt.
      *
@@ -1160,7 +1653,7 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
          * @return the object describing the rejection reason. Could be either [InternalRejectReason], [PredefinedRejectReason] or [UserDefinedRejectReason]
          */
         get() {
-            val code = nativeGetRejectReason()
+            val code = nativeGetRejectReason(srtsocket)
             return when {
                 code < RejectReasonCode.PREDEFINED_OFFSET -> InternalRejectReason(RejectReasonCode.entries[code])
                 code < RejectReasonCode.USERDEFINED_OFFSET -> PredefinedRejectReason(code - RejectReasonCode.PREDEFINED_OFFSET)
@@ -1178,25 +1671,69 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
          * @throws [SocketException] if action has failed
          */
         set(value) {
-            val code = when (value) {
-                is InternalRejectReason -> { // Forbidden by SRT
-                    value.code.ordinal
-                }
+            if (nativeSetRejectReason(srtsocket, value.nativeCode) != 0) {
+                throw SocketException(SrtError.lastErrorMessage)
+            }
+        }
 
-                is PredefinedRejectReason -> {
-                    value.code + RejectReasonCode.PREDEFINED_OFFSET
-                }
+    // Send buffer
+    /**
+     * Sets high and low watermarks on the send buffer occupancy.
+     *
+     * The occupancy is checked every [intervalInMs] by a watermark thread shared by all sockets,
+     * so sending is not slowed down. A crossing is reported up to [intervalInMs] late.
+     * [SendBufferListener.onSendBufferHigh] is called once when it reaches [high], then
+     * [SendBufferListener.onSendBufferLow] is called once when it goes back to [low].
+     * Listeners are called from the watermark thread: a slow listener delays the other sockets.
+     *
+     * @param low the low watermark
+     * @param high the high watermark. Set 0 to disable watermarks.
+     * @param metric the unit of [low] and [high]
+     * @param intervalInMs the occupancy check interval
+     * @see [sendBufferListener]
+     */
+    fun setSendBufferWatermarks(
+        low: Long,
+        high: Long,
+        metric: SendBufferMetric = SendBufferMetric.MS,
+        intervalInMs: Int = DEFAULT_SEND_BUFFER_WATERMARK_INTERVAL_IN_MS
+    ) {
+        require(low <= high) { "low must be lower than high" }
+        require(intervalInMs > 0) { "intervalInMs must be positive" }
+        if (nativeSetSndWatermarks(srtsocket, metric.ordinal, low, high, intervalInMs) != 0) {
+            throw SocketException("Can't start send buffer watermark thread")
+        }
+    }
 
-                is UserDefinedRejectReason -> {
-                    value.code + RejectReasonCode.USERDEFINED_OFFSET
-                }
+    /**
+     * Gets the send buffer occupancy without building [Stats].
+     *
+     * **See Also:** [srt_getsndbuffer](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_getsndbuffer)
+     *
+     * @param metric the unit of the returned occupancy
+     * @return the send buffer occupancy
+     * @throws SocketException if the occupancy can't be retrieved
+     */
+    fun sendBufferLevel(metric: SendBufferMetric = SendBufferMetric.MS): Long {
+        val level = nativeGetSndBufferLevel(srtsocket, metric.ordinal)
+        if (level < 0) {
+            throw SocketException(SrtError.lastErrorMessage)
+        }
+        return level
+    }
 
-                else -> RejectReasonCode.UNKNOWN.ordinal
-            }
-            if (nativeSetRejectReason(code) != 0) {
-                throw SocketException(SrtError.lastErrorMessage)
-            }
+    /**
+     * Internal method. Do not use, use [SendBufferListener] instead.
+     *
+     * @see [SendBufferListener]
+     */
+    private fun onSendBufferWatermark(isHigh: Boolean, level: Long) {
+        if (isHigh) {
+            sendBufferListener?.onSendBufferHigh(this, level)
+        } else {
+            sendBufferListener?.onSendBufferLow(this, level)
         }
+    }
 
     // Performance tracking
     /**
@@ -1223,9 +1760,80 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
         instantaneous: Boolean
     ): Stats
 
-    // Time access
-    private external fun nativeGetConnectionTime(): Long
+    /**
+     * Reports the current statistics without allocating.
+     *
+     * **See Also:** [srt_bistats](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_bistats)
+     *
+     * @param clear true if the statistics should be cleared after retrieval
+     * @param instantaneous true if the statistics should use instant data, not moving averages
+     * @param stats the [StatsBuffer] to write to. It can be reused for every call.
+     * @return [stats]
+     * @throws SocketException if statistics can't be retrieved
+     */
+    fun bistats(
+        clear: Boolean,
+        instantaneous: Boolean,
+        stats: StatsBuffer
+    ): StatsBuffer {
+        if (nativeBiStats(srtsocket, clear, instantaneous, stats.values, 0) != 0) {
+            throw SocketException(SrtError.lastErrorMessage)
+        }
+        return stats
+    }
+
+    /**
+     * Reports the current statistics into a direct [LongBuffer], with the layout of [StatsBuffer].
+     *
+     * **See Also:** [srt_bistats](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_bistats)
+     *
+     * @param clear true if the statistics should be cleared after retrieval
+     * @param instantaneous true if the statistics should use instant data, not moving averages
+     * @param values the [LongBuffer] to write to. It must be a view of a [ByteBuffer.allocateDirect] in native order with at least [StatsBuffer.LAYOUT_SIZE] remaining elements. Statistics are written from [LongBuffer.position]. On return, [LongBuffer.position] is moved after them.
+     * @throws SocketException if statistics can't be retrieved
+     */
+    fun bistats(
+        clear: Boolean,
+        instantaneous: Boolean,
+        values: LongBuffer
+    ) {
+        require(values.isDirect) { "values must be a direct LongBuffer" }
+        require(values.order() == ByteOrder.nativeOrder()) { "values must be in native order" }
+        require(values.remaining() >= StatsBuffer.LAYOUT_SIZE) { "values is too small" }
+
+        if (nativeBiStats(srtsocket, clear, instantaneous, values, values.position()) != 0) {
+            throw SocketException(SrtError.lastErrorMessage)
+        }
+        values.position(values.position() + StatsBuffer.LAYOUT_SIZE)
+    }
+
+    /**
+     * Reports the current statistics into a direct [DoubleBuffer], with the layout of [StatsBuffer].
+     * Unlike [LongBuffer], every field is converted to a [Double].
+     *
+     * **See Also:** [srt_bistats](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_bistats)
+     *
+     * @param clear true if the statistics should be cleared after retrieval
+     * @param instantaneous true if the statistics should use instant data, not moving averages
+     * @param values the [DoubleBuffer] to write to. It must be a view of a [ByteBuffer.allocateDirect] in native order with at least [StatsBuffer.LAYOUT_SIZE] remaining elements. Statistics are written from [DoubleBuffer.position]. On return, [DoubleBuffer.position] is moved after them.
+     * @throws SocketException if statistics can't be retrieved
+     */
+    fun bistats(
+        clear: Boolean,
+        instantaneous: Boolean,
+        values: DoubleBuffer
+    ) {
+        require(values.isDirect) { "values must be a direct DoubleBuffer" }
+        require(values.order() == ByteOrder.nativeOrder()) { "values must be in native order" }
+        require(values.remaining() >= StatsBuffer.LAYOUT_SIZE) { "values is too small" }
 
+        if (nativeBiStats(srtsocket, clear, instantaneous, values, values.position()) != 0) {
+            throw SocketException(SrtError.lastErrorMessage)
+        }
+        values.position(values.position() + StatsBuffer.LAYOUT_SIZE)
+    }
+
+    // Time access
     /**
      * Gets the time when SRT socket was open to establish a connection.
      *
@@ -1236,7 +1844,7 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
      */
     val connectionTime: Long
         get() {
-            val connectionTime = nativeGetConnectionTime()
+            val connectionTime = nativeGetConnectionTime(srtsocket)
             if (connectionTime < 0) {
                 throw SocketException(SrtError.lastErrorMessage)
             }
@@ -1427,4 +2035,28 @@ private constructor(private val srtsocket: Int) : ConfigurableSrtSocket, Closeab
             token: Int
         ) = Unit
     }
-}
\ No newline at end of file
+
+    /**
+     * This interface is used by a sender [SrtSocket] to notify send buffer watermark crossings.
+     * Listeners are called on the sending thread and must not block.
+     *
+     * @see [setSendBufferWatermarks]
+     */
+    interface SendBufferListener {
+        /**
+         * Called when the send buffer occupancy reaches the high watermark.
+         *
+         * @param socket the SRT socket
+         * @param level the send buffer occupancy
+         */
+        fun onSendBufferHigh(socket: SrtSocket, level: Long) = Unit
+
+        /**
+         * Called when the send buffer occupancy goes back to the low watermark.
+         *
+         * @param socket the SRT socket
+         * @param level the send buffer occupancy
+         */
+        fun onSendBufferLow(socket: SrtSocket, level: Long) = Unit
+    }
+}
@@ -405,67 +405,79 @@ data class SrtUrl(
         return uriBuilder.build()
     }
 
-    /**
-     * Sets pre configuration for binding socket.
-     * Internal purpose only.
-     */
-    fun preBindApplyTo(socket: ConfigurableSrtSocket) {
-        iptos?.let { socket.setSockFlag(SockOpt.IPTOS, it) }
-        ipttl?.let { socket.setSockFlag(SockOpt.IPTTL, it) }
-        maxSegmentSize?.let { socket.setSockFlag(SockOpt.MSS, it) }
-        receiveUDPBufferSize?.let { socket.setSockFlag(SockOpt.UDP_RCVBUF, it) }
-        sendUDPBufferSize?.let { socket.setSockFlag(SockOpt.UDP_SNDBUF, it) }
-        sendBufferSize?.let { socket.setSockFlag(SockOpt.SNDBUF, it) }
-        recvBufferSize?.let { socket.setSockFlag(SockOpt.RCVBUF, it) }
+    private val preBindOptions by lazy {
+        SockOptions.Builder().apply {
+            iptos?.let { set(SockOpt.IPTOS, it) }
+            ipttl?.let { set(SockOpt.IPTTL, it) }
+            maxSegmentSize?.let { set(SockOpt.MSS, it) }
+            receiveUDPBufferSize?.let { set(SockOpt.UDP_RCVBUF, it) }
+            sendUDPBufferSize?.let { set(SockOpt.UDP_SNDBUF, it) }
+            sendBufferSize?.let { set(SockOpt.SNDBUF, it) }
+            recvBufferSize?.let { set(SockOpt.RCVBUF, it) }
+        }.build()
     }
 
-    /**
-     * Sets pre configuration for socket.
-     * Internal purpose only.
-     */
-    fun preApplyTo(socket: ConfigurableSrtSocket) {
-        transtype?.let { socket.setSockFlag(SockOpt.TRANSTYPE, it) }
-        enableTimestampBasedPacketDelivery?.let { socket.setSockFlag(SockOpt.TSBPDMODE, it) }
+    private val preOptions by lazy {
+        SockOptions.Builder().apply {
+            transtype?.let { set(SockOpt.TRANSTYPE, it) }
+            enableTimestampBasedPacketDelivery?.let { set(SockOpt.TSBPDMODE, it) }
 
-        connectTimeoutInMs?.let { socket.setSockFlag(SockOpt.CONNTIMEO, it) }
-        flightFlagSize?.let { socket.setSockFlag(SockOpt.FC, it) }
+            connectTimeoutInMs?.let { set(SockOpt.CONNTIMEO, it) }
+            flightFlagSize?.let { set(SockOpt.FC, it) }
 
-        latencyInMs?.let { socket.setSockFlag(SockOpt.LATENCY, it) }
+            latencyInMs?.let { set(SockOpt.LATENCY, it) }
 
-        nakReport?.let { socket.setSockFlag(SockOpt.NAKREPORT, it) }
+            nakReport?.let { set(SockOpt.NAKREPORT, it) }
 
-        passphrase?.let { socket.setSockFlag(SockOpt.PASSPHRASE, it) }
-        enforcedEncryption?.let { socket.setSockFlag(SockOpt.ENFORCEDENCRYPTION, it) }
-        kmRefreshRate?.let { socket.setSockFlag(SockOpt.KMREFRESHRATE, it) }
-        kmPreannounce?.let { socket.setSockFlag(SockOpt.KMPREANNOUNCE, it) }
+            passphrase?.let { set(SockOpt.PASSPHRASE, it) }
+            enforcedEncryption?.let { set(SockOpt.ENFORCEDENCRYPTION, it) }
+            kmRefreshRate?.let { set(SockOpt.KMREFRESHRATE, it) }
+            kmPreannounce?.let { set(SockOpt.KMPREANNOUNCE, it) }
 
-        payloadSize?.let { socket.setSockFlag(SockOpt.PAYLOADSIZE, it) }
-        peerLatencyInMs?.let { socket.setSockFlag(SockOpt.PEERLATENCY, it) }
-        pbKeyLength?.let { socket.setSockFlag(SockOpt.PBKEYLEN, it) }
-        receiverLatencyInMs?.let { socket.setSockFlag(SockOpt.RCVLATENCY, it) }
+            payloadSize?.let { set(SockOpt.PAYLOADSIZE, it) }
+            peerLatencyInMs?.let { set(SockOpt.PEERLATENCY, it) }
+            pbKeyLength?.let { set(SockOpt.PBKEYLEN, it) }
+            receiverLatencyInMs?.let { set(SockOpt.RCVLATENCY, it) }
 
-        enableTooLatePacketDrop?.let { socket.setSockFlag(SockOpt.TLPKTDROP, it) }
+            enableTooLatePacketDrop?.let { set(SockOpt.TLPKTDROP, it) }
 
-        minVersion?.let { socket.setSockFlag(SockOpt.MINVERSION, it) }
-        streamId?.let { socket.setSockFlag(SockOpt.STREAMID, it) }
-        smoother?.let { socket.setSockFlag(SockOpt.CONGESTION, it) }
-        enableMessageApi?.let { socket.setSockFlag(SockOpt.MESSAGEAPI, it) }
+            minVersion?.let { set(SockOpt.MINVERSION, it) }
+            streamId?.let { set(SockOpt.STREAMID, it) }
+            smoother?.let { set(SockOpt.CONGESTION, it) }
+            enableMessageApi?.let { set(SockOpt.MESSAGEAPI, it) }
 
-        packetFilter?.let { socket.setSockFlag(SockOpt.PACKETFILTER, it) }
+            packetFilter?.let { set(SockOpt.PACKETFILTER, it) }
+        }.build()
+    }
+
+    private val postOptions by lazy {
+        SockOptions.Builder().apply {
+            inputBandwidth?.let { set(SockOpt.INPUTBW, it) }
+            maxBandwidth?.let { set(SockOpt.MAXBW, it) }
+            overheadBandwidth?.let { set(SockOpt.OHEADBW, it) }
+            senderDropDelayInMs?.let { set(SockOpt.SNDDROPDELAY, it) }
+            lossMaxTTL?.let { set(SockOpt.LOSSMAXTTL, it) }
+            lingerInS?.let { set(SockOpt.LINGER, it) }
+        }.build()
     }
 
+    /**
+     * Sets pre configuration for binding socket.
+     * Internal purpose only.
+     */
+    fun preBindApplyTo(socket: ConfigurableSrtSocket) = socket.applyOptions(preBindOptions)
+
+    /**
+     * Sets pre configuration for socket.
+     * Internal purpose only.
+     */
+    fun preApplyTo(socket: ConfigurableSrtSocket) = socket.applyOptions(preOptions)
+
     /**
      * Sets post configuration for socket.
      * Internal purpose only.
      */
-    fun postApplyTo(socket: ConfigurableSrtSocket) {
-        inputBandwidth?.let { socket.setSockFlag(SockOpt.INPUTBW, it) }
-        maxBandwidth?.let { socket.setSockFlag(SockOpt.MAXBW, it) }
-        overheadBandwidth?.let { socket.setSockFlag(SockOpt.OHEADBW, it) }
-        senderDropDelayInMs?.let { socket.setSockFlag(SockOpt.SNDDROPDELAY, it) }
-        lossMaxTTL?.let { socket.setSockFlag(SockOpt.LOSSMAXTTL, it) }
-        lingerInS?.let { socket.setSockFlag(SockOpt.LINGER, it) }
-    }
+    fun postApplyTo(socket: ConfigurableSrtSocket) = socket.applyOptions(postOptions)
 
     enum class Mode(val value: String) {
         LISTENER("listener"),
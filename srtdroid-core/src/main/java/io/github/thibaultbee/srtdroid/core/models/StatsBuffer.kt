@@ -0,0 +1,465 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+/**
+ * A reusable view over SRT statistics written by [SrtSocket.bistats] into a [LongArray].
+ *
+ * The index layout of [values] is versioned by [LAYOUT_VERSION]: field `xxx` of [Stats] is at index
+ * `XXX` (for example, [Stats.msRTT] is at [MS_RTT]). Indexes are never reused: new fields are
+ * appended and [LAYOUT_VERSION] is bumped. Floating point fields are stored as their IEEE 754 bits
+ * (see [Double.fromBits]).
+ *
+ * Accessors read [values] on each call: they reflect the last [SrtSocket.bistats] call.
+ *
+ * @param values the buffer to read from. Its size must be at least [LAYOUT_SIZE].
+ */
+class StatsBuffer(val values: LongArray = LongArray(LAYOUT_SIZE)) {
+    init {
+        require(values.size >= LAYOUT_SIZE) { "values must contain at least $LAYOUT_SIZE elements" }
+    }
+
+    val msTimeStamp: Long
+        get() = values[MS_TIME_STAMP]
+
+    val pktSentTotal: Long
+        get() = values[PKT_SENT_TOTAL]
+
+    val pktRecvTotal: Long
+        get() = values[PKT_RECV_TOTAL]
+
+    val pktSndLossTotal: Int
+        get() = values[PKT_SND_LOSS_TOTAL].toInt()
+
+    val pktRcvLossTotal: Int
+        get() = values[PKT_RCV_LOSS_TOTAL].toInt()
+
+    val pktRetransTotal: Int
+        get() = values[PKT_RETRANS_TOTAL].toInt()
+
+    val pktSentACKTotal: Int
+        get() = values[PKT_SENT_ACK_TOTAL].toInt()
+
+    val pktRecvACKTotal: Int
+        get() = values[PKT_RECV_ACK_TOTAL].toInt()
+
+    val pktSentNAKTotal: Int
+        get() = values[PKT_SENT_NAK_TOTAL].toInt()
+
+    val pktRecvNAKTotal: Int
+        get() = values[PKT_RECV_NAK_TOTAL].toInt()
+
+    val usSndDurationTotal: Long
+        get() = values[US_SND_DURATION_TOTAL]
+
+    val pktSndDropTotal: Int
+        get() = values[PKT_SND_DROP_TOTAL].toInt()
+
+    val pktRcvDropTotal: Int
+        get() = values[PKT_RCV_DROP_TOTAL].toInt()
+
+    val pktRcvUndecryptTotal: Int
+        get() = values[PKT_RCV_UNDECRYPT_TOTAL].toInt()
+
+    val byteSentTotal: Long
+        get() = values[BYTE_SENT_TOTAL]
+
+    val byteRecvTotal: Long
+        get() = values[BYTE_RECV_TOTAL]
+
+    val byteRcvLossTotal: Long
+        get() = values[BYTE_RCV_LOSS_TOTAL]
+
+    val byteRetransTotal: Long
+        get() = values[BYTE_RETRANS_TOTAL]
+
+    val byteSndDropTotal: Long
+        get() = values[BYTE_SND_DROP_TOTAL]
+
+    val byteRcvDropTotal: Long
+        get() = values[BYTE_RCV_DROP_TOTAL]
+
+    val byteRcvUndecryptTotal: Long
+        get() = values[BYTE_RCV_UNDECRYPT_TOTAL]
+
+    val pktSent: Long
+        get() = values[PKT_SENT]
+
+    val pktRecv: Long
+        get() = values[PKT_RECV]
+
+    val pktSndLoss: Int
+        get() = values[PKT_SND_LOSS].toInt()
+
+    val pktRcvLoss: Int
+        get() = values[PKT_RCV_LOSS].toInt()
+
+    val pktRetrans: Int
+        get() = values[PKT_RETRANS].toInt()
+
+    val pktRcvRetrans: Int
+        get() = values[PKT_RCV_RETRANS].toInt()
+
+    val pktSentACK: Int
+        get() = values[PKT_SENT_ACK].toInt()
+
+    val pktRecvACK: Int
+        get() = values[PKT_RECV_ACK].toInt()
+
+    val pktSentNAK: Int
+        get() = values[PKT_SENT_NAK].toInt()
+
+    val pktRecvNAK: Int
+        get() = values[PKT_RECV_NAK].toInt()
+
+    val mbpsSendRate: Double
+        get() = Double.fromBits(values[MBPS_SEND_RATE])
+
+    val mbpsRecvRate: Double
+        get() = Double.fromBits(values[MBPS_RECV_RATE])
+
+    val usSndDuration: Long
+        get() = values[US_SND_DURATION]
+
+    val pktReorderDistance: Int
+        get() = values[PKT_REORDER_DISTANCE].toInt()
+
+    val pktRcvAvgBelatedTime: Double
+        get() = Double.fromBits(values[PKT_RCV_AVG_BELATED_TIME])
+
+    val pktRcvBelated: Long
+        get() = values[PKT_RCV_BELATED]
+
+    val pktSndDrop: Int
+        get() = values[PKT_SND_DROP].toInt()
+
+    val pktRcvDrop: Int
+        get() = values[PKT_RCV_DROP].toInt()
+
+    val pktRcvUndecrypt: Int
+        get() = values[PKT_RCV_UNDECRYPT].toInt()
+
+    val byteSent: Long
+        get() = values[BYTE_SENT]
+
+    val byteRecv: Long
+        get() = values[BYTE_RECV]
+
+    val byteRcvLoss: Long
+        get() = values[BYTE_RCV_LOSS]
+
+    val byteRetrans: Long
+        get() = values[BYTE_RETRANS]
+
+    val byteSndDrop: Long
+        get() = values[BYTE_SND_DROP]
+
+    val byteRcvDrop: Long
+        get() = values[BYTE_RCV_DROP]
+
+    val byteRcvUndecrypt: Long
+        get() = values[BYTE_RCV_UNDECRYPT]
+
+    val usPktSndPeriod: Double
+        get() = Double.fromBits(values[US_PKT_SND_PERIOD])
+
+    val pktFlowWindow: Int
+        get() = values[PKT_FLOW_WINDOW].toInt()
+
+    val pktCongestionWindow: Int
+        get() = values[PKT_CONGESTION_WINDOW].toInt()
+
+    val pktFlightSize: Int
+        get() = values[PKT_FLIGHT_SIZE].toInt()
+
+    val msRTT: Double
+        get() = Double.fromBits(values[MS_RTT])
+
+    val mbpsBandwidth: Double
+        get() = Double.fromBits(values[MBPS_BANDWIDTH])
+
+    val byteAvailSndBuf: Int
+        get() = values[BYTE_AVAIL_SND_BUF].toInt()
+
+    val byteAvailRcvBuf: Int
+        get() = values[BYTE_AVAIL_RCV_BUF].toInt()
+
+    val mbpsMaxBW: Double
+        get() = Double.fromBits(values[MBPS_MAX_BW])
+
+    val byteMSS: Int
+        get() = values[BYTE_MSS].toInt()
+
+    val pktSndBuf: Int
+        get() = values[PKT_SND_BUF].toInt()
+
+    val byteSndBuf: Int
+        get() = values[BYTE_SND_BUF].toInt()
+
+    val msSndBuf: Int
+        get() = values[MS_SND_BUF].toInt()
+
+    val msSndTsbPdDelay: Int
+        get() = values[MS_SND_TSB_PD_DELAY].toInt()
+
+    val pktRcvBuf: Int
+        get() = values[PKT_RCV_BUF].toInt()
+
+    val byteRcvBuf: Int
+        get() = values[BYTE_RCV_BUF].toInt()
+
+    val msRcvBuf: Int
+        get() = values[MS_RCV_BUF].toInt()
+
+    val msRcvTsbPdDelay: Int
+        get() = values[MS_RCV_TSB_PD_DELAY].toInt()
+
+    val pktSndFilterExtraTotal: Int
+        get() = values[PKT_SND_FILTER_EXTRA_TOTAL].toInt()
+
+    val pktRcvFilterExtraTotal: Int
+        get() = values[PKT_RCV_FILTER_EXTRA_TOTAL].toInt()
+
+    val pktRcvFilterSupplyTotal: Int
+        get() = values[PKT_RCV_FILTER_SUPPLY_TOTAL].toInt()
+
+    val pktRcvFilterLossTotal: Int
+        get() = values[PKT_RCV_FILTER_LOSS_TOTAL].toInt()
+
+    val pktSndFilterExtra: Int
+        get() = values[PKT_SND_FILTER_EXTRA].toInt()
+
+    val pktRcvFilterExtra: Int
+        get() = values[PKT_RCV_FILTER_EXTRA].toInt()
+
+    val pktRcvFilterSupply: Int
+        get() = values[PKT_RCV_FILTER_SUPPLY].toInt()
+
+    val pktRcvFilterLoss: Int
+        get() = values[PKT_RCV_FILTER_LOSS].toInt()
+
+    val pktReorderTolerance: Int
+        get() = values[PKT_REORDER_TOLERANCE].toInt()
+
+    val pktSentUniqueTotal: Long
+        get() = values[PKT_SENT_UNIQUE_TOTAL]
+
+    val pktRecvUniqueTotal: Long
+        get() = values[PKT_RECV_UNIQUE_TOTAL]
+
+    val byteSentUniqueTotal: Long
+        get() = values[BYTE_SENT_UNIQUE_TOTAL]
+
+    val byteRecvUniqueTotal: Long
+        get() = values[BYTE_RECV_UNIQUE_TOTAL]
+
+    val pktSentUnique: Long
+        get() = values[PKT_SENT_UNIQUE]
+
+    val pktRecvUnique: Long
+        get() = values[PKT_RECV_UNIQUE]
+
+    val byteSentUnique: Long
+        get() = values[BYTE_SENT_UNIQUE]
+
+    val byteRecvUnique: Long
+        get() = values[BYTE_RECV_UNIQUE]
+
+    /**
+     * Copies the current values into a [Stats].
+     *
+     * @return a new [Stats]
+     */
+    fun toStats() = Stats(
+            msTimeStamp,
+            pktSentTotal,
+            pktRecvTotal,
+            pktSndLossTotal,
+            pktRcvLossTotal,
+            pktRetransTotal,
+            pktSentACKTotal,
+            pktRecvACKTotal,
+            pktSentNAKTotal,
+            pktRecvNAKTotal,
+            usSndDurationTotal,
+            pktSndDropTotal,
+            pktRcvDropTotal,
+            pktRcvUndecryptTotal,
+            byteSentTotal,
+            byteRecvTotal,
+            byteRcvLossTotal,
+            byteRetransTotal,
+            byteSndDropTotal,
+            byteRcvDropTotal,
+            byteRcvUndecryptTotal,
+            pktSent,
+            pktRecv,
+            pktSndLoss,
+            pktRcvLoss,
+            pktRetrans,
+            pktRcvRetrans,
+            pktSentACK,
+            pktRecvACK,
+            pktSentNAK,
+            pktRecvNAK,
+            mbpsSendRate,
+            mbpsRecvRate,
+            usSndDuration,
+            pktReorderDistance,
+            pktRcvAvgBelatedTime,
+            pktRcvBelated,
+            pktSndDrop,
+            pktRcvDrop,
+            pktRcvUndecrypt,
+            byteSent,
+            byteRecv,
+            byteRcvLoss,
+            byteRetrans,
+            byteSndDrop,
+            byteRcvDrop,
+            byteRcvUndecrypt,
+            usPktSndPeriod,
+            pktFlowWindow,
+            pktCongestionWindow,
+            pktFlightSize,
+            msRTT,
+            mbpsBandwidth,
+            byteAvailSndBuf,
+            byteAvailRcvBuf,
+            mbpsMaxBW,
+            byteMSS,
+            pktSndBuf,
+            byteSndBuf,
+            msSndBuf,
+            msSndTsbPdDelay,
+            pktRcvBuf,
+            byteRcvBuf,
+            msRcvBuf,
+            msRcvTsbPdDelay,
+            pktSndFilterExtraTotal,
+            pktRcvFilterExtraTotal,
+            pktRcvFilterSupplyTotal,
+            pktRcvFilterLossTotal,
+            pktSndFilterExtra,
+            pktRcvFilterExtra,
+            pktRcvFilterSupply,
+            pktRcvFilterLoss,
+            pktReorderTolerance,
+            pktSentUniqueTotal,
+            pktRecvUniqueTotal,
+            byteSentUniqueTotal,
+            byteRecvUniqueTotal,
+            pktSentUnique,
+            pktRecvUnique,
+            byteSentUnique,
+            byteRecvUnique
+    )
+
+    companion object {
+        /**
+         * Version of the index layout
+         */
+        const val LAYOUT_VERSION = 1
+
+        /**
+         * Number of fields in the layout
+         */
+        const val LAYOUT_SIZE = 82
+
+        const val MS_TIME_STAMP = 0
+        const val PKT_SENT_TOTAL = 1
+        const val PKT_RECV_TOTAL = 2
+        const val PKT_SND_LOSS_TOTAL = 3
+        const val PKT_RCV_LOSS_TOTAL = 4
+        const val PKT_RETRANS_TOTAL = 5
+        const val PKT_SENT_ACK_TOTAL = 6
+        const val PKT_RECV_ACK_TOTAL = 7
+        const val PKT_SENT_NAK_TOTAL = 8
+        const val PKT_RECV_NAK_TOTAL = 9
+        const val US_SND_DURATION_TOTAL = 10
+        const val PKT_SND_DROP_TOTAL = 11
+        const val PKT_RCV_DROP_TOTAL = 12
+        const val PKT_RCV_UNDECRYPT_TOTAL = 13
+        const val BYTE_SENT_TOTAL = 14
+        const val BYTE_RECV_TOTAL = 15
+        const val BYTE_RCV_LOSS_TOTAL = 16
+        const val BYTE_RETRANS_TOTAL = 17
+        const val BYTE_SND_DROP_TOTAL = 18
+        const val BYTE_RCV_DROP_TOTAL = 19
+        const val BYTE_RCV_UNDECRYPT_TOTAL = 20
+        const val PKT_SENT = 21
+        const val PKT_RECV = 22
+        const val PKT_SND_LOSS = 23
+        const val PKT_RCV_LOSS = 24
+        const val PKT_RETRANS = 25
+        const val PKT_RCV_RETRANS = 26
+        const val PKT_SENT_ACK = 27
+        const val PKT_RECV_ACK = 28
+        const val PKT_SENT_NAK = 29
+        const val PKT_RECV_NAK = 30
+        const val MBPS_SEND_RATE = 31
+        const val MBPS_RECV_RATE = 32
+        const val US_SND_DURATION = 33
+        const val PKT_REORDER_DISTANCE = 34
+        const val PKT_RCV_AVG_BELATED_TIME = 35
+        const val PKT_RCV_BELATED = 36
+        const val PKT_SND_DROP = 37
+        const val PKT_RCV_DROP = 38
+        const val PKT_RCV_UNDECRYPT = 39
+        const val BYTE_SENT = 40
+        const val BYTE_RECV = 41
+        const val BYTE_RCV_LOSS = 42
+        const val BYTE_RETRANS = 43
+        const val BYTE_SND_DROP = 44
+        const val BYTE_RCV_DROP = 45
+        const val BYTE_RCV_UNDECRYPT = 46
+        const val US_PKT_SND_PERIOD = 47
+        const val PKT_FLOW_WINDOW = 48
+        const val PKT_CONGESTION_WINDOW = 49
+        const val PKT_FLIGHT_SIZE = 50
+        const val MS_RTT = 51
+        const val MBPS_BANDWIDTH = 52
+        const val BYTE_AVAIL_SND_BUF = 53
+        const val BYTE_AVAIL_RCV_BUF = 54
+        const val MBPS_MAX_BW = 55
+        const val BYTE_MSS = 56
+        const val PKT_SND_BUF = 57
+        const val BYTE_SND_BUF = 58
+        const val MS_SND_BUF = 59
+        const val MS_SND_TSB_PD_DELAY = 60
+        const val PKT_RCV_BUF = 61
+        const val BYTE_RCV_BUF = 62
+        const val MS_RCV_BUF = 63
+        const val MS_RCV_TSB_PD_DELAY = 64
+        const val PKT_SND_FILTER_EXTRA_TOTAL = 65
+        const val PKT_RCV_FILTER_EXTRA_TOTAL = 66
+        const val PKT_RCV_FILTER_SUPPLY_TOTAL = 67
+        const val PKT_RCV_FILTER_LOSS_TOTAL = 68
+        const val PKT_SND_FILTER_EXTRA = 69
+        const val PKT_RCV_FILTER_EXTRA = 70
+        const val PKT_RCV_FILTER_SUPPLY = 71
+        const val PKT_RCV_FILTER_LOSS = 72
+        const val PKT_REORDER_TOLERANCE = 73
+        const val PKT_SENT_UNIQUE_TOTAL = 74
+        const val PKT_RECV_UNIQUE_TOTAL = 75
+        const val BYTE_SENT_UNIQUE_TOTAL = 76
+        const val BYTE_RECV_UNIQUE_TOTAL = 77
+        const val PKT_SENT_UNIQUE = 78
+        const val PKT_RECV_UNIQUE = 79
+        const val BYTE_SENT_UNIQUE = 80
+        const val BYTE_RECV_UNIQUE = 81
+    }
+}
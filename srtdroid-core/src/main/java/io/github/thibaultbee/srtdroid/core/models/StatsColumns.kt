@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import io.github.thibaultbee.srtdroid.core.Srt
+
+/**
+ * Statistics of many SRT sockets collected in a single native call, in a structure-of-arrays
+ * layout.
+ *
+ * [values] holds one contiguous column of [capacity] elements per [StatsBuffer] field: the value
+ * of field `field` (a [StatsBuffer] index constant such as [StatsBuffer.MS_RTT]) for row `row`
+ * is at `field * capacity + row`. Floating point fields are stored as their IEEE 754 bits, as in
+ * [StatsBuffer]. Rows are in the order of the collected sockets.
+ *
+ * A [StatsColumns] is meant to be reused for every collection.
+ *
+ * @param capacity the maximum number of sockets per collection
+ */
+class StatsColumns(val capacity: Int) {
+    companion object {
+        @JvmStatic
+        private external fun nativeCollect(
+            sockets: IntArray,
+            nSockets: Int,
+            clear: Boolean,
+            instantaneous: Boolean,
+            columns: LongArray,
+            stride: Int,
+            valids: BooleanArray
+        ): Int
+
+        init {
+            Srt.startUp()
+        }
+    }
+
+    init {
+        require(capacity > 0) { "capacity must be positive" }
+    }
+
+    /**
+     * The columns, see [StatsColumns].
+     */
+    val values = LongArray(StatsBuffer.LAYOUT_SIZE * capacity)
+
+    private val socketIds = IntArray(capacity)
+    private val valids = BooleanArray(capacity)
+
+    /**
+     * Number of rows of the last collection.
+     */
+    var size = 0
+        private set
+
+    /**
+     * Collects the statistics of [sockets].
+     *
+     * **See Also:** [srt_bistats](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_bistats)
+     *
+     * @param sockets the sockets to collect statistics from. Row `i` is `sockets[i]`.
+     * @param clear true if the statistics should be cleared after retrieval
+     * @param instantaneous true if the statistics should use instant data, not moving averages
+     * @return the number of sockets which statistics have been retrieved
+     * @throws IllegalArgumentException if there are more sockets than [capacity]
+     */
+    fun collect(
+        sockets: Collection<SrtSocket>,
+        clear: Boolean = false,
+        instantaneous: Boolean = false
+    ): Int {
+        require(sockets.size <= capacity) { "Too many sockets: ${sockets.size} > $capacity" }
+
+        var n = 0
+        sockets.forEach { socketIds[n++] = it.srtsocket }
+        size = n
+        return nativeCollect(socketIds, n, clear, instantaneous, values, capacity, valids)
+    }
+
+    /**
+     * Collects the statistics of every socket added to [epoll].
+     *
+     * @param epoll the [Epoll] which sockets to collect statistics from. Row order is the order of [Epoll.sockets].
+     * @param clear true if the statistics should be cleared after retrieval
+     * @param instantaneous true if the statistics should use instant data, not moving averages
+     * @return the number of sockets which statistics have been retrieved
+     * @throws IllegalArgumentException if there are more sockets than [capacity]
+     */
+    fun collect(
+        epoll: Epoll,
+        clear: Boolean = false,
+        instantaneous: Boolean = false
+    ) = collect(epoll.sockets.toList(), clear, instantaneous)
+
+    /**
+     * Whether the statistics of a row have been retrieved. Columns of an invalid row are left untouched.
+     *
+     * @param row the row index
+     * @return true if the row is valid
+     */
+    fun isValid(row: Int) = (row < size) && valids[row]
+
+    /**
+     * Gets a value as a [Long].
+     *
+     * @param field the [StatsBuffer] index constant
+     * @param row the row index
+     */
+    fun getLong(field: Int, row: Int) = values[field * capacity + row]
+
+    /**
+     * Gets a floating point field.
+     *
+     * @param field the [StatsBuffer] index constant of a [Double] field
+     * @param row the row index
+     */
+    fun getDouble(field: Int, row: Int) = Double.fromBits(values[field * capacity + row])
+
+    /**
+     * Sums an integer field over valid rows.
+     *
+     * @param field the [StatsBuffer] index constant of an [Int] or [Long] field
+     */
+    fun sum(field: Int): Long {
+        val offset = field * capacity
+        var sum = 0L
+        for (row in 0 until size) {
+            if (valids[row]) {
+                sum += values[offset + row]
+            }
+        }
+        return sum
+    }
+
+    /**
+     * Sums a floating point field over valid rows.
+     *
+     * @param field the [StatsBuffer] index constant of a [Double] field
+     */
+    fun sumDouble(field: Int): Double {
+        val offset = field * capacity
+        var sum = 0.0
+        for (row in 0 until size) {
+            if (valids[row]) {
+                sum += Double.fromBits(values[offset + row])
+            }
+        }
+        return sum
+    }
+
+    /**
+     * Gets the maximum of a floating point field over valid rows.
+     *
+     * @param field the [StatsBuffer] index constant of a [Double] field
+     * @return the maximum or [Double.NaN] if there are no valid rows
+     */
+    fun maxDouble(field: Int): Double {
+        val offset = field * capacity
+        var max = Double.NaN
+        for (row in 0 until size) {
+            if (valids[row]) {
+                val value = Double.fromBits(values[offset + row])
+                if (max.isNaN() || (value > max)) {
+                    max = value
+                }
+            }
+        }
+        return max
+    }
+}
@@ -0,0 +1,314 @@
+/*
+ * Copyright (C) 2021 Thibault B.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.github.thibaultbee.srtdroid.core.models
+
+import android.util.Log
+import io.github.thibaultbee.srtdroid.core.Srt
+import java.io.Closeable
+import java.security.InvalidParameterException
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.atomic.AtomicInteger
+
+/**
+ * A native thread that periodically samples the statistics of its subscribed sockets.
+ *
+ * Each socket keeps a history of the last [historySize] samples that can be read as a time window
+ * with [read]. Thresholds on any sample field are checked on every sample and reported to their
+ * [ThresholdListener].
+ *
+ * Statistics are not cleared by the sampler: it can run alongside other [SrtSocket.bistats] calls.
+ * A sample contains the [StatsBuffer] layout followed by the fields computed between two samples:
+ * [SAMPLE_TIME], [INTERVAL_MS], [SEND_RATE_MBPS], [RECV_RATE_MBPS], [SND_LOSS_PERCENT],
+ * [RCV_LOSS_PERCENT] and [RETRANS_PERCENT].
+ * Once it has been called, you must release Srt context with [Srt.cleanUp] when application leaves.
+ *
+ * **See Also:** [srt_bistats](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_bistats)
+ *
+ * @param intervalInMs sampling interval in milliseconds
+ * @param historySize number of samples kept per socket
+ */
+class StatsSampler(
+    val intervalInMs: Int = DEFAULT_INTERVAL_IN_MS,
+    val historySize: Int = DEFAULT_HISTORY_SIZE
+) : Closeable {
+    companion object {
+        private const val TAG = "StatsSampler"
+
+        private const val DEFAULT_INTERVAL_IN_MS = 1000
+        private const val DEFAULT_HISTORY_SIZE = 60
+
+        /**
+         * Time of the sample, in microseconds. See [Time.now].
+         */
+        const val SAMPLE_TIME = StatsBuffer.LAYOUT_SIZE
+
+        /**
+         * Time since the previous sample, in milliseconds
+         */
+        const val INTERVAL_MS = StatsBuffer.LAYOUT_SIZE + 1
+
+        /**
+         * Sending rate since the previous sample, in Mbps ([Double])
+         */
+        const val SEND_RATE_MBPS = StatsBuffer.LAYOUT_SIZE + 2
+
+        /**
+         * Receiving rate since the previous sample, in Mbps ([Double])
+         */
+        const val RECV_RATE_MBPS = StatsBuffer.LAYOUT_SIZE + 3
+
+        /**
+         * Sender side lost packets since the previous sample, in percent of sent packets ([Double])
+         */
+        const val SND_LOSS_PERCENT = StatsBuffer.LAYOUT_SIZE + 4
+
+        /**
+         * Receiver side lost packets since the previous sample, in percent of expected packets ([Double])
+         */
+        const val RCV_LOSS_PERCENT = StatsBuffer.LAYOUT_SIZE + 5
+
+        /**
+         * Retransmitted packets since the previous sample, in percent of sent packets ([Double])
+         */
+        const val RETRANS_PERCENT = StatsBuffer.LAYOUT_SIZE + 6
+
+        /**
+         * Number of fields of a sample
+         */
+        const val SAMPLE_SIZE = StatsBuffer.LAYOUT_SIZE + 7
+
+        @JvmStatic
+        private external fun nativeSubscribe(ptr: Long, srtsocket: Int)
+
+        @JvmStatic
+        private external fun nativeUnsubscribe(ptr: Long, srtsocket: Int)
+
+        @JvmStatic
+        private external fun nativeAddThreshold(
+            ptr: Long,
+            id: Int,
+            field: Int,
+            isAbove: Boolean,
+            value: Double
+        ): Int
+
+        @JvmStatic
+        private external fun nativeRemoveThreshold(ptr: Long, id: Int)
+
+        @JvmStatic
+        private external fun nativeRead(
+            ptr: Long,
+            srtsocket: Int,
+            windowInMs: Long,
+            samples: LongArray,
+            maxSamples: Int
+        ): Int
+
+        @JvmStatic
+        private external fun nativeRelease(ptr: Long)
+
+        init {
+            Srt.startUp()
+        }
+    }
+
+    /**
+     * Listener of threshold crossings.
+     */
+    fun interface ThresholdListener {
+        /**
+         * Called on the sampler thread when a threshold is crossed or when the value goes back.
+         * It must not block as it delays the next samples.
+         *
+         * @param socket the sampled socket
+         * @param isCrossed true if the threshold has just been crossed, false if the value went back
+         * @param value the sampled value
+         */
+        fun onThreshold(socket: SrtSocket, isCrossed: Boolean, value: Double)
+    }
+
+    /**
+     * A reusable buffer of samples filled by [read].
+     *
+     * Sample `i` field `field` is at `i * SAMPLE_SIZE + field` of [values]. Floating point fields
+     * are stored as their IEEE 754 bits.
+     *
+     * @param capacity the maximum number of samples
+     */
+    class History(val capacity: Int) {
+        /**
+         * The samples, oldest first.
+         */
+        val values = LongArray(capacity * SAMPLE_SIZE)
+
+        /**
+         * Number of samples of the last [read].
+         */
+        var size = 0
+            internal set
+
+        /**
+         * Gets a value as a [Long].
+         *
+         * @param sample the sample index
+         * @param field a [StatsBuffer] index constant or a [StatsSampler] field
+         */
+        fun getLong(sample: Int, field: Int) = values[sample * SAMPLE_SIZE + field]
+
+        /**
+         * Gets a floating point field.
+         *
+         * @param sample the sample index
+         * @param field a [StatsBuffer] index constant or a [StatsSampler] field of a [Double] field
+         */
+        fun getDouble(sample: Int, field: Int) = Double.fromBits(values[sample * SAMPLE_SIZE + field])
+    }
+
+    private class Threshold(val listener: ThresholdListener)
+
+    private val sockets = ConcurrentHashMap<Int, SrtSocket>()
+    private val thresholds = ConcurrentHashMap<Int, Threshold>()
+    private val nextThresholdId = AtomicInteger(0)
+
+    private external fun nativeCreate(intervalInMs: Int, historySize: Int): Long
+
+    private val handle =
+        NativeHandle(nativeCreate(intervalInMs, historySize), TAG) { nativeRelease(it) }
+
+    init {
+        if (!handle.isOpen) {
+            throw InvalidParameterException("Failed to create stats sampler")
+        }
+    }
+
+    /**
+     * Tests if the [StatsSampler] is running.
+     *
+     * @return true if [StatsSampler] is running, otherwise false
+     */
+    val isValid: Boolean
+        get() = handle.isOpen
+
+    /**
+     * Starts sampling a socket. Its history is reset.
+     *
+     * @param socket the SRT socket to sample
+     * @throws IllegalStateException if the sampler is closed
+     */
+    fun subscribe(socket: SrtSocket) = handle.use { ptr ->
+        sockets[socket.srtsocket] = socket
+        nativeSubscribe(ptr, socket.srtsocket)
+    }
+
+    /**
+     * Stops sampling a socket and drops its history.
+     *
+     * @param socket the SRT socket to stop sampling
+     * @throws IllegalStateException if the sampler is closed
+     */
+    fun unsubscribe(socket: SrtSocket) = handle.use { ptr ->
+        nativeUnsubscribe(ptr, socket.srtsocket)
+        sockets.remove(socket.srtsocket)
+        Unit
+    }
+
+    /**
+     * Adds a threshold checked on every sample of every subscribed socket.
+     *
+     * For example, `addThreshold(StatsBuffer.MS_RTT, true, 100.0, listener)` reports when RTT goes
+     * above 100 ms and when it goes back under.
+     *
+     * @param field a [StatsBuffer] index constant or a [StatsSampler] field
+     * @param isAbove true if the threshold is crossed when the value is above [value], false when it is below
+     * @param value the threshold
+     * @param listener the listener called on the sampler thread
+     * @return the threshold identifier, for [removeThreshold]
+     * @throws IllegalArgumentException if [field] is not a sample field
+     * @throws IllegalStateException if the sampler is closed
+     */
+    fun addThreshold(
+        field: Int,
+        isAbove: Boolean,
+        value: Double,
+        listener: ThresholdListener
+    ): Int = handle.use { ptr ->
+        val id = nextThresholdId.getAndIncrement()
+        thresholds[id] = Threshold(listener)
+        if (nativeAddThreshold(ptr, id, field, isAbove, value) != 0) {
+            thresholds.remove(id)
+            throw IllegalArgumentException("Invalid field $field")
+        }
+        id
+    }
+
+    /**
+     * Removes a threshold.
+     *
+     * @param id the identifier returned by [addThreshold]
+     * @throws IllegalStateException if the sampler is closed
+     */
+    fun removeThreshold(id: Int) = handle.use { ptr ->
+        nativeRemoveThreshold(ptr, id)
+        thresholds.remove(id)
+        Unit
+    }
+
+    /**
+     * Reads the samples of a socket within the last [windowInMs], oldest first.
+     *
+     * @param socket the sampled socket
+     * @param windowInMs the window duration in milliseconds
+     * @param history the [History] to write to. At most [History.capacity] of the most recent samples are written.
+     * @return [history]
+     * @throws IllegalArgumentException if [socket] is not subscribed
+     * @throws IllegalStateException if the sampler is closed
+     */
+    fun read(
+        socket: SrtSocket,
+        windowInMs: Long,
+        history: History = History(historySize)
+    ): History = handle.use { ptr ->
+        val res = nativeRead(ptr, socket.srtsocket, windowInMs, history.values, history.capacity)
+        require(res >= 0) { "Socket is not subscribed" }
+        history.size = res
+        history
+    }
+
+    /**
+     * Called by the sampler thread.
+     */
+    @Suppress("unused")
+    private fun onThreshold(srtsocket: Int, id: Int, isCrossed: Boolean, value: Double) {
+        val socket = sockets[srtsocket] ?: return
+        val threshold = thresholds[id] ?: return
+        try {
+            threshold.listener.onThreshold(socket, isCrossed, value)
+        } catch (t: Throwable) {
+            Log.e(TAG, "Listener failed", t)
+        }
+    }
+
+    /**
+     * Stops the sampler thread and drops all histories.
+     * Subscribed sockets are not closed.
+     * It is safe to call it concurrently with the other methods and several times.
+     */
+    override fun close() {
+        sockets.clear()
+        thresholds.clear()
+        handle.close()
+    }
+}
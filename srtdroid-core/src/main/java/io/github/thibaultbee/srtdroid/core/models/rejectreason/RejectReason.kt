@@ -15,10 +15,21 @@
  */
 package io.github.thibaultbee.srtdroid.core.models.rejectreason
 
+import io.github.thibaultbee.srtdroid.core.enums.RejectReasonCode
 import io.github.thibaultbee.srtdroid.core.models.SrtSocket
 
 /**
  * Base class of [InternalRejectReason], [PredefinedRejectReason] and [UserDefinedRejectReason].
  * Do not use it. Its purpose is to get an unique [SrtSocket.rejectReason] API.
  */
-sealed class RejectReason
\ No newline at end of file
+sealed class RejectReason {
+    /**
+     * The native reject reason code.
+     */
+    internal val nativeCode: Int
+        get() = when (this) {
+            is InternalRejectReason -> code.ordinal // Forbidden by SRT
+            is PredefinedRejectReason -> code + RejectReasonCode.PREDEFINED_OFFSET
+            is UserDefinedRejectReason -> code + RejectReasonCode.USERDEFINED_OFFSET
+        }
+}
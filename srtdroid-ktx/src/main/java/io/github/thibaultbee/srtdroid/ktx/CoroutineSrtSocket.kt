@@ -4,21 +4,26 @@ import android.util.Log
 import android.util.Pair
 import io.github.thibaultbee.srtdroid.core.enums.EpollOpt
 import io.github.thibaultbee.srtdroid.core.enums.ErrorType
+import io.github.thibaultbee.srtdroid.core.enums.SendBufferMetric
 import io.github.thibaultbee.srtdroid.core.enums.SockOpt
 import io.github.thibaultbee.srtdroid.core.enums.SockStatus
 import io.github.thibaultbee.srtdroid.core.interfaces.ConfigurableSrtSocket
-import io.github.thibaultbee.srtdroid.core.models.Epoll
+import io.github.thibaultbee.srtdroid.core.models.EpollReactor
+import io.github.thibaultbee.srtdroid.core.models.MsgBatch
 import io.github.thibaultbee.srtdroid.core.models.MsgCtrl
+import io.github.thibaultbee.srtdroid.core.models.SockOptSnapshot
+import io.github.thibaultbee.srtdroid.core.models.SockOptions
 import io.github.thibaultbee.srtdroid.core.models.SrtError
 import io.github.thibaultbee.srtdroid.core.models.SrtSocket
 import io.github.thibaultbee.srtdroid.core.models.SrtSocket.ServerListener
 import io.github.thibaultbee.srtdroid.core.models.SrtUrl
 import io.github.thibaultbee.srtdroid.core.models.Stats
+import io.github.thibaultbee.srtdroid.core.models.StatsBuffer
 import io.github.thibaultbee.srtdroid.core.models.rejectreason.InternalRejectReason
 import io.github.thibaultbee.srtdroid.core.models.rejectreason.PredefinedRejectReason
 import io.github.thibaultbee.srtdroid.core.models.rejectreason.RejectReason
 import io.github.thibaultbee.srtdroid.core.models.rejectreason.UserDefinedRejectReason
-import kotlinx.coroutines.CancellationException
+import kotlinx.coroutines.CancellableContinuation
 import kotlinx.coroutines.CompletableJob
 import kotlinx.coroutines.CoroutineDispatcher
 import kotlinx.coroutines.CoroutineScope
@@ -26,8 +31,11 @@ import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.Job
 import kotlinx.coroutines.channels.awaitClose
 import kotlinx.coroutines.channels.trySendBlocking
+import kotlinx.coroutines.flow.MutableStateFlow
+import kotlinx.coroutines.flow.StateFlow
+import kotlinx.coroutines.flow.asStateFlow
 import kotlinx.coroutines.flow.callbackFlow
-import kotlinx.coroutines.isActive
+import kotlinx.coroutines.flow.first
 import kotlinx.coroutines.suspendCancellableCoroutine
 import kotlinx.coroutines.withContext
 import kotlinx.coroutines.withTimeout
@@ -40,6 +48,7 @@ import java.net.InetSocketAddress
 import java.net.SocketException
 import java.net.SocketTimeoutException
 import java.nio.ByteBuffer
+import kotlin.coroutines.resume
 import kotlin.coroutines.resumeWithException
 import kotlin.math.min
 
@@ -187,14 +196,48 @@ private constructor(
             peerAddress: InetSocketAddress,
             token: Int
         ) {
+            unregister()
             socket.close()
             complete(ConnectException(error.toString()))
         }
     }
 
+    /**
+     * Guards [inWaiter], [outWaiter], [registeredReactor] and [registeredEvents].
+     */
+    private val waiterLock = Any()
+
+    private var inWaiter: CancellableContinuation<Int>? = null
+
+    private var outWaiter: CancellableContinuation<Int>? = null
+
+    /**
+     * The reactor the socket has been added to, null if it has not been added yet
+     */
+    private var registeredReactor: EpollReactor? = null
+
+    private var registeredEvents = 0
+
+    private val _isSendBufferHigh = MutableStateFlow(false)
+
+    /**
+     * Whether the send buffer occupancy has reached the high watermark and not gone back to the low
+     * watermark yet. See [setSendBufferWatermarks].
+     */
+    val isSendBufferHigh: StateFlow<Boolean> = _isSendBufferHigh.asStateFlow()
+
     init {
         socket.setSockFlag(SockOpt.RCVSYN, false)
         socket.setSockFlag(SockOpt.SNDSYN, false)
+        socket.sendBufferListener = object : SrtSocket.SendBufferListener {
+            override fun onSendBufferHigh(socket: SrtSocket, level: Long) {
+                _isSendBufferHigh.value = true
+            }
+
+            override fun onSendBufferLow(socket: SrtSocket, level: Long) {
+                _isSendBufferHigh.value = false
+            }
+        }
     }
 
     private fun complete(t: Throwable? = null) {
@@ -205,6 +248,8 @@ private constructor(
                 socketContext.complete()
             }
         }
+        // Wakes up awaitSendBufferLow() callers
+        _isSendBufferHigh.value = false
     }
 
     /**
@@ -215,6 +260,7 @@ private constructor(
      * @throws SocketException if close failed
      */
     fun close() {
+        unregister()
         try {
             socket.close()
             complete()
@@ -353,6 +399,30 @@ private constructor(
         socket.setSockFlag(opt, value)
     }
 
+    /**
+     * Sets a list of socket options, in order, in a single native call.
+     *
+     * @param options the [SockOptions] to set
+     * @throws IllegalArgumentException if [options] contains [SockOpt.RCVSYN] or [SockOpt.SNDSYN]
+     * @see [SrtSocket.applyOptions]
+     */
+    override fun applyOptions(options: SockOptions) {
+        if (options.options.any { (opt, _) -> (opt == SockOpt.RCVSYN) || (opt == SockOpt.SNDSYN) }) {
+            throw IllegalArgumentException("Options not supported")
+        }
+        socket.applyOptions(options)
+    }
+
+    /**
+     * Reads the options of [snapshot] in a single native call.
+     *
+     * @param snapshot the [SockOptSnapshot] to fill
+     * @return the number of options that have been read
+     * @see [SrtSocket.snapshotOptions]
+     */
+    fun snapshotOptions(snapshot: SockOptSnapshot = SockOptSnapshot()) =
+        socket.snapshotOptions(snapshot)
+
     /**
      * Sends a message to a remote party.
      *
@@ -536,6 +606,27 @@ private constructor(
         }
     }
 
+    /**
+     * Receives many messages from a remote device in a single native call.
+     *
+     * It waits till it is possible to read on the socket, then drains the available messages.
+     *
+     * **See Also:** [srt_recvmsg2](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_recvmsg2)
+     *
+     * @param buffer the [ByteBuffer] where received data are written to. It must be allocate with [ByteBuffer.allocateDirect].
+     * @param batch where the received messages are described
+     * @return the number of messages received
+     * @throws SocketException if it has failed to receive message
+     * @throws SocketTimeoutException if a timeout has been triggered
+     */
+    suspend fun recvBatch(buffer: ByteBuffer, batch: MsgBatch): Int {
+        val timeoutInMs = (socket.getSockFlag(SockOpt.RCVTIMEO) as Int).toLong()
+
+        return execute(EpollOpt.IN, timeoutInMs) {
+            socket.recvBatch(buffer, batch)
+        }
+    }
+
     /**
      * Sends a specified file.
      *
@@ -620,6 +711,51 @@ private constructor(
             socket.rejectReason = value
         }
 
+    // Send buffer
+    /**
+     * Sets high and low watermarks on the send buffer occupancy. Crossings are reported by
+     * [isSendBufferHigh].
+     *
+     * @param low the low watermark
+     * @param high the high watermark. Set 0 to disable watermarks.
+     * @param metric the unit of [low] and [high]
+     * @param intervalInMs the occupancy check interval
+     * @see [SrtSocket.setSendBufferWatermarks]
+     */
+    fun setSendBufferWatermarks(
+        low: Long,
+        high: Long,
+        metric: SendBufferMetric = SendBufferMetric.MS,
+        intervalInMs: Int = DEFAULT_SEND_BUFFER_WATERMARK_INTERVAL_IN_MS
+    ) {
+        // The crossing state is reset: reported crossings happen after the reset
+        _isSendBufferHigh.value = false
+        socket.setSendBufferWatermarks(low, high, metric, intervalInMs)
+    }
+
+    /**
+     * Gets the send buffer occupancy without building [Stats].
+     *
+     * @param metric the unit of the returned occupancy
+     * @return the send buffer occupancy
+     * @see [SrtSocket.sendBufferLevel]
+     */
+    fun sendBufferLevel(metric: SendBufferMetric = SendBufferMetric.MS) =
+        socket.sendBufferLevel(metric)
+
+    /**
+     * Suspends until the send buffer occupancy is back to the low watermark.
+     * Returns immediately if the high watermark has not been reached.
+     *
+     * @throws SocketException if the socket is closed or broken, before or while waiting
+     */
+    suspend fun awaitSendBufferLow() {
+        _isSendBufferHigh.first { !it || !socketContext.isActive }
+        if (!socketContext.isActive) {
+            throw SocketException("Socket is closed")
+        }
+    }
+
     // Performance tracking
     /**
      * Reports the current statistics.
@@ -642,6 +778,19 @@ private constructor(
      */
     fun bistats(clear: Boolean, instantaneous: Boolean) = socket.bistats(clear, instantaneous)
 
+    /**
+     * Reports the current statistics without allocating.
+     *
+     * **See Also:** [srt_bistats](https://github.com/Haivision/srt/blob/master/docs/API/API-functions.md#srt_bistats)
+     *
+     * @param clear true if the statistics should be cleared after retrieval
+     * @param instantaneous true if the statistics should use instant data, not moving averages
+     * @param stats the [StatsBuffer] to write to
+     * @return [stats]
+     */
+    fun bistats(clear: Boolean, instantaneous: Boolean, stats: StatsBuffer) =
+        socket.bistats(clear, instantaneous, stats)
+
     // Time access
     /**
      * Gets the time when SRT socket was open to establish a connection.
@@ -793,109 +942,227 @@ private constructor(
         onContinuation: () -> Unit = {},
         block: () -> T
     ): T {
-        val epoll = Epoll()
-        //  flags = listOf(EpollFlag.ENABLE_EMPTY)
-        epoll.addUSock(socket, listOf(EpollOpt.ERR, epollOpt))
-
-        try {
-            return withContext(coroutineDispatcher) {
-                if (timeoutInMs == null) {
-                    executeEpoll(epoll, onContinuation, block)
-                } else {
-                    executeEpollWithTimeout(epoll, timeoutInMs, onContinuation, block)
-                }
+        return if ((timeoutInMs == null) || (timeoutInMs < 0)) {
+            executeEpoll(epollOpt, onContinuation, block)
+        } else {
+            withTimeout(timeoutInMs) {
+                executeEpoll(epollOpt, onContinuation, block)
             }
-        } catch (e: Exception) {
-            throw e
-        } finally {
-            epoll.clearUSock()
-            epoll.release()
         }
     }
 
-    private suspend fun <T> executeEpollWithTimeout(
-        epoll: Epoll,
-        timeoutInMs: Long,
+    private suspend fun <T> executeEpoll(
+        epollOpt: EpollOpt,
         onContinuation: () -> Unit = {},
         block: () -> T
     ): T {
-        return if (timeoutInMs >= 0) {
-            withTimeout(timeoutInMs) {
-                executeEpoll(epoll, onContinuation, block)
+        val events = awaitEvents(epollOpt, onContinuation)
+
+        return withContext(coroutineDispatcher) {
+            if ((events and EpollOpt.ERR.value) != 0) {
+                if ((SrtError.lastError != ErrorType.SUCCESS) && (SrtError.lastError != ErrorType.EPOLLEMPTY)) {
+                    throw SocketException(SrtError.lastErrorMessage)
+                } else {
+                    if ((sockState == SockStatus.BROKEN) || (sockState == SockStatus.CLOSED)) {
+                        throw SocketException("Connection was broken")
+                    } else {
+                        throw SocketException("Epoll returned an unknown error (sockState = $sockState)")
+                    }
+                }
+            } else if ((events and (EpollOpt.IN.value or EpollOpt.OUT.value)) != 0) {
+                block()
+            } else {
+                throw SocketException("Epoll returned an unknown event: ${EpollOpt.fromMask(events)}")
             }
-        } else {
-            executeEpoll(epoll, onContinuation, block)
         }
     }
 
-    private suspend fun <T> executeEpoll(
-        epoll: Epoll,
-        onContinuation: () -> Unit = {},
-        block: () -> T
-    ): T {
+    /**
+     * Suspends until the shared [EpollReactor] reports [epollOpt] or an error on the socket.
+     *
+     * A send and a receive can wait at the same time: each direction has its own waiter and the
+     * socket stays registered to the reactor with the union of the waited events.
+     *
+     * @return the native events mask
+     */
+    private suspend fun awaitEvents(
+        epollOpt: EpollOpt,
+        onContinuation: () -> Unit
+    ): Int {
+        require((epollOpt == EpollOpt.IN) || (epollOpt == EpollOpt.OUT)) {
+            "Only IN and OUT can be awaited"
+        }
         return suspendCancellableCoroutine { continuation ->
-            continuation.invokeOnCancellation { t ->
-                epoll.clearUSock()
+            synchronized(waiterLock) {
+                if (epollOpt == EpollOpt.IN) {
+                    check(inWaiter == null) { "Another coroutine is already waiting to receive" }
+                    inWaiter = continuation
+                } else {
+                    check(outWaiter == null) { "Another coroutine is already waiting to send" }
+                    outWaiter = continuation
+                }
+                try {
+                    updateRegistration()
+                } catch (t: Throwable) {
+                    removeWaiter(continuation)
+                    throw t
+                }
             }
-            onContinuation()
-            while (isActive) {
+            continuation.invokeOnCancellation {
+                synchronized(waiterLock) {
+                    removeWaiter(continuation)
+                }
+            }
+            try {
+                onContinuation()
+            } catch (t: Throwable) {
+                synchronized(waiterLock) {
+                    removeWaiter(continuation)
+                }
+                if (continuation.isActive) {
+                    continuation.resumeWithException(t)
+                }
+            }
+        }
+    }
+
+    /**
+     * Called on the reactor thread. Resumes each waiter whose events are set.
+     */
+    private fun onReactorEvents(events: Int) {
+        val isError = (events and EpollOpt.ERR.value) != 0
+        var resumedIn: CancellableContinuation<Int>? = null
+        var resumedOut: CancellableContinuation<Int>? = null
+        synchronized(waiterLock) {
+            val reactor = registeredReactor
+            if (isError && (reactor != null) && !reactor.isValid) {
+                // The reactor has failed, not the socket: waiters move to a new reactor
+                registeredReactor = null
+                registeredEvents = 0
                 try {
-                    val epollEvents = epoll.uWait(POLLING_TIMEOUT_IN_MS)
-                    if (epollEvents.isEmpty()) {
-                        continue
-                    }
+                    updateRegistration()
+                    return
+                } catch (t: Throwable) {
+                    Log.w(TAG, "Failed to move to a new reactor", t)
+                }
+            }
+            if (isError || ((events and EpollOpt.IN.value) != 0)) {
+                resumedIn = inWaiter
+                inWaiter = null
+            }
+            if (isError || ((events and EpollOpt.OUT.value) != 0)) {
+                resumedOut = outWaiter
+                outWaiter = null
+            }
+            try {
+                updateRegistration()
+            } catch (t: Throwable) {
+                Log.w(TAG, "Failed to update reactor registration", t)
+            }
+        }
+        resumedIn?.let {
+            if (it.isActive) {
+                it.resume(events and (EpollOpt.IN.value or EpollOpt.ERR.value))
+            }
+        }
+        resumedOut?.let {
+            if (it.isActive) {
+                it.resume(events and (EpollOpt.OUT.value or EpollOpt.ERR.value))
+            }
+        }
+    }
 
-                    val socketEvents = epollEvents.filter { it.socket == socket }
-                    if (socketEvents.isEmpty()) {
-                        continue
-                    }
+    /**
+     * Removes a waiter that has not been resumed by the reactor. Must hold [waiterLock].
+     */
+    private fun removeWaiter(continuation: CancellableContinuation<Int>) {
+        if (inWaiter === continuation) {
+            inWaiter = null
+        } else if (outWaiter === continuation) {
+            outWaiter = null
+        } else {
+            return
+        }
+        try {
+            updateRegistration()
+        } catch (_: Throwable) {
+            // Ignore
+        }
+    }
 
-                    try {
-                        epoll.addUSock(socket, null) // Unsubscribe to all events
-                    } catch (_: Throwable) {
-                        // Ignore
-                    }
+    /**
+     * Registers the waited events to the shared reactor. The socket is added once, then only its
+     * events are updated. Must hold [waiterLock].
+     */
+    private fun updateRegistration() {
+        val opts = mutableListOf<EpollOpt>()
+        inWaiter?.let { opts.add(EpollOpt.IN) }
+        outWaiter?.let { opts.add(EpollOpt.OUT) }
+        if (opts.isNotEmpty()) {
+            opts.add(EpollOpt.ERR)
+        }
+        val events = EpollOpt.toMask(opts)
 
-                    try {
-                        if (socketEvents.any { it.events.contains(EpollOpt.ERR) }) {
-                            if ((SrtError.lastError != ErrorType.SUCCESS) && (SrtError.lastError != ErrorType.EPOLLEMPTY)) {
-                                throw SocketException(SrtError.lastErrorMessage)
-                            } else {
-                                if ((sockState == SockStatus.BROKEN) || (sockState == SockStatus.CLOSED)) {
-                                    throw SocketException("Connection was broken")
-                                } else {
-                                    throw SocketException("Epoll returned an unknown error (sockState = $sockState)")
-                                }
-                            }
-                        } else if (socketEvents.any {
-                                it.events.contains(EpollOpt.IN) || it.events.contains(
-                                    EpollOpt.OUT
-                                )
-                            }) {
-                            continuation.resumeWith(Result.success(block()))
-                        } else {
-                            throw SocketException("Epoll returned an unknown event: $socketEvents")
-                        }
-                    } catch (t: Throwable) {
-                        continuation.resumeWithException(t)
-                    }
-                } catch (t: Throwable) {
-                    if ((sockState == SockStatus.BROKEN) || (sockState == SockStatus.CLOSED)) {
-                        throw SocketException("Connection was broken")
-                    } else {
-                        continuation.resumeWithException(t)
-                    }
-                }
-                return@suspendCancellableCoroutine
+        var reactor = sharedReactor()
+        if (reactor !== registeredReactor) {
+            // First registration, or the previous reactor has failed
+            if (events == 0) {
+                return
+            }
+            try {
+                reactor.add(socket, opts) { _, ev -> onReactorEvents(ev) }
+            } catch (e: IllegalStateException) {
+                // The reactor has failed meanwhile: its replacement is used
+                reactor = sharedReactor()
+                reactor.add(socket, opts) { _, ev -> onReactorEvents(ev) }
+            }
+            registeredReactor = reactor
+        } else if (events != registeredEvents) {
+            reactor.update(socket, opts)
+        }
+        registeredEvents = events
+    }
+
+    /**
+     * Removes the socket from the shared reactor.
+     */
+    private fun unregister() {
+        synchronized(waiterLock) {
+            val reactor = registeredReactor ?: return
+            registeredReactor = null
+            registeredEvents = 0
+            try {
+                reactor.remove(socket)
+            } catch (_: Throwable) {
+                // Ignore: the socket is already closed or the reactor has failed
             }
-            continuation.resumeWithException(CancellationException())
         }
     }
 
     companion object {
         private const val TAG = "CoroutineSrtSocket"
 
-        private const val POLLING_TIMEOUT_IN_MS = 1000L
+        private const val DEFAULT_SEND_BUFFER_WATERMARK_INTERVAL_IN_MS = 10
+
+        /**
+         * Reactor shared by all [CoroutineSrtSocket] to wait for socket events.
+         */
+        private var reactor: EpollReactor? = null
+
+        /**
+         * @return the shared reactor. A new one replaces it if it has failed: the failed one is
+         * closed and its sockets move to the new one when they get its error, see
+         * [onReactorEvents].
+         */
+        @Synchronized
+        private fun sharedReactor(): EpollReactor {
+            val current = reactor
+            if ((current != null) && current.isValid) {
+                return current
+            }
+            current?.close()
+            return EpollReactor().also { reactor = it }
+        }
     }
 
     /**